@@ -6,7 +6,6 @@
 #include <string.h>
 #include <stdbool.h>
 #include <time.h>
-#include <gtk/gtk.h>
 #include <sqlite3.h>
 
 // Common constants
@@ -60,16 +59,8 @@ typedef struct {
 // Global user session
 extern UserSession g_session;
 
-// Global database connection
-extern sqlite3 *g_db;
-
-// Function to show error dialog
-void show_error_dialog(GtkWindow *parent, const char *message);
-
-// Function to show info dialog
-void show_info_dialog(GtkWindow *parent, const char *message);
-
-// Function to show confirmation dialog
-bool show_confirm_dialog(GtkWindow *parent, const char *message);
+// Database connection of the calling thread: the main connection opened by
+// db_init, or a worker's own from db_init_thread
+extern _Thread_local sqlite3 *g_db;
 
 #endif // COMMON_H
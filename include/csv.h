@@ -0,0 +1,38 @@
+#ifndef CSV_H
+#define CSV_H
+
+#include "common.h"
+
+// Streaming reader for CSV and TSV files. Fields may be quoted with "...",
+// doubling a quote inside; quoted fields may hold delimiters and newlines.
+// The delimiter comes from the first line: a tab if it has one, otherwise a
+// comma. Records are decoded one at a time into buffers the reader reuses,
+// so memory stays flat however long the file is.
+#define CSV_MAX_RECORD (1 << 20)   // longest record accepted, in bytes
+
+typedef struct {
+    FILE *file;
+    char delimiter;
+    char *buffer;          // fields of the current record, NUL-terminated
+    size_t buffer_size;
+    size_t *offsets;       // [field_count] starts of the fields in buffer
+    char **fields;         // [field_count] pointers into buffer
+    int field_count;
+    int field_capacity;
+    int line;              // line the current record starts on, 1-based
+    int next_line;
+} CsvReader;
+
+bool csv_open(CsvReader *reader, const char *path);
+// Read the next record, skipping blank lines. Returns its number of fields,
+// 0 at the end of the file, or -1 when a record is longer than CSV_MAX_RECORD.
+int csv_next(CsvReader *reader);
+// Field i of the current record with surrounding spaces removed, or "" past
+// the last field
+const char* csv_field(CsvReader *reader, int i);
+// Column of the current record (the header) whose name matches one of names
+// (NULL-terminated, compared ignoring case and surrounding spaces), or -1
+int csv_find_column(CsvReader *reader, const char *const *names);
+void csv_close(CsvReader *reader);
+
+#endif // CSV_H
@@ -6,10 +6,17 @@
 
 // Database initialization and cleanup
 bool db_init(const char *db_path);
+// Open a read-only connection for the calling (worker) thread; close it with
+// db_cleanup on the same thread
+bool db_init_thread(const char *db_path);
 void db_cleanup(void);
+// Changes whenever a write is committed to the database, so derived results
+// can be tagged with the version they were computed from
+unsigned long db_data_version(void);
 
 // Database schema creation
 bool db_create_tables(void);
+bool db_migrate_schema(void);  // Bring PRAGMA user_version up to date
 
 // User operations
 bool db_create_user(const char *email, const char *password_hash, const char *name);
@@ -66,8 +73,8 @@ Assignment* db_get_assignment_by_id(int id);
 void db_free_assignments(Assignment **assignments, int count);
 
 // Assignment submission operations
+// Keyed by (assignment_id, student_id); the table has no surrogate id
 typedef struct {
-    int id;
     int assignment_id;
     int student_id;
     SubmissionStatus status;
@@ -81,20 +88,92 @@ AssignmentSubmission** db_get_submissions_by_assignment(int assignment_id, int *
 AssignmentSubmission* db_get_submission(int assignment_id, int student_id);
 void db_free_submissions(AssignmentSubmission **submissions, int count);
 
+// Grading sheet for one assignment: every student in the class with their
+// submission (status and quality are 0 when nothing has been recorded)
+typedef struct {
+    int student_id;
+    char name[MAX_NAME_LENGTH];
+    char roll_number[50];
+    SubmissionStatus status;
+    QualityAssessment quality;
+    char notes[MAX_DESCRIPTION_LENGTH];
+} SubmissionSheetRow;
+
+SubmissionSheetRow** db_get_submission_sheet(int class_id, int assignment_id, int *count);
+void db_free_submission_sheet(SubmissionSheetRow **rows, int count);
+
 // Attendance operations
+// Keyed by (student_id, date); the table has no surrogate id
 typedef struct {
-    int id;
     int student_id;
     time_t date;
     AttendanceStatus status;
     char notes[MAX_DESCRIPTION_LENGTH];
 } Attendance;
 
+// Attendance storage mode, per class. Sparse days store a session row plus
+// rows for absent/late students (and present students with notes); readers
+// treat every other student of the class as present. A day keeps the mode it
+// was first recorded in, so switching only affects new days.
+typedef enum {
+    ATTENDANCE_STORE_FULL = 0,
+    ATTENDANCE_STORE_SPARSE = 1
+} AttendanceStorageMode;
+
+AttendanceStorageMode db_get_attendance_mode(int class_id);
+bool db_set_attendance_mode(int class_id, AttendanceStorageMode mode);
+
 bool db_mark_attendance(int student_id, time_t date, AttendanceStatus status, const char *notes);
 Attendance** db_get_attendance_by_date(time_t date, int *count);
 Attendance** db_get_attendance_by_student(int student_id, int *count);
 void db_free_attendance(Attendance **attendance, int count);
 
+// Attendance sheet for one class on one date (status is -1 when not marked)
+typedef struct {
+    int student_id;
+    char name[MAX_NAME_LENGTH];
+    char roll_number[50];
+    int status;
+    char notes[MAX_DESCRIPTION_LENGTH];
+} AttendanceSheetRow;
+
+char** db_get_attendance_dates(int class_id, int *count);
+// Recorded dates of a class between from and to, newest first. Either bound
+// may be a prefix ("2024", "2024-03") and is inclusive of every date it
+// covers; NULL or "" leaves that side open. Runs as a range scan of the
+// class's attendance_sessions rows.
+char** db_search_attendance_dates(int class_id, const char *from, const char *to, int *count);
+void db_free_attendance_dates(char **dates, int count);
+AttendanceSheetRow** db_get_attendance_sheet(int class_id, const char *date, int *count);
+void db_free_attendance_sheet(AttendanceSheetRow **rows, int count);
+
+// Report operations
+typedef struct {
+    int student_id;
+    char name[MAX_NAME_LENGTH];
+    char roll_number[50];
+    int total_days;
+    int present;
+    int absent;
+    int late;
+    int longest_absent_streak;   // consecutive recorded days absent
+} AttendanceSummary;
+
+typedef struct {
+    int assignment_id;
+    char title[MAX_TITLE_LENGTH];
+    char subject[MAX_SUBJECT_LENGTH];
+    int completed;
+} AssignmentSummary;
+
+int db_count_students_by_class(int class_id);
+AttendanceSummary** db_get_attendance_summary(int class_id, int *count);
+void db_free_attendance_summary(AttendanceSummary **rows, int count);
+AssignmentSummary** db_get_assignment_summary(int class_id, int *count);
+void db_free_assignment_summary(AssignmentSummary **rows, int count);
+bool db_get_student_attendance_stats(int student_id, int *total, int *present, int *absent, int *late);
+bool db_get_student_assignment_stats(int student_id, int class_id, int *total, int *completed);
+
 // Database migration
 bool db_migrate_to_class_system(int teacher_id);
 
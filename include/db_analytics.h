@@ -0,0 +1,84 @@
+#ifndef DB_ANALYTICS_H
+#define DB_ANALYTICS_H
+
+#include <stdint.h>
+#include "database.h"
+
+// Columnar in-memory copy of a teacher's attendance and submission facts.
+// Every column is a plain array indexed by fact number, so group-bys and
+// filters are single passes over narrow arrays. Days are day numbers
+// (days since 1970-01-01); students, classes, assignments and subjects are
+// dense indexes into the dimension arrays.
+typedef struct {
+    // Dimensions
+    int class_count;
+    int *class_ids;
+    char (*class_names)[MAX_NAME_LENGTH];
+    int student_count;
+    int *student_ids;
+    uint16_t *student_class;
+    int subject_count;
+    char (*subjects)[MAX_SUBJECT_LENGTH];
+    int assignment_count;
+    int *assignment_ids;
+    uint16_t *assignment_class;
+    uint16_t *assignment_subject;
+    int32_t *assignment_due;
+
+    // Attendance facts: one per student and recorded day, including the
+    // implied presents of sparse days
+    int attendance_count;
+    uint32_t *att_student;
+    int32_t *att_day;
+    uint8_t *att_status;
+    int32_t first_day;
+    int32_t last_day;
+
+    // Submission facts: one per assignment and student
+    int submission_count;
+    uint32_t *sub_student;
+    uint32_t *sub_assignment;
+    uint8_t *sub_status;
+    uint8_t *sub_quality;
+} AnalyticsStore;
+
+bool analytics_load(AnalyticsStore *store, int teacher_id);
+void analytics_free(AnalyticsStore *store);
+
+// "YYYY-MM-DD" to a day number; false on a bad date
+bool analytics_day_number(const char *date, int32_t *day);
+
+// Kernels. mask[i] is 0 or 1; counts has key_count * width entries.
+int analytics_filter_range(const int32_t *values, int n, int32_t lo, int32_t hi, uint8_t *mask);
+void analytics_count_by_key(const uint32_t *keys, const uint8_t *values, const uint8_t *mask,
+                            int n, int width, int *counts);
+
+// Attendance per class and calendar month over [from, to] (either NULL for
+// an open end), in class-name then month order; months without facts are
+// left out
+typedef struct {
+    int class_id;
+    int year;
+    int month;   // 1-12
+    int present;
+    int absent;
+    int late;
+} AnalyticsMonthRow;
+
+AnalyticsMonthRow* analytics_monthly_attendance(const AnalyticsStore *store, const char *from,
+                                                const char *to, int *count);
+
+// Submissions per class and subject for assignments due in [from, to]
+typedef struct {
+    int class_id;
+    char subject[MAX_SUBJECT_LENGTH];
+    int assigned;                  // assignments due x students in the class
+    int submitted;                 // on time or late
+    int late;
+    int quality[QUALITY_HIGH + 1]; // submitted work, by QualityAssessment
+} AnalyticsSubjectRow;
+
+AnalyticsSubjectRow* analytics_subject_quality(const AnalyticsStore *store, const char *from,
+                                               const char *to, int *count);
+
+#endif // DB_ANALYTICS_H
@@ -0,0 +1,36 @@
+#ifndef DB_BATCH_H
+#define DB_BATCH_H
+
+#include "database.h"
+
+// Transaction helpers
+bool db_begin(void);
+bool db_commit(void);
+void db_rollback(void);
+
+// One student's attendance on the batch date
+typedef struct {
+    int student_id;
+    AttendanceStatus status;
+    const char *notes;
+} AttendanceEntry;
+
+// One student's submission for the batch assignment
+typedef struct {
+    int student_id;
+    SubmissionStatus status;
+    QualityAssessment quality;
+    const char *notes;
+} SubmissionEntry;
+
+// Save many rows in one transaction with a single prepared statement.
+// Returns the number of rows written, or -1 if the batch was rolled back.
+int db_mark_attendance_batch(time_t date, const AttendanceEntry *entries, int count);
+int db_save_submissions_batch(int assignment_id, const SubmissionEntry *entries, int count);
+
+// Save a class's attendance for one day in the class's storage mode: on a
+// sparse day, plain "present" entries remove any stored row instead of
+// writing one. Returns the number of students recorded, or -1.
+int db_save_attendance_day(int class_id, time_t date, const AttendanceEntry *entries, int count);
+
+#endif // DB_BATCH_H
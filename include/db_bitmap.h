@@ -0,0 +1,62 @@
+#ifndef DB_BITMAP_H
+#define DB_BITMAP_H
+
+#include <stdint.h>
+#include "database.h"
+
+// Bitmap attendance index: one row per student and term (calendar year) in
+// attendance_bitmaps, holding a bit plane per status with one bit per day of
+// the year. Planes mirror the explicit attendance rows only; the implied
+// "present" of sparse days is added at query time from attendance_sessions,
+// so it always follows the student's current class.
+#define BITMAP_DAYS 366
+#define BITMAP_WORDS ((BITMAP_DAYS + 63) / 64)
+#define BITMAP_PLANES 3   // indexed by AttendanceStatus
+
+typedef struct {
+    uint64_t plane[BITMAP_PLANES][BITMAP_WORDS];
+} AttendanceBits;
+
+// Day index (0-365) and term of a date, matching date(t, 'unixepoch') for
+// time_t and "YYYY-MM-DD" text respectively. Return -1 on a bad date.
+int bitmap_day_from_time(time_t t, int *term);
+int bitmap_day_from_date(const char *date, int *term);
+
+// Kernels over BITMAP_WORDS-word planes. With -mpopcnt / -mbmi2 (make
+// NATIVE=1) these compile to POPCNT and PEXT.
+int bitmap_popcount(const uint64_t *bits);
+void bitmap_range_mask(uint64_t *mask, int first_day, int last_day);
+// Pack the bits of src at the positions set in mask; returns the bit count
+int bitmap_compress(const uint64_t *src, const uint64_t *mask, uint64_t *out);
+// Extend *current / *longest with the runs of 1s in the first nbits bits
+void bitmap_runs(const uint64_t *bits, int nbits, int *current, int *longest);
+
+// Index maintenance, called by the attendance writers. status < 0 clears the
+// day. Writers hold prepared statements for the duration of a batch.
+typedef struct {
+    sqlite3_stmt *select;
+    sqlite3_stmt *upsert;
+    sqlite3_stmt *remove;
+} BitmapWriter;
+
+bool db_bitmap_writer_open(BitmapWriter *writer);
+bool db_bitmap_writer_set(BitmapWriter *writer, int student_id, int term, int day, int status);
+void db_bitmap_writer_close(BitmapWriter *writer);
+
+// Rebuild the whole index from the attendance table
+bool db_bitmap_rebuild(void);
+
+// Bulk operations (db_bulk.h): bring the bits of the class's students on the
+// days listed in temp.bulk_dates in line with their attendance rows
+bool db_bitmap_update_class_days(int class_id);
+
+// Class report over [from, to] ("YYYY-MM-DD", either may be NULL for an open
+// end), ordered by roll number. Includes the longest run of consecutive
+// absences over the class's recorded days.
+AttendanceSummary** db_get_attendance_summary_range(int class_id, const char *from, const char *to, int *count);
+
+// One student over [from, to]; longest_absent may be NULL
+bool db_bitmap_student_stats(int student_id, const char *from, const char *to,
+                             int *total, int *present, int *absent, int *late, int *longest_absent);
+
+#endif // DB_BITMAP_H
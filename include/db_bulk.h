@@ -0,0 +1,53 @@
+#ifndef DB_BULK_H
+#define DB_BULK_H
+
+#include "database.h"
+
+// Bulk attendance operations on one class. Each runs as a few set-based
+// statements inside one savepoint, touches only the class's students,
+// session rows and holidays, and keeps the bitmap index and rollups in step.
+// Before changing anything it journals the class's rows on the days it
+// touches, so db_bulk_undo can put them back. The journal lives in TEMP
+// tables of the connection: undo covers this session's operations only.
+//
+// Dates are "YYYY-MM-DD" and ranges are inclusive, up to BULK_MAX_DAYS long.
+// Each returns the number of days it changed (0 when there was nothing to
+// do), or -1 if it was rolled back.
+#define BULK_MAX_DAYS 366
+
+// Remove the class's attendance on one date; 0 (and nothing to undo) when
+// the class has none recorded on it
+int db_bulk_delete_date(int class_id, const char *date);
+
+// Record status for every student of the class on each day in [from, to]
+// that is not recorded yet and not a holiday, skipping weekends if
+// weekdays_only. Follows the class's storage mode: a sparse class records
+// "present" days as sessions alone.
+int db_bulk_fill_range(int class_id, const char *from, const char *to,
+                       AttendanceStatus status, bool weekdays_only);
+
+// Replace the class's attendance on to_date with a copy of from_date
+int db_bulk_copy_date(int class_id, const char *from_date, const char *to_date);
+
+// Make every day in [from, to] a holiday of the class (name may be NULL),
+// removing any attendance recorded on them
+int db_bulk_mark_holiday(int class_id, const char *from, const char *to, const char *name);
+
+// Undo the class's most recent bulk operation that is still journaled: its
+// days get back the rows they had before it, replacing any later edits to
+// them. label (may be NULL) receives its description.
+bool db_bulk_undo(int class_id, char *label, size_t size);
+// Describe the operation db_bulk_undo would revert; false when there is none
+bool db_bulk_can_undo(int class_id, char *label, size_t size);
+
+// Count the class's recorded days in [from, to] into the rollups and the
+// bitmap index again, after their rows were written without keeping those in
+// step (see db_import_attendance_csv). Not journaled, and not limited to
+// BULK_MAX_DAYS.
+int db_bulk_refresh_range(int class_id, const char *from, const char *to);
+
+// Holidays of the class in [from, to] (NULL for an open end), oldest first.
+// Free with db_free_attendance_dates.
+char** db_get_class_holidays(int class_id, const char *from, const char *to, int *count);
+
+#endif // DB_BULK_H
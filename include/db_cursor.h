@@ -0,0 +1,30 @@
+#ifndef DB_CURSOR_H
+#define DB_CURSOR_H
+
+#include "database.h"
+
+// Forward-only cursor over a query result. Rows are decoded into
+// caller-owned structs, so large result sets never need a pointer array.
+typedef struct {
+    sqlite3_stmt *stmt;
+    bool done;
+} DbCursor;
+
+// Open a cursor (returns false on prepare failure)
+bool db_cursor_students_by_class(DbCursor *cursor, int class_id);
+bool db_cursor_attendance_by_student(DbCursor *cursor, int student_id);
+bool db_cursor_attendance_by_class(DbCursor *cursor, int class_id);
+bool db_cursor_submissions_by_assignment(DbCursor *cursor, int assignment_id);
+
+// Fetch the next row (returns false at end of results)
+bool db_cursor_next_student(DbCursor *cursor, Student *out);
+bool db_cursor_next_attendance(DbCursor *cursor, Attendance *out);
+bool db_cursor_next_submission(DbCursor *cursor, AssignmentSubmission *out);
+
+// Fetch up to max rows into a contiguous page; returns the number fetched
+int db_cursor_fetch_students(DbCursor *cursor, Student *page, int max);
+int db_cursor_fetch_attendance(DbCursor *cursor, Attendance *page, int max);
+
+void db_cursor_close(DbCursor *cursor);
+
+#endif // DB_CURSOR_H
@@ -0,0 +1,42 @@
+#ifndef DB_EXPORT_H
+#define DB_EXPORT_H
+
+#include "database.h"
+
+// Report and history exports. Rows go from a prepared statement straight to
+// a buffered file writer one at a time, so an export of any size needs no
+// more memory than one row and the write buffer. CSV files have a header
+// row and quote the fields that need it; JSON files hold an array with one
+// object per row, keyed by the same headers.
+#define EXPORT_BUFFER_SIZE (256 * 1024)
+
+typedef enum {
+    EXPORT_CSV = 0,
+    EXPORT_JSON = 1
+} ExportFormat;
+
+// JSON for a path ending in ".json", CSV otherwise
+ExportFormat db_export_format_for_path(const char *path);
+
+// Each writes path and returns the number of rows written, or -1 when the
+// export failed (a partly written file is removed).
+
+// The Attendance Summary report: one row per student of the class, counted
+// over [from, to] (NULL or "" for an open end), for students whose longest
+// run of absences is at least min_streak days
+long db_export_attendance_report(const char *path, ExportFormat format, int class_id,
+                                 const char *from, const char *to, int min_streak);
+// The Assignment Statistics report of a class
+long db_export_assignment_report(const char *path, ExportFormat format, int class_id);
+// The Student Report: the student's attendance month by month, from the
+// rollups, and a last row for all months together
+long db_export_student_report(const char *path, ExportFormat format, int student_id);
+
+// Every attendance mark of the class's students, by date and roll number,
+// as the attendance sheet shows it (sparse days include their implied
+// "present" rows)
+long db_export_attendance_history(const char *path, ExportFormat format, int class_id);
+// Every submission row of the class's assignments, by due date
+long db_export_submission_history(const char *path, ExportFormat format, int class_id);
+
+#endif // DB_EXPORT_H
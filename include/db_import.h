@@ -0,0 +1,48 @@
+#ifndef DB_IMPORT_H
+#define DB_IMPORT_H
+
+#include "database.h"
+
+// Spreadsheet imports. Files are CSV or TSV (see csv.h) with a header row,
+// read one record at a time. Rows that cannot be imported are skipped and
+// listed in the report with their line and reason; the rest are written in
+// transactions of IMPORT_BATCH_ROWS rows.
+#define IMPORT_BATCH_ROWS 2000
+
+typedef struct {
+    int line;              // line of the file, 1-based
+    char message[160];
+} ImportError;
+
+typedef struct {
+    int rows;              // data rows read
+    int imported;
+    int rejected;
+    ImportError *errors;   // [error_count], in line order
+    int error_count;
+    char failure[160];     // set when the file could not be imported at all
+} ImportReport;
+
+// Add the students of a roster file to a class. Columns are found by their
+// header: "name", "email", "roll" (or "roll number", "roll_number") and,
+// optionally, "phone". Rows follow the same rules as the student form, and
+// a row whose email or roll number is already registered, or repeats an
+// earlier row of the file, is rejected. Returns false only when nothing
+// could be imported (report->failure says why).
+bool db_import_students_csv(const char *path, int class_id, ImportReport *report);
+
+// Add past attendance of a class's students from a spreadsheet, in either
+// layout, with students found by their "roll" column:
+//   long: "date" and "status" columns (and optionally "notes"), a mark per row
+//   wide: a row per student and a column per day, headed YYYY-MM-DD
+// Statuses are P/present/1, A/absent/0 or L/late/2; empty wide cells are
+// skipped, and a mark replaces any the student already has that day. Days
+// not yet recorded are stored in the class's attendance mode, so on a sparse
+// day a plain present is implied rather than stored, as in the app.
+// report->imported counts marks rather than rows. The rollups and the bitmap
+// index catch up once, after the last row (db_bulk_refresh_range).
+bool db_import_attendance_csv(const char *path, int class_id, ImportReport *report);
+
+void db_free_import_report(ImportReport *report);
+
+#endif // DB_IMPORT_H
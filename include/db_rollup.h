@@ -0,0 +1,83 @@
+#ifndef DB_ROLLUP_H
+#define DB_ROLLUP_H
+
+#include "database.h"
+
+// Attendance rollups: present/absent/late counts per class and day, week
+// (keyed by its Monday) and month ("YYYY-MM"), and per student and month.
+// The attendance writers keep them current as days are marked and deleted,
+// so trend reports read a few rows per period instead of the raw rows.
+// Counts follow the register as it was taken: a student's days stay with
+// the class they were in when marked, and a sparse day's implied presents
+// are counted for the students in the class when the day was opened.
+typedef enum {
+    ROLLUP_CLASS_DAY = 0,
+    ROLLUP_CLASS_WEEK = 1,
+    ROLLUP_CLASS_MONTH = 2,
+    ROLLUP_STUDENT_MONTH = 3
+} RollupTable;
+
+#define ROLLUP_TABLES 4
+
+typedef struct {
+    char period[11];   // "YYYY-MM-DD" (day, week start) or "YYYY-MM"
+    int present;
+    int absent;
+    int late;
+} AttendanceRollup;
+
+// Index maintenance, called by the attendance writers inside their
+// transaction. Class deltas are summed in the writer and written by
+// db_rollup_writer_flush; student deltas are written as they come.
+typedef struct {
+    int class_id;
+    char date[11];
+    int counts[3];     // indexed by AttendanceStatus
+} RollupDelta;
+
+typedef struct {
+    sqlite3_stmt *lookup;
+    sqlite3_stmt *bump[ROLLUP_TABLES];
+    RollupDelta *pending;
+    int pending_count;
+    int pending_capacity;
+} RollupWriter;
+
+bool db_rollup_writer_open(RollupWriter *writer);
+// Class and current status of a student's day (-1 when there is none),
+// including the implied present of a sparse day. Call before writing it.
+bool db_rollup_writer_lookup(RollupWriter *writer, int student_id, const char *date,
+                             int *class_id, int *status);
+// Move one student's day from old_status to new_status (-1 = none)
+bool db_rollup_writer_move(RollupWriter *writer, int class_id, int student_id, const char *date,
+                           int old_status, int new_status);
+bool db_rollup_writer_flush(RollupWriter *writer);
+void db_rollup_writer_close(RollupWriter *writer);
+
+// "YYYY-MM-DD" of a time_t, matching date(t, 'unixepoch')
+void db_rollup_date(time_t date, char *out, size_t size);
+
+// Count the implied presents of a sparse day the class has just opened
+bool db_rollup_open_sparse_day(int class_id, const char *date);
+
+// Bulk operations (db_bulk.h) on the days of one class listed in
+// temp.bulk_dates: take those days out of every rollup before changing them,
+// and add them back afterwards
+bool db_rollup_remove_class_days(int class_id);
+bool db_rollup_add_class_days(int class_id);
+// After rows were written on those days without keeping the rollups in step
+// (an import), count the days, and the months of the class's students, again
+bool db_rollup_refresh_class_days(int class_id);
+
+// Rebuild every rollup from the attendance rows and the current classes
+bool db_rollup_rebuild(void);
+
+// Readers, oldest period first. table is one of the class tables.
+AttendanceRollup** db_get_class_rollup(int class_id, RollupTable table, int *count);
+// Only the periods from from to to, inclusive (e.g. a year of class days)
+AttendanceRollup** db_get_class_rollup_range(int class_id, RollupTable table,
+                                             const char *from, const char *to, int *count);
+AttendanceRollup** db_get_student_rollup(int student_id, int *count);
+void db_free_rollups(AttendanceRollup **rows, int count);
+
+#endif // DB_ROLLUP_H
@@ -0,0 +1,52 @@
+#ifndef DB_SNAPSHOT_H
+#define DB_SNAPSHOT_H
+
+#include "database.h"
+
+// Class snapshots: one class with its students, assignments, submissions,
+// attendance days, marks and holidays in a single binary file, for moving
+// the class to another installation.
+//
+// Layout, integers little-endian:
+//   header   "AKSNAP\r\n", u32 version, u32 flags, u64 payload size and a
+//            u64 FNV-1a checksum of the payload
+//   payload  sections of u32 tag, u64 length and length bytes; with
+//            SNAPSHOT_ZSTD in flags the payload is stored as one zstd frame
+// The strings section is a dictionary of every distinct text value: a varint
+// count, then a varint length and the bytes of each. A table section is u32
+// rows and u32 columns, then each column as a u64 length and one varint per
+// row: for integer columns the zigzag delta from the row before, for text
+// columns the dictionary index plus one (0 for NULL). Rows refer to students
+// and assignments by their position in those sections.
+//
+// Readers skip sections they do not know and columns past the ones they
+// read, so later versions can add either; a newer version is refused.
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_ZSTD (1u << 0)
+
+typedef struct {
+    int class_id;          // the new class
+    int students;
+    int assignments;
+    int submissions;
+    int marks;             // attendance rows
+    char failure[160];     // set when the import failed
+} SnapshotReport;
+
+// Whether this build reads and writes compressed snapshots (make ZSTD=1)
+bool db_snapshot_has_zstd(void);
+
+// Write a snapshot of the class to path, compressed if compress is set and
+// the build has zstd. Returns the size of the file, or -1 (a partly written
+// file is removed).
+long db_snapshot_export(const char *path, int class_id, bool compress);
+
+// Add the class in the snapshot at path as a new class of teacher_id, with
+// new ids throughout, in one transaction that also fills the rollups and the
+// bitmap index. Student emails and roll numbers are unique across the
+// database, so a snapshot whose students are already registered (the class
+// was never deleted here) is refused, like a damaged file, with nothing
+// written.
+bool db_snapshot_import(const char *path, int teacher_id, SnapshotReport *report);
+
+#endif // DB_SNAPSHOT_H
@@ -1,7 +1,7 @@
 #ifndef UI_ASSIGNMENTS_H
 #define UI_ASSIGNMENTS_H
 
-#include "common.h"
+#include "ui_common.h"
 
 // Show assignment tracking window
 void show_assignments_window(GtkWindow *parent);
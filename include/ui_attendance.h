@@ -1,7 +1,7 @@
 #ifndef UI_ATTENDANCE_H
 #define UI_ATTENDANCE_H
 
-#include "common.h"
+#include "ui_common.h"
 
 // Show attendance management window
 void show_attendance_window(GtkWindow *parent);
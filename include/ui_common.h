@@ -0,0 +1,30 @@
+#ifndef UI_COMMON_H
+#define UI_COMMON_H
+
+#include <gtk/gtk.h>
+#include "common.h"
+
+// Function to show error dialog
+void show_error_dialog(GtkWindow *parent, const char *message);
+
+// Function to show info dialog
+void show_info_dialog(GtkWindow *parent, const char *message);
+
+// Function to show confirmation dialog
+bool show_confirm_dialog(GtkWindow *parent, const char *message);
+
+// Info dialog with a scrollable block of details (one item per line)
+void show_details_dialog(GtkWindow *parent, const char *message, const char *details);
+
+// File chooser for a CSV/TSV file to open; returns a path to g_free, or NULL
+char* choose_csv_file(GtkWindow *parent, const char *title);
+
+// File chooser for a class snapshot (.akclass) to open; returns a path to
+// g_free, or NULL
+char* choose_snapshot_file(GtkWindow *parent, const char *title);
+
+// File chooser for a file to save, starting from suggested_name and asking
+// before overwriting; returns a path to g_free, or NULL
+char* choose_save_file(GtkWindow *parent, const char *title, const char *suggested_name);
+
+#endif // UI_COMMON_H
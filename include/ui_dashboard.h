@@ -1,7 +1,7 @@
 #ifndef UI_DASHBOARD_H
 #define UI_DASHBOARD_H
 
-#include "common.h"
+#include "ui_common.h"
 
 // Create and show dashboard window
 void show_dashboard_window(void);
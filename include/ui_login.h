@@ -1,7 +1,7 @@
 #ifndef UI_LOGIN_H
 #define UI_LOGIN_H
 
-#include "common.h"
+#include "ui_common.h"
 
 // Create and show login window
 void show_login_window(void);
@@ -1,7 +1,7 @@
 #ifndef UI_REPORTS_H
 #define UI_REPORTS_H
 
-#include "common.h"
+#include "ui_common.h"
 
 // Show reports window
 void show_reports_window(GtkWindow *parent);
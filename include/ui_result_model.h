@@ -0,0 +1,35 @@
+#ifndef UI_RESULT_MODEL_H
+#define UI_RESULT_MODEL_H
+
+#include <gtk/gtk.h>
+
+// List GtkTreeModel over a result set already in memory: a db_get_* pointer
+// array, or report rows held as GValues. Cells are read only when a view asks
+// for them and strings are handed out without copying, so showing a result
+// costs nothing per row up front. Rows can be sorted by any column through
+// GtkTreeSortable.
+
+// Fill one cell; value is already initialised to the column's type. Strings
+// can be set with g_value_set_static_string, as the rows live as long as the
+// model.
+typedef void (*ResultModelGetFunc)(gpointer rows, int row, int column, GValue *value);
+typedef void (*ResultModelFreeFunc)(gpointer rows, int count);
+
+#define RESULT_TYPE_MODEL (result_model_get_type())
+G_DECLARE_FINAL_TYPE(ResultModel, result_model, RESULT, MODEL, GObject)
+
+// The model owns rows and frees them with free_rows (which may be NULL)
+ResultModel* result_model_new(int n_columns, const GType *types, gpointer rows, int count,
+                              ResultModelGetFunc get, ResultModelFreeFunc free_rows);
+
+// Rows held in a GArray of GValues, n_columns per row; the model keeps a
+// reference to the array. values may be NULL for an empty model.
+ResultModel* result_model_new_values(int n_columns, const GType *types, GArray *values);
+
+// The rows have grown in place to count (e.g. more GValues were appended)
+void result_model_rows_added(ResultModel *model, int count);
+
+// Show model in a view, keeping the sort column of the view's previous model
+void result_model_attach(GtkTreeView *view, ResultModel *model);
+
+#endif // UI_RESULT_MODEL_H
@@ -1,7 +1,7 @@
 #ifndef UI_STUDENTS_H
 #define UI_STUDENTS_H
 
-#include "common.h"
+#include "ui_common.h"
 
 // Show student management window
 void show_students_window(GtkWindow *parent);
@@ -0,0 +1,178 @@
+#include "csv.h"
+#include <ctype.h>
+#include <strings.h>
+
+bool csv_open(CsvReader *reader, const char *path) {
+    if (!reader) return false;
+    memset(reader, 0, sizeof(*reader));
+    if (!path) return false;
+
+    reader->file = fopen(path, "rb");
+    if (!reader->file) {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return false;
+    }
+
+    // Skip a UTF-8 byte order mark, then look for a tab on the first line
+    unsigned char bom[3];
+    long start = 0;
+    if (fread(bom, 1, 3, reader->file) == 3 && bom[0] == 0xEF && bom[1] == 0xBB && bom[2] == 0xBF) {
+        start = 3;
+    }
+    fseek(reader->file, start, SEEK_SET);
+
+    reader->delimiter = ',';
+    int c;
+    while ((c = getc(reader->file)) != EOF && c != '\n') {
+        if (c == '\t') {
+            reader->delimiter = '\t';
+            break;
+        }
+    }
+    fseek(reader->file, start, SEEK_SET);
+
+    reader->buffer_size = 4096;
+    reader->field_capacity = 16;
+    reader->buffer = malloc(reader->buffer_size);
+    reader->offsets = malloc(reader->field_capacity * sizeof(size_t));
+    reader->fields = malloc(reader->field_capacity * sizeof(char*));
+    reader->next_line = 1;
+    if (!reader->buffer || !reader->offsets || !reader->fields) {
+        csv_close(reader);
+        return false;
+    }
+    return true;
+}
+
+static bool append_char(CsvReader *reader, size_t *len, char c) {
+    if (*len + 1 >= reader->buffer_size) {
+        if (reader->buffer_size >= CSV_MAX_RECORD) return false;
+        char *grown = realloc(reader->buffer, reader->buffer_size * 2);
+        if (!grown) return false;
+        reader->buffer = grown;
+        reader->buffer_size *= 2;
+    }
+    reader->buffer[(*len)++] = c;
+    return true;
+}
+
+static bool end_field(CsvReader *reader, size_t *len, size_t *field_start) {
+    if (reader->field_count >= reader->field_capacity) {
+        int capacity = reader->field_capacity * 2;
+        size_t *offsets = realloc(reader->offsets, capacity * sizeof(size_t));
+        if (!offsets) return false;
+        reader->offsets = offsets;
+        char **fields = realloc(reader->fields, capacity * sizeof(char*));
+        if (!fields) return false;
+        reader->fields = fields;
+        reader->field_capacity = capacity;
+    }
+    if (!append_char(reader, len, '\0')) return false;
+    reader->offsets[reader->field_count++] = *field_start;
+    *field_start = *len;
+    return true;
+}
+
+// One record, possibly blank; false at the end of the file or on overflow
+static bool read_record(CsvReader *reader, bool *overflow) {
+    size_t len = 0;
+    size_t field_start = 0;
+    bool quoted = false;
+    bool any = false;
+    int c;
+
+    reader->field_count = 0;
+    reader->line = reader->next_line;
+    *overflow = false;
+
+    while ((c = getc(reader->file)) != EOF) {
+        any = true;
+        bool ok = true;
+        if (quoted) {
+            if (c == '"') {
+                int next = getc(reader->file);
+                if (next == '"') {
+                    ok = append_char(reader, &len, '"');
+                } else {
+                    quoted = false;
+                    if (next != EOF) ungetc(next, reader->file);
+                }
+            } else {
+                if (c == '\n') reader->next_line++;
+                ok = append_char(reader, &len, (char)c);
+            }
+        } else if (c == '"' && len == field_start) {
+            quoted = true;
+        } else if (c == reader->delimiter) {
+            ok = end_field(reader, &len, &field_start);
+        } else if (c == '\n') {
+            reader->next_line++;
+            break;
+        } else if (c != '\r') {
+            ok = append_char(reader, &len, (char)c);
+        }
+        if (!ok) {
+            *overflow = true;
+            return false;
+        }
+    }
+    if (!any) return false;
+
+    if (!end_field(reader, &len, &field_start)) {
+        *overflow = true;
+        return false;
+    }
+    for (int i = 0; i < reader->field_count; i++) {
+        reader->fields[i] = reader->buffer + reader->offsets[i];
+    }
+    return true;
+}
+
+int csv_next(CsvReader *reader) {
+    if (!reader || !reader->file) return 0;
+
+    bool overflow;
+    while (read_record(reader, &overflow)) {
+        for (int i = 0; i < reader->field_count; i++) {
+            if (csv_field(reader, i)[0]) return reader->field_count;
+        }
+    }
+    if (overflow) {
+        fprintf(stderr, "CSV record on line %d is longer than %d bytes\n", reader->line, CSV_MAX_RECORD);
+        return -1;
+    }
+    return 0;
+}
+
+const char* csv_field(CsvReader *reader, int i) {
+    if (!reader || i < 0 || i >= reader->field_count) return "";
+
+    // Trim in place: the field is only read until the next record
+    char *field = reader->fields[i];
+    while (isspace((unsigned char)*field)) field++;
+    size_t len = strlen(field);
+    while (len > 0 && isspace((unsigned char)field[len - 1])) {
+        field[--len] = '\0';
+    }
+    reader->fields[i] = field;
+    return field;
+}
+
+int csv_find_column(CsvReader *reader, const char *const *names) {
+    for (int i = 0; i < reader->field_count; i++) {
+        const char *header = csv_field(reader, i);
+        for (int n = 0; names[n]; n++) {
+            if (strcasecmp(header, names[n]) == 0) return i;
+        }
+    }
+    return -1;
+}
+
+void csv_close(CsvReader *reader) {
+    if (!reader) return;
+    if (reader->file) fclose(reader->file);
+    free(reader->buffer);
+    free(reader->offsets);
+    free(reader->fields);
+    memset(reader, 0, sizeof(*reader));
+}
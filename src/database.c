@@ -1,6 +1,17 @@
 #include "database.h"
+#include "db_bitmap.h"
+#include "db_rollup.h"
 #include "security.h"
 
+// Bumped by every commit on the main connection (see db_data_version)
+static unsigned long g_data_version = 0;
+
+static int count_commit(void *unused) {
+    (void)unused;
+    g_data_version++;
+    return 0;
+}
+
 bool db_init(const char *db_path) {
     int rc = sqlite3_open(db_path, &g_db);
     if (rc != SQLITE_OK) {
@@ -17,9 +28,41 @@ bool db_init(const char *db_path) {
         return false;
     }
     
+    // Write-ahead logging, so worker threads reading through their own
+    // connections (db_init_thread) never block the writers
+    sqlite3_exec(g_db, "PRAGMA journal_mode = WAL;", NULL, NULL, NULL);
+    sqlite3_busy_timeout(g_db, 5000);
+    sqlite3_commit_hook(g_db, count_commit, NULL);
+    
     return db_create_tables();
 }
 
+bool db_init_thread(const char *db_path) {
+    if (sqlite3_open_v2(db_path, &g_db, SQLITE_OPEN_READONLY, NULL) != SQLITE_OK) {
+        fprintf(stderr, "Cannot open database: %s\n", sqlite3_errmsg(g_db));
+        sqlite3_close(g_db);
+        g_db = NULL;
+        return false;
+    }
+    
+    sqlite3_busy_timeout(g_db, 5000);
+    return true;
+}
+
+unsigned long db_data_version(void) {
+    // PRAGMA data_version moves only for commits made by other connections
+    // (another copy of the app on the same file); ours are counted above
+    unsigned long external = 0;
+    sqlite3_stmt *stmt;
+    if (sqlite3_prepare_v2(g_db, "PRAGMA data_version;", -1, &stmt, NULL) == SQLITE_OK) {
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            external = (unsigned long)sqlite3_column_int64(stmt, 0);
+        }
+        sqlite3_finalize(stmt);
+    }
+    return g_data_version + external;
+}
+
 void db_cleanup(void) {
     if (g_db) {
         sqlite3_close(g_db);
@@ -27,8 +70,167 @@ void db_cleanup(void) {
     }
 }
 
+// Schema migrations, tracked in PRAGMA user_version. Each entry upgrades the
+// schema by one version and runs in its own transaction; append new steps,
+// never edit old ones.
+static const char *SCHEMA_MIGRATIONS[] = {
+    // 1: composite indexes matched to the hot queries. The leading column of
+    // each replaces a single-column index, so those are dropped.
+    "DROP INDEX IF EXISTS idx_students_class_id;"
+    "DROP INDEX IF EXISTS idx_attendance_student_id;"
+    "DROP INDEX IF EXISTS idx_assignments_class_id;"
+    "CREATE INDEX IF NOT EXISTS idx_students_class_name ON students(class_id, name);"
+    "CREATE INDEX IF NOT EXISTS idx_students_class_roll ON students(class_id, roll_number);"
+    "CREATE INDEX IF NOT EXISTS idx_attendance_student_date_status ON attendance(student_id, date, status);"
+    "CREATE INDEX IF NOT EXISTS idx_assignments_class_due ON assignments(class_id, due_date);",
+
+    // 2: attendance and submissions become WITHOUT ROWID tables clustered on
+    // their natural keys, dropping the surrogate id and the separate unique
+    // index every lookup used to go through.
+    "CREATE TABLE attendance_clustered ("
+    "student_id INTEGER NOT NULL,"
+    "date DATE NOT NULL,"
+    "status INTEGER NOT NULL DEFAULT 0,"
+    "notes TEXT,"
+    "PRIMARY KEY (student_id, date),"
+    "FOREIGN KEY (student_id) REFERENCES students(id) ON DELETE CASCADE"
+    ") WITHOUT ROWID;"
+    "INSERT INTO attendance_clustered (student_id, date, status, notes) "
+    "SELECT student_id, date, status, notes FROM attendance;"
+    "DROP TABLE attendance;"
+    "ALTER TABLE attendance_clustered RENAME TO attendance;"
+    "CREATE INDEX IF NOT EXISTS idx_attendance_date ON attendance(date);"
+    "CREATE TABLE assignment_submissions_clustered ("
+    "assignment_id INTEGER NOT NULL,"
+    "student_id INTEGER NOT NULL,"
+    "status INTEGER NOT NULL DEFAULT 0,"
+    "quality INTEGER NOT NULL DEFAULT 0,"
+    "submitted_at DATETIME,"
+    "notes TEXT,"
+    "PRIMARY KEY (assignment_id, student_id),"
+    "FOREIGN KEY (assignment_id) REFERENCES assignments(id) ON DELETE CASCADE,"
+    "FOREIGN KEY (student_id) REFERENCES students(id) ON DELETE CASCADE"
+    ") WITHOUT ROWID;"
+    "INSERT INTO assignment_submissions_clustered (assignment_id, student_id, status, quality, submitted_at, notes) "
+    "SELECT assignment_id, student_id, status, quality, submitted_at, notes FROM assignment_submissions;"
+    "DROP TABLE assignment_submissions;"
+    "ALTER TABLE assignment_submissions_clustered RENAME TO assignment_submissions;"
+    "CREATE INDEX IF NOT EXISTS idx_submissions_student_id ON assignment_submissions(student_id);"
+    "DELETE FROM sqlite_sequence WHERE name IN ('attendance', 'assignment_submissions');",
+
+    // 3: per-class attendance storage mode plus one session row per class
+    // and recorded day, backfilled from the existing attendance rows
+    "ALTER TABLE classes ADD COLUMN attendance_mode INTEGER NOT NULL DEFAULT 0;"
+    "CREATE TABLE IF NOT EXISTS attendance_sessions ("
+    "class_id INTEGER NOT NULL,"
+    "date DATE NOT NULL,"
+    "sparse INTEGER NOT NULL DEFAULT 0,"
+    "PRIMARY KEY (class_id, date),"
+    "FOREIGN KEY (class_id) REFERENCES classes(id) ON DELETE CASCADE"
+    ") WITHOUT ROWID;"
+    "CREATE INDEX IF NOT EXISTS idx_attendance_sessions_date ON attendance_sessions(date);"
+    "INSERT OR IGNORE INTO attendance_sessions (class_id, date, sparse) "
+    "SELECT DISTINCT s.class_id, a.date, 0 FROM attendance a "
+    "INNER JOIN students s ON s.id = a.student_id "
+    "WHERE s.class_id IS NOT NULL;",
+
+    // 4: bitmap attendance index, filled by db_bitmap_rebuild (see
+    // db_migration_finish)
+    "CREATE TABLE IF NOT EXISTS attendance_bitmaps ("
+    "student_id INTEGER NOT NULL,"
+    "term INTEGER NOT NULL,"
+    "bits BLOB NOT NULL,"
+    "PRIMARY KEY (student_id, term),"
+    "FOREIGN KEY (student_id) REFERENCES students(id) ON DELETE CASCADE"
+    ") WITHOUT ROWID;",
+
+    // 5: attendance rollups per class and day/week/month and per student and
+    // month, filled by db_rollup_rebuild (see db_migration_finish)
+    "CREATE TABLE IF NOT EXISTS attendance_rollup_class_day ("
+    "class_id INTEGER NOT NULL,"
+    "period TEXT NOT NULL,"
+    "present INTEGER NOT NULL DEFAULT 0,"
+    "absent INTEGER NOT NULL DEFAULT 0,"
+    "late INTEGER NOT NULL DEFAULT 0,"
+    "PRIMARY KEY (class_id, period),"
+    "FOREIGN KEY (class_id) REFERENCES classes(id) ON DELETE CASCADE"
+    ") WITHOUT ROWID;"
+    "CREATE TABLE IF NOT EXISTS attendance_rollup_class_week ("
+    "class_id INTEGER NOT NULL,"
+    "period TEXT NOT NULL,"
+    "present INTEGER NOT NULL DEFAULT 0,"
+    "absent INTEGER NOT NULL DEFAULT 0,"
+    "late INTEGER NOT NULL DEFAULT 0,"
+    "PRIMARY KEY (class_id, period),"
+    "FOREIGN KEY (class_id) REFERENCES classes(id) ON DELETE CASCADE"
+    ") WITHOUT ROWID;"
+    "CREATE TABLE IF NOT EXISTS attendance_rollup_class_month ("
+    "class_id INTEGER NOT NULL,"
+    "period TEXT NOT NULL,"
+    "present INTEGER NOT NULL DEFAULT 0,"
+    "absent INTEGER NOT NULL DEFAULT 0,"
+    "late INTEGER NOT NULL DEFAULT 0,"
+    "PRIMARY KEY (class_id, period),"
+    "FOREIGN KEY (class_id) REFERENCES classes(id) ON DELETE CASCADE"
+    ") WITHOUT ROWID;"
+    "CREATE TABLE IF NOT EXISTS attendance_rollup_student_month ("
+    "student_id INTEGER NOT NULL,"
+    "period TEXT NOT NULL,"
+    "present INTEGER NOT NULL DEFAULT 0,"
+    "absent INTEGER NOT NULL DEFAULT 0,"
+    "late INTEGER NOT NULL DEFAULT 0,"
+    "PRIMARY KEY (student_id, period),"
+    "FOREIGN KEY (student_id) REFERENCES students(id) ON DELETE CASCADE"
+    ") WITHOUT ROWID;",
+
+    // 6: per-class holidays, days bulk fills skip
+    "CREATE TABLE IF NOT EXISTS class_holidays ("
+    "class_id INTEGER NOT NULL,"
+    "date DATE NOT NULL,"
+    "name TEXT,"
+    "PRIMARY KEY (class_id, date),"
+    "FOREIGN KEY (class_id) REFERENCES classes(id) ON DELETE CASCADE"
+    ") WITHOUT ROWID;",
+};
+
+#define SCHEMA_VERSION (int)(sizeof(SCHEMA_MIGRATIONS) / sizeof(SCHEMA_MIGRATIONS[0]))
+
+static int db_schema_version(void) {
+    sqlite3_stmt *stmt;
+    int version = 0;
+    
+    if (sqlite3_prepare_v2(g_db, "PRAGMA user_version;", -1, &stmt, NULL) == SQLITE_OK) {
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            version = sqlite3_column_int(stmt, 0);
+        }
+        sqlite3_finalize(stmt);
+    }
+    return version;
+}
+
+static void db_set_schema_version(int version) {
+    char pragma[64];
+    snprintf(pragma, sizeof(pragma), "PRAGMA user_version = %d;", version);
+    sqlite3_exec(g_db, pragma, NULL, NULL, NULL);
+}
+
+// True before db_create_tables has run on a new file
+static bool db_is_empty(void) {
+    sqlite3_stmt *stmt;
+    int tables = 0;
+    
+    if (sqlite3_prepare_v2(g_db, "SELECT COUNT(*) FROM sqlite_master;", -1, &stmt, NULL) == SQLITE_OK) {
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            tables = sqlite3_column_int(stmt, 0);
+        }
+        sqlite3_finalize(stmt);
+    }
+    return tables == 0;
+}
+
 bool db_create_tables(void) {
     char *err_msg = NULL;
+    bool fresh = db_is_empty();
     
     const char *sql_users = 
         "CREATE TABLE IF NOT EXISTS users ("
@@ -46,6 +248,7 @@ bool db_create_tables(void) {
         "description TEXT,"
         "teacher_id INTEGER NOT NULL,"
         "created_at DATETIME DEFAULT CURRENT_TIMESTAMP,"
+        "attendance_mode INTEGER NOT NULL DEFAULT 0,"
         "FOREIGN KEY (teacher_id) REFERENCES users(id)"
         ");";
     
@@ -77,32 +280,107 @@ bool db_create_tables(void) {
     
     const char *sql_submissions = 
         "CREATE TABLE IF NOT EXISTS assignment_submissions ("
-        "id INTEGER PRIMARY KEY AUTOINCREMENT,"
         "assignment_id INTEGER NOT NULL,"
         "student_id INTEGER NOT NULL,"
         "status INTEGER NOT NULL DEFAULT 0,"
         "quality INTEGER NOT NULL DEFAULT 0,"
         "submitted_at DATETIME,"
         "notes TEXT,"
+        "PRIMARY KEY (assignment_id, student_id),"
         "FOREIGN KEY (assignment_id) REFERENCES assignments(id) ON DELETE CASCADE,"
-        "FOREIGN KEY (student_id) REFERENCES students(id) ON DELETE CASCADE,"
-        "UNIQUE(assignment_id, student_id)"
-        ");";
+        "FOREIGN KEY (student_id) REFERENCES students(id) ON DELETE CASCADE"
+        ") WITHOUT ROWID;";
     
     const char *sql_attendance = 
         "CREATE TABLE IF NOT EXISTS attendance ("
-        "id INTEGER PRIMARY KEY AUTOINCREMENT,"
         "student_id INTEGER NOT NULL,"
         "date DATE NOT NULL,"
         "status INTEGER NOT NULL DEFAULT 0,"
         "notes TEXT,"
-        "FOREIGN KEY (student_id) REFERENCES students(id) ON DELETE CASCADE,"
-        "UNIQUE(student_id, date)"
-        ");";
+        "PRIMARY KEY (student_id, date),"
+        "FOREIGN KEY (student_id) REFERENCES students(id) ON DELETE CASCADE"
+        ") WITHOUT ROWID;";
+    
+    // One row per class and recorded day. In sparse days (sparse = 1) only
+    // absent/late students have attendance rows; everyone else was present.
+    const char *sql_sessions = 
+        "CREATE TABLE IF NOT EXISTS attendance_sessions ("
+        "class_id INTEGER NOT NULL,"
+        "date DATE NOT NULL,"
+        "sparse INTEGER NOT NULL DEFAULT 0,"
+        "PRIMARY KEY (class_id, date),"
+        "FOREIGN KEY (class_id) REFERENCES classes(id) ON DELETE CASCADE"
+        ") WITHOUT ROWID;";
     
-    const char *tables[] = {sql_users, sql_classes, sql_students, sql_assignments, sql_submissions, sql_attendance};
+    // Bit planes per student and calendar year over the attendance rows
+    const char *sql_bitmaps = 
+        "CREATE TABLE IF NOT EXISTS attendance_bitmaps ("
+        "student_id INTEGER NOT NULL,"
+        "term INTEGER NOT NULL,"
+        "bits BLOB NOT NULL,"
+        "PRIMARY KEY (student_id, term),"
+        "FOREIGN KEY (student_id) REFERENCES students(id) ON DELETE CASCADE"
+        ") WITHOUT ROWID;";
+    
+    // Present/absent/late counts per class and period, and per student and
+    // month (see db_rollup.h)
+    const char *sql_rollup_class_day = 
+        "CREATE TABLE IF NOT EXISTS attendance_rollup_class_day ("
+        "class_id INTEGER NOT NULL,"
+        "period TEXT NOT NULL,"
+        "present INTEGER NOT NULL DEFAULT 0,"
+        "absent INTEGER NOT NULL DEFAULT 0,"
+        "late INTEGER NOT NULL DEFAULT 0,"
+        "PRIMARY KEY (class_id, period),"
+        "FOREIGN KEY (class_id) REFERENCES classes(id) ON DELETE CASCADE"
+        ") WITHOUT ROWID;";
+    const char *sql_rollup_class_week = 
+        "CREATE TABLE IF NOT EXISTS attendance_rollup_class_week ("
+        "class_id INTEGER NOT NULL,"
+        "period TEXT NOT NULL,"
+        "present INTEGER NOT NULL DEFAULT 0,"
+        "absent INTEGER NOT NULL DEFAULT 0,"
+        "late INTEGER NOT NULL DEFAULT 0,"
+        "PRIMARY KEY (class_id, period),"
+        "FOREIGN KEY (class_id) REFERENCES classes(id) ON DELETE CASCADE"
+        ") WITHOUT ROWID;";
+    const char *sql_rollup_class_month = 
+        "CREATE TABLE IF NOT EXISTS attendance_rollup_class_month ("
+        "class_id INTEGER NOT NULL,"
+        "period TEXT NOT NULL,"
+        "present INTEGER NOT NULL DEFAULT 0,"
+        "absent INTEGER NOT NULL DEFAULT 0,"
+        "late INTEGER NOT NULL DEFAULT 0,"
+        "PRIMARY KEY (class_id, period),"
+        "FOREIGN KEY (class_id) REFERENCES classes(id) ON DELETE CASCADE"
+        ") WITHOUT ROWID;";
+    const char *sql_rollup_student_month = 
+        "CREATE TABLE IF NOT EXISTS attendance_rollup_student_month ("
+        "student_id INTEGER NOT NULL,"
+        "period TEXT NOT NULL,"
+        "present INTEGER NOT NULL DEFAULT 0,"
+        "absent INTEGER NOT NULL DEFAULT 0,"
+        "late INTEGER NOT NULL DEFAULT 0,"
+        "PRIMARY KEY (student_id, period),"
+        "FOREIGN KEY (student_id) REFERENCES students(id) ON DELETE CASCADE"
+        ") WITHOUT ROWID;";
+    
+    // Days a class does not meet; bulk fills skip them
+    const char *sql_holidays = 
+        "CREATE TABLE IF NOT EXISTS class_holidays ("
+        "class_id INTEGER NOT NULL,"
+        "date DATE NOT NULL,"
+        "name TEXT,"
+        "PRIMARY KEY (class_id, date),"
+        "FOREIGN KEY (class_id) REFERENCES classes(id) ON DELETE CASCADE"
+        ") WITHOUT ROWID;";
+    
+    const char *tables[] = {sql_users, sql_classes, sql_students, sql_assignments, sql_submissions,
+                            sql_attendance, sql_sessions, sql_bitmaps, sql_rollup_class_day,
+                            sql_rollup_class_week, sql_rollup_class_month, sql_rollup_student_month,
+                            sql_holidays};
     
-    for (int i = 0; i < 6; i++) {
+    for (int i = 0; i < (int)(sizeof(tables) / sizeof(tables[0])); i++) {
         int rc = sqlite3_exec(g_db, tables[i], NULL, NULL, &err_msg);
         if (rc != SQLITE_OK) {
             fprintf(stderr, "SQL error: %s\n", err_msg);
@@ -111,20 +389,21 @@ bool db_create_tables(void) {
         }
     }
     
-    // Create indexes for performance
+    // Create indexes for performance (the current set; older databases
+    // reach the same set through SCHEMA_MIGRATIONS)
     const char *indexes[] = {
-        "CREATE INDEX IF NOT EXISTS idx_students_class_id ON students(class_id);",
         "CREATE INDEX IF NOT EXISTS idx_students_email ON students(email);",
         "CREATE INDEX IF NOT EXISTS idx_students_roll ON students(roll_number);",
-        "CREATE INDEX IF NOT EXISTS idx_assignments_class_id ON assignments(class_id);",
-        "CREATE INDEX IF NOT EXISTS idx_attendance_student_id ON attendance(student_id);",
+        "CREATE INDEX IF NOT EXISTS idx_students_class_name ON students(class_id, name);",
+        "CREATE INDEX IF NOT EXISTS idx_students_class_roll ON students(class_id, roll_number);",
+        "CREATE INDEX IF NOT EXISTS idx_assignments_class_due ON assignments(class_id, due_date);",
         "CREATE INDEX IF NOT EXISTS idx_attendance_date ON attendance(date);",
-        "CREATE INDEX IF NOT EXISTS idx_submissions_assignment_id ON assignment_submissions(assignment_id);",
+        "CREATE INDEX IF NOT EXISTS idx_attendance_sessions_date ON attendance_sessions(date);",
         "CREATE INDEX IF NOT EXISTS idx_submissions_student_id ON assignment_submissions(student_id);",
         "CREATE INDEX IF NOT EXISTS idx_classes_teacher_id ON classes(teacher_id);"
     };
     
-    for (int i = 0; i < 9; i++) {
+    for (int i = 0; i < (int)(sizeof(indexes) / sizeof(indexes[0])); i++) {
         int rc = sqlite3_exec(g_db, indexes[i], NULL, NULL, &err_msg);
         if (rc != SQLITE_OK) {
             fprintf(stderr, "Index creation error: %s\n", err_msg);
@@ -133,6 +412,42 @@ bool db_create_tables(void) {
         }
     }
     
+    // A new database already has the latest schema
+    if (fresh) {
+        db_set_schema_version(SCHEMA_VERSION);
+    }
+    
+    return db_migrate_schema();
+}
+
+// Work a migration step needs beyond its SQL, run in the same transaction
+static bool db_migration_finish(int version) {
+    if (version == 4) return db_bitmap_rebuild();
+    if (version == 5) return db_rollup_rebuild();
+    return true;
+}
+
+bool db_migrate_schema(void) {
+    if (!g_db) return false;
+    
+    for (int version = db_schema_version(); version < SCHEMA_VERSION; version++) {
+        char *err_msg = NULL;
+        char pragma[64];
+        snprintf(pragma, sizeof(pragma), "PRAGMA user_version = %d;", version + 1);
+        
+        if (sqlite3_exec(g_db, "BEGIN TRANSACTION;", NULL, NULL, &err_msg) != SQLITE_OK ||
+            sqlite3_exec(g_db, SCHEMA_MIGRATIONS[version], NULL, NULL, &err_msg) != SQLITE_OK ||
+            !db_migration_finish(version + 1) ||
+            sqlite3_exec(g_db, pragma, NULL, NULL, &err_msg) != SQLITE_OK ||
+            sqlite3_exec(g_db, "COMMIT;", NULL, NULL, &err_msg) != SQLITE_OK) {
+            fprintf(stderr, "Schema migration to version %d failed: %s\n",
+                    version + 1, err_msg ? err_msg : sqlite3_errmsg(g_db));
+            sqlite3_free(err_msg);
+            sqlite3_exec(g_db, "ROLLBACK;", NULL, NULL, NULL);
+            return false;
+        }
+    }
+    
     return true;
 }
 
@@ -930,7 +1245,7 @@ bool db_create_or_update_submission(int assignment_id, int student_id, Submissio
 }
 
 AssignmentSubmission** db_get_submissions_by_assignment(int assignment_id, int *count) {
-    const char *sql = "SELECT id, assignment_id, student_id, status, quality, strftime('%s', submitted_at), notes "
+    const char *sql = "SELECT assignment_id, student_id, status, quality, strftime('%s', submitted_at), notes "
                      "FROM assignment_submissions WHERE assignment_id = ?;";
     sqlite3_stmt *stmt;
     
@@ -952,14 +1267,13 @@ AssignmentSubmission** db_get_submissions_by_assignment(int assignment_id, int *
         }
         
         AssignmentSubmission *s = malloc(sizeof(AssignmentSubmission));
-        s->id = sqlite3_column_int(stmt, 0);
-        s->assignment_id = sqlite3_column_int(stmt, 1);
-        s->student_id = sqlite3_column_int(stmt, 2);
-        s->status = (SubmissionStatus)sqlite3_column_int(stmt, 3);
-        s->quality = (QualityAssessment)sqlite3_column_int(stmt, 4);
-        s->submitted_at = (time_t)sqlite3_column_int64(stmt, 5);
+        s->assignment_id = sqlite3_column_int(stmt, 0);
+        s->student_id = sqlite3_column_int(stmt, 1);
+        s->status = (SubmissionStatus)sqlite3_column_int(stmt, 2);
+        s->quality = (QualityAssessment)sqlite3_column_int(stmt, 3);
+        s->submitted_at = (time_t)sqlite3_column_int64(stmt, 4);
         
-        const unsigned char *notes = sqlite3_column_text(stmt, 6);
+        const unsigned char *notes = sqlite3_column_text(stmt, 5);
         if (notes) {
             strncpy(s->notes, (const char *)notes, MAX_DESCRIPTION_LENGTH - 1);
         } else {
@@ -975,7 +1289,7 @@ AssignmentSubmission** db_get_submissions_by_assignment(int assignment_id, int *
 }
 
 AssignmentSubmission* db_get_submission(int assignment_id, int student_id) {
-    const char *sql = "SELECT id, assignment_id, student_id, status, quality, strftime('%s', submitted_at), notes "
+    const char *sql = "SELECT assignment_id, student_id, status, quality, strftime('%s', submitted_at), notes "
                      "FROM assignment_submissions WHERE assignment_id = ? AND student_id = ?;";
     sqlite3_stmt *stmt;
     
@@ -989,14 +1303,13 @@ AssignmentSubmission* db_get_submission(int assignment_id, int student_id) {
     AssignmentSubmission *s = NULL;
     if (sqlite3_step(stmt) == SQLITE_ROW) {
         s = malloc(sizeof(AssignmentSubmission));
-        s->id = sqlite3_column_int(stmt, 0);
-        s->assignment_id = sqlite3_column_int(stmt, 1);
-        s->student_id = sqlite3_column_int(stmt, 2);
-        s->status = (SubmissionStatus)sqlite3_column_int(stmt, 3);
-        s->quality = (QualityAssessment)sqlite3_column_int(stmt, 4);
-        s->submitted_at = (time_t)sqlite3_column_int64(stmt, 5);
+        s->assignment_id = sqlite3_column_int(stmt, 0);
+        s->student_id = sqlite3_column_int(stmt, 1);
+        s->status = (SubmissionStatus)sqlite3_column_int(stmt, 2);
+        s->quality = (QualityAssessment)sqlite3_column_int(stmt, 3);
+        s->submitted_at = (time_t)sqlite3_column_int64(stmt, 4);
         
-        const unsigned char *notes = sqlite3_column_text(stmt, 6);
+        const unsigned char *notes = sqlite3_column_text(stmt, 5);
         if (notes) {
             strncpy(s->notes, (const char *)notes, MAX_DESCRIPTION_LENGTH - 1);
         } else {
@@ -1018,29 +1331,117 @@ void db_free_submissions(AssignmentSubmission **submissions, int count) {
 }
 
 // Attendance operations
+AttendanceStorageMode db_get_attendance_mode(int class_id) {
+    if (!g_db) return ATTENDANCE_STORE_FULL;
+    
+    const char *sql = "SELECT attendance_mode FROM classes WHERE id = ?;";
+    sqlite3_stmt *stmt;
+    
+    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+        return ATTENDANCE_STORE_FULL;
+    }
+    
+    sqlite3_bind_int(stmt, 1, class_id);
+    
+    AttendanceStorageMode mode = ATTENDANCE_STORE_FULL;
+    if (sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_int(stmt, 0) == ATTENDANCE_STORE_SPARSE) {
+        mode = ATTENDANCE_STORE_SPARSE;
+    }
+    
+    sqlite3_finalize(stmt);
+    return mode;
+}
+
+bool db_set_attendance_mode(int class_id, AttendanceStorageMode mode) {
+    if (!g_db || class_id <= 0) return false;
+    
+    const char *sql = "UPDATE classes SET attendance_mode = ? WHERE id = ?;";
+    sqlite3_stmt *stmt;
+    
+    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+        return false;
+    }
+    
+    sqlite3_bind_int(stmt, 1, (int)mode);
+    sqlite3_bind_int(stmt, 2, class_id);
+    
+    int rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+    
+    return rc == SQLITE_DONE;
+}
+
 bool db_mark_attendance(int student_id, time_t date, AttendanceStatus status, const char *notes) {
     const char *sql = "INSERT OR REPLACE INTO attendance (student_id, date, status, notes) "
                      "VALUES (?, date(?, 'unixepoch'), ?, ?);";
+    // An explicit row is valid in either storage mode; a day first recorded
+    // this way is a full day (students without a row were not marked)
+    const char *session_sql = "INSERT OR IGNORE INTO attendance_sessions (class_id, date, sparse) "
+                             "SELECT class_id, date(?, 'unixepoch'), 0 FROM students "
+                             "WHERE id = ? AND class_id IS NOT NULL;";
     sqlite3_stmt *stmt;
+    sqlite3_stmt *session_stmt;
     
     if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) {
         return false;
     }
+    if (sqlite3_prepare_v2(g_db, session_sql, -1, &session_stmt, NULL) != SQLITE_OK) {
+        sqlite3_finalize(stmt);
+        return false;
+    }
     
     sqlite3_bind_int(stmt, 1, student_id);
     sqlite3_bind_int64(stmt, 2, (sqlite3_int64)date);
     sqlite3_bind_int(stmt, 3, (int)status);
     sqlite3_bind_text(stmt, 4, notes ? notes : "", -1, SQLITE_STATIC);
+    sqlite3_bind_int64(session_stmt, 1, (sqlite3_int64)date);
+    sqlite3_bind_int(session_stmt, 2, student_id);
+    
+    int term;
+    int day = bitmap_day_from_time(date, &term);
+    BitmapWriter bitmaps;
+    char day_text[11];
+    db_rollup_date(date, day_text, sizeof(day_text));
+    RollupWriter rollups;
+    int class_id, old_status;
+    
+    // Row, session, index bit and rollups, or none of them
+    sqlite3_exec(g_db, "SAVEPOINT mark_attendance;", NULL, NULL, NULL);
+    bool ok = db_rollup_writer_open(&rollups);
+    if (ok) {
+        ok = db_rollup_writer_lookup(&rollups, student_id, day_text, &class_id, &old_status) &&
+             sqlite3_step(stmt) == SQLITE_DONE && sqlite3_step(session_stmt) == SQLITE_DONE &&
+             db_bitmap_writer_open(&bitmaps);
+        if (ok) {
+            ok = db_bitmap_writer_set(&bitmaps, student_id, term, day, (int)status);
+            db_bitmap_writer_close(&bitmaps);
+        }
+        ok = ok && db_rollup_writer_move(&rollups, class_id, student_id, day_text, old_status, (int)status) &&
+             db_rollup_writer_flush(&rollups);
+        db_rollup_writer_close(&rollups);
+    }
+    if (!ok) {
+        sqlite3_exec(g_db, "ROLLBACK TO mark_attendance;", NULL, NULL, NULL);
+    }
+    sqlite3_exec(g_db, "RELEASE mark_attendance;", NULL, NULL, NULL);
     
-    int rc = sqlite3_step(stmt);
     sqlite3_finalize(stmt);
+    sqlite3_finalize(session_stmt);
     
-    return rc == SQLITE_DONE;
+    return ok;
 }
 
 Attendance** db_get_attendance_by_date(time_t date, int *count) {
-    const char *sql = "SELECT id, student_id, strftime('%s', date), status, notes "
-                     "FROM attendance WHERE date = date(?, 'unixepoch');";
+    // Explicit rows, plus the implied "present" of sparse days
+    const char *sql = "SELECT student_id, strftime('%s', date), status, notes "
+                     "FROM attendance WHERE date = date(?1, 'unixepoch') "
+                     "UNION ALL "
+                     "SELECT s.id, strftime('%s', ses.date), 1, '' "
+                     "FROM attendance_sessions ses "
+                     "INNER JOIN students s ON s.class_id = ses.class_id "
+                     "WHERE ses.date = date(?1, 'unixepoch') AND ses.sparse = 1 "
+                     "AND NOT EXISTS (SELECT 1 FROM attendance a "
+                     "WHERE a.student_id = s.id AND a.date = ses.date);";
     sqlite3_stmt *stmt;
     
     *count = 0;
@@ -1061,12 +1462,11 @@ Attendance** db_get_attendance_by_date(time_t date, int *count) {
         }
         
         Attendance *a = malloc(sizeof(Attendance));
-        a->id = sqlite3_column_int(stmt, 0);
-        a->student_id = sqlite3_column_int(stmt, 1);
-        a->date = (time_t)sqlite3_column_int64(stmt, 2);
-        a->status = (AttendanceStatus)sqlite3_column_int(stmt, 3);
+        a->student_id = sqlite3_column_int(stmt, 0);
+        a->date = (time_t)sqlite3_column_int64(stmt, 1);
+        a->status = (AttendanceStatus)sqlite3_column_int(stmt, 2);
         
-        const unsigned char *notes = sqlite3_column_text(stmt, 4);
+        const unsigned char *notes = sqlite3_column_text(stmt, 3);
         if (notes) {
             strncpy(a->notes, (const char *)notes, MAX_DESCRIPTION_LENGTH - 1);
         } else {
@@ -1082,8 +1482,17 @@ Attendance** db_get_attendance_by_date(time_t date, int *count) {
 }
 
 Attendance** db_get_attendance_by_student(int student_id, int *count) {
-    const char *sql = "SELECT id, student_id, strftime('%s', date), status, notes "
-                     "FROM attendance WHERE student_id = ? ORDER BY date DESC;";
+    // Explicit rows, plus the implied "present" of sparse days
+    const char *sql = "SELECT student_id, strftime('%s', date), status, notes, date AS day "
+                     "FROM attendance WHERE student_id = ?1 "
+                     "UNION ALL "
+                     "SELECT ?1, strftime('%s', ses.date), 1, '', ses.date "
+                     "FROM attendance_sessions ses "
+                     "WHERE ses.class_id = (SELECT class_id FROM students WHERE id = ?1) "
+                     "AND ses.sparse = 1 "
+                     "AND NOT EXISTS (SELECT 1 FROM attendance a "
+                     "WHERE a.student_id = ?1 AND a.date = ses.date) "
+                     "ORDER BY day DESC;";
     sqlite3_stmt *stmt;
     
     *count = 0;
@@ -1104,12 +1513,11 @@ Attendance** db_get_attendance_by_student(int student_id, int *count) {
         }
         
         Attendance *a = malloc(sizeof(Attendance));
-        a->id = sqlite3_column_int(stmt, 0);
-        a->student_id = sqlite3_column_int(stmt, 1);
-        a->date = (time_t)sqlite3_column_int64(stmt, 2);
-        a->status = (AttendanceStatus)sqlite3_column_int(stmt, 3);
+        a->student_id = sqlite3_column_int(stmt, 0);
+        a->date = (time_t)sqlite3_column_int64(stmt, 1);
+        a->status = (AttendanceStatus)sqlite3_column_int(stmt, 2);
         
-        const unsigned char *notes = sqlite3_column_text(stmt, 4);
+        const unsigned char *notes = sqlite3_column_text(stmt, 3);
         if (notes) {
             strncpy(a->notes, (const char *)notes, MAX_DESCRIPTION_LENGTH - 1);
         } else {
@@ -1133,6 +1541,420 @@ void db_free_attendance(Attendance **attendance, int count) {
     }
 }
 
+// Distinct attendance dates for a class, newest first (YYYY-MM-DD strings)
+char** db_get_attendance_dates(int class_id, int *count) {
+    return db_search_attendance_dates(class_id, NULL, NULL, count);
+}
+
+char** db_search_attendance_dates(int class_id, const char *from, const char *to, int *count) {
+    if (!g_db || !count) return NULL;
+
+    // Dates are stored as YYYY-MM-DD text, so every date starting with the
+    // prefix "to" sorts below "to" with its last character bumped by one
+    // ("2024-03" -> "2024-04"). "~" sorts above any date.
+    char upper[32] = "~";
+    if (to && *to) {
+        size_t len = strlen(to);
+        if (len >= sizeof(upper)) return NULL;
+        memcpy(upper, to, len + 1);
+        upper[len - 1]++;
+    }
+
+    const char *sql = "SELECT date FROM attendance_sessions "
+                     "WHERE class_id = ? AND date >= ? AND date < ? "
+                     "ORDER BY date DESC;";
+    sqlite3_stmt *stmt;
+
+    *count = 0;
+
+    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+        return NULL;
+    }
+
+    sqlite3_bind_int(stmt, 1, class_id);
+    sqlite3_bind_text(stmt, 2, from ? from : "", -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 3, upper, -1, SQLITE_STATIC);
+
+    int capacity = 32;
+    char **dates = malloc(capacity * sizeof(char*));
+    if (!dates) {
+        sqlite3_finalize(stmt);
+        return NULL;
+    }
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        const char *date = (const char *)sqlite3_column_text(stmt, 0);
+        if (!date) continue;
+
+        if (*count >= capacity) {
+            capacity *= 2;
+            char **temp = realloc(dates, capacity * sizeof(char*));
+            if (!temp) {
+                db_free_attendance_dates(dates, *count);
+                sqlite3_finalize(stmt);
+                *count = 0;
+                return NULL;
+            }
+            dates = temp;
+        }
+
+        dates[*count] = strdup(date);
+        if (!dates[*count]) {
+            db_free_attendance_dates(dates, *count);
+            sqlite3_finalize(stmt);
+            *count = 0;
+            return NULL;
+        }
+        (*count)++;
+    }
+
+    sqlite3_finalize(stmt);
+
+    if (*count == 0) {
+        free(dates);
+        return NULL;
+    }
+
+    return dates;
+}
+
+void db_free_attendance_dates(char **dates, int count) {
+    if (dates) {
+        for (int i = 0; i < count; i++) {
+            free(dates[i]);
+        }
+        free(dates);
+    }
+}
+
+// Every student in the class with their attendance on the given date (if any)
+AttendanceSheetRow** db_get_attendance_sheet(int class_id, const char *date, int *count) {
+    if (!g_db || !count || !date) return NULL;
+
+    // Students without a row on a sparse day were present
+    const char *sql = "SELECT s.id, s.name, s.roll_number, "
+                     "COALESCE(a.status, CASE WHEN ses.sparse = 1 THEN 1 END), a.notes "
+                     "FROM students s "
+                     "LEFT JOIN attendance_sessions ses ON ses.class_id = s.class_id AND ses.date = ?1 "
+                     "LEFT JOIN attendance a ON s.id = a.student_id AND a.date = ?1 "
+                     "WHERE s.class_id = ?2 "
+                     "ORDER BY s.roll_number;";
+    sqlite3_stmt *stmt;
+
+    *count = 0;
+
+    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+        return NULL;
+    }
+
+    sqlite3_bind_text(stmt, 1, date, -1, SQLITE_STATIC);
+    sqlite3_bind_int(stmt, 2, class_id);
+
+    int capacity = 32;
+    AttendanceSheetRow **rows = malloc(capacity * sizeof(AttendanceSheetRow*));
+    if (!rows) {
+        sqlite3_finalize(stmt);
+        return NULL;
+    }
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        if (*count >= capacity) {
+            capacity *= 2;
+            AttendanceSheetRow **temp = realloc(rows, capacity * sizeof(AttendanceSheetRow*));
+            if (!temp) {
+                db_free_attendance_sheet(rows, *count);
+                sqlite3_finalize(stmt);
+                *count = 0;
+                return NULL;
+            }
+            rows = temp;
+        }
+
+        AttendanceSheetRow *r = malloc(sizeof(AttendanceSheetRow));
+        if (!r) {
+            db_free_attendance_sheet(rows, *count);
+            sqlite3_finalize(stmt);
+            *count = 0;
+            return NULL;
+        }
+
+        r->student_id = sqlite3_column_int(stmt, 0);
+        strncpy(r->name, (const char *)sqlite3_column_text(stmt, 1), MAX_NAME_LENGTH - 1);
+        r->name[MAX_NAME_LENGTH - 1] = '\0';
+        strncpy(r->roll_number, (const char *)sqlite3_column_text(stmt, 2), 49);
+        r->roll_number[49] = '\0';
+        r->status = sqlite3_column_type(stmt, 3) != SQLITE_NULL ?
+                    sqlite3_column_int(stmt, 3) : -1;
+
+        const unsigned char *notes = sqlite3_column_text(stmt, 4);
+        if (notes) {
+            strncpy(r->notes, (const char *)notes, MAX_DESCRIPTION_LENGTH - 1);
+            r->notes[MAX_DESCRIPTION_LENGTH - 1] = '\0';
+        } else {
+            r->notes[0] = '\0';
+        }
+
+        rows[*count] = r;
+        (*count)++;
+    }
+
+    sqlite3_finalize(stmt);
+
+    if (*count == 0) {
+        free(rows);
+        return NULL;
+    }
+
+    return rows;
+}
+
+void db_free_attendance_sheet(AttendanceSheetRow **rows, int count) {
+    if (rows) {
+        for (int i = 0; i < count; i++) {
+            free(rows[i]);
+        }
+        free(rows);
+    }
+}
+
+SubmissionSheetRow** db_get_submission_sheet(int class_id, int assignment_id, int *count) {
+    if (!g_db || !count) return NULL;
+
+    const char *sql = "SELECT s.id, s.name, s.roll_number, "
+                     "COALESCE(sub.status, 0), COALESCE(sub.quality, 0), sub.notes "
+                     "FROM students s "
+                     "LEFT JOIN assignment_submissions sub "
+                     "ON sub.assignment_id = ?1 AND sub.student_id = s.id "
+                     "WHERE s.class_id = ?2 "
+                     "ORDER BY s.name;";
+    sqlite3_stmt *stmt;
+
+    *count = 0;
+
+    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+        return NULL;
+    }
+
+    sqlite3_bind_int(stmt, 1, assignment_id);
+    sqlite3_bind_int(stmt, 2, class_id);
+
+    int capacity = 32;
+    SubmissionSheetRow **rows = malloc(capacity * sizeof(SubmissionSheetRow*));
+    if (!rows) {
+        sqlite3_finalize(stmt);
+        return NULL;
+    }
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        if (*count >= capacity) {
+            capacity *= 2;
+            SubmissionSheetRow **temp = realloc(rows, capacity * sizeof(SubmissionSheetRow*));
+            if (!temp) {
+                db_free_submission_sheet(rows, *count);
+                sqlite3_finalize(stmt);
+                *count = 0;
+                return NULL;
+            }
+            rows = temp;
+        }
+
+        SubmissionSheetRow *r = malloc(sizeof(SubmissionSheetRow));
+        if (!r) {
+            db_free_submission_sheet(rows, *count);
+            sqlite3_finalize(stmt);
+            *count = 0;
+            return NULL;
+        }
+
+        r->student_id = sqlite3_column_int(stmt, 0);
+        strncpy(r->name, (const char *)sqlite3_column_text(stmt, 1), MAX_NAME_LENGTH - 1);
+        r->name[MAX_NAME_LENGTH - 1] = '\0';
+        strncpy(r->roll_number, (const char *)sqlite3_column_text(stmt, 2), 49);
+        r->roll_number[49] = '\0';
+        r->status = (SubmissionStatus)sqlite3_column_int(stmt, 3);
+        r->quality = (QualityAssessment)sqlite3_column_int(stmt, 4);
+
+        const unsigned char *notes = sqlite3_column_text(stmt, 5);
+        if (notes) {
+            strncpy(r->notes, (const char *)notes, MAX_DESCRIPTION_LENGTH - 1);
+            r->notes[MAX_DESCRIPTION_LENGTH - 1] = '\0';
+        } else {
+            r->notes[0] = '\0';
+        }
+
+        rows[*count] = r;
+        (*count)++;
+    }
+
+    sqlite3_finalize(stmt);
+
+    if (*count == 0) {
+        free(rows);
+        return NULL;
+    }
+
+    return rows;
+}
+
+void db_free_submission_sheet(SubmissionSheetRow **rows, int count) {
+    if (rows) {
+        for (int i = 0; i < count; i++) {
+            free(rows[i]);
+        }
+        free(rows);
+    }
+}
+
+// Report operations
+int db_count_students_by_class(int class_id) {
+    if (!g_db) return 0;
+
+    const char *sql = "SELECT COUNT(*) FROM students WHERE class_id = ?;";
+    sqlite3_stmt *stmt;
+
+    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+        return 0;
+    }
+
+    sqlite3_bind_int(stmt, 1, class_id);
+
+    int count = 0;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        count = sqlite3_column_int(stmt, 0);
+    }
+
+    sqlite3_finalize(stmt);
+    return count;
+}
+
+AttendanceSummary** db_get_attendance_summary(int class_id, int *count) {
+    return db_get_attendance_summary_range(class_id, NULL, NULL, count);
+}
+
+void db_free_attendance_summary(AttendanceSummary **rows, int count) {
+    if (rows) {
+        for (int i = 0; i < count; i++) {
+            free(rows[i]);
+        }
+        free(rows);
+    }
+}
+
+AssignmentSummary** db_get_assignment_summary(int class_id, int *count) {
+    if (!g_db || !count) return NULL;
+
+    // Grouping in idx_assignments_class_due order (due_date, id) streams the
+    // groups; only the per-assignment result rows get sorted by title
+    const char *sql = "SELECT a.id, a.title, a.subject, "
+                     "COUNT(CASE WHEN s.status IN (1, 2) THEN 1 END) as completed "
+                     "FROM assignments a "
+                     "LEFT JOIN assignment_submissions s ON a.id = s.assignment_id "
+                     "WHERE a.class_id = ? "
+                     "GROUP BY a.due_date, a.id "
+                     "ORDER BY a.title;";
+    sqlite3_stmt *stmt;
+
+    *count = 0;
+
+    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+        return NULL;
+    }
+
+    sqlite3_bind_int(stmt, 1, class_id);
+
+    int capacity = 16;
+    AssignmentSummary **rows = malloc(capacity * sizeof(AssignmentSummary*));
+    if (!rows) {
+        sqlite3_finalize(stmt);
+        return NULL;
+    }
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        if (*count >= capacity) {
+            capacity *= 2;
+            AssignmentSummary **temp = realloc(rows, capacity * sizeof(AssignmentSummary*));
+            if (!temp) {
+                db_free_assignment_summary(rows, *count);
+                sqlite3_finalize(stmt);
+                *count = 0;
+                return NULL;
+            }
+            rows = temp;
+        }
+
+        AssignmentSummary *r = malloc(sizeof(AssignmentSummary));
+        if (!r) {
+            db_free_assignment_summary(rows, *count);
+            sqlite3_finalize(stmt);
+            *count = 0;
+            return NULL;
+        }
+
+        r->assignment_id = sqlite3_column_int(stmt, 0);
+        strncpy(r->title, (const char *)sqlite3_column_text(stmt, 1), MAX_TITLE_LENGTH - 1);
+        r->title[MAX_TITLE_LENGTH - 1] = '\0';
+        strncpy(r->subject, (const char *)sqlite3_column_text(stmt, 2), MAX_SUBJECT_LENGTH - 1);
+        r->subject[MAX_SUBJECT_LENGTH - 1] = '\0';
+        r->completed = sqlite3_column_int(stmt, 3);
+
+        rows[*count] = r;
+        (*count)++;
+    }
+
+    sqlite3_finalize(stmt);
+
+    if (*count == 0) {
+        free(rows);
+        return NULL;
+    }
+
+    return rows;
+}
+
+void db_free_assignment_summary(AssignmentSummary **rows, int count) {
+    if (rows) {
+        for (int i = 0; i < count; i++) {
+            free(rows[i]);
+        }
+        free(rows);
+    }
+}
+
+bool db_get_student_attendance_stats(int student_id, int *total, int *present, int *absent, int *late) {
+    if (!g_db || !total || !present || !absent || !late) return false;
+
+    return db_bitmap_student_stats(student_id, NULL, NULL, total, present, absent, late, NULL);
+}
+
+bool db_get_student_assignment_stats(int student_id, int class_id, int *total, int *completed) {
+    if (!g_db || !total || !completed) return false;
+
+    const char *sql = "SELECT "
+                     "COUNT(*) as total, "
+                     "SUM(CASE WHEN s.status IN (1, 2) THEN 1 ELSE 0 END) as completed "
+                     "FROM assignments a "
+                     "LEFT JOIN assignment_submissions s ON a.id = s.assignment_id AND s.student_id = ? "
+                     "WHERE a.class_id = ?;";
+    sqlite3_stmt *stmt;
+
+    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+        return false;
+    }
+
+    sqlite3_bind_int(stmt, 1, student_id);
+    sqlite3_bind_int(stmt, 2, class_id);
+
+    bool found = false;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        *total = sqlite3_column_int(stmt, 0);
+        *completed = sqlite3_column_int(stmt, 1);
+        found = true;
+    }
+
+    sqlite3_finalize(stmt);
+    return found;
+}
+
 // Database migration for multi-class support
 bool db_migrate_to_class_system(int teacher_id) {
     char *err_msg = NULL;
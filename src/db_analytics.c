@@ -0,0 +1,556 @@
+#include "db_analytics.h"
+
+// Day numbers
+
+static int32_t days_from_civil(int year, int month, int day) {
+    year -= month <= 2;
+    int era = (year >= 0 ? year : year - 399) / 400;
+    int yoe = year - era * 400;
+    int doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+static void civil_from_days(int32_t days, int *year, int *month) {
+    days += 719468;
+    int era = (days >= 0 ? days : days - 146096) / 146097;
+    int doe = days - era * 146097;
+    int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int mp = (5 * doy + 2) / 153;
+    *month = mp < 10 ? mp + 3 : mp - 9;
+    *year = yoe + era * 400 + (*month <= 2);
+}
+
+bool analytics_day_number(const char *date, int32_t *day) {
+    int year, month, dom;
+    if (!date || sscanf(date, "%d-%d-%d", &year, &month, &dom) != 3 ||
+        month < 1 || month > 12 || dom < 1 || dom > 31) {
+        return false;
+    }
+    *day = days_from_civil(year, month, dom);
+    return true;
+}
+
+// Kernels: branch-free bodies so the compiler can vectorize them
+
+int analytics_filter_range(const int32_t *values, int n, int32_t lo, int32_t hi, uint8_t *mask) {
+    int matches = 0;
+    for (int i = 0; i < n; i++) {
+        uint8_t m = (uint8_t)((values[i] >= lo) & (values[i] <= hi));
+        mask[i] = m;
+        matches += m;
+    }
+    return matches;
+}
+
+void analytics_count_by_key(const uint32_t *keys, const uint8_t *values, const uint8_t *mask,
+                            int n, int width, int *counts) {
+    for (int i = 0; i < n; i++) {
+        counts[keys[i] * width + values[i]] += mask[i];
+    }
+}
+
+// Loading
+
+static bool grow(void **column, size_t size, int capacity) {
+    void *grown = realloc(*column, (size_t)capacity * size);
+    if (!grown) return false;
+    *column = grown;
+    return true;
+}
+
+static int find_id(const int *ids, int count, int id) {
+    int lo = 0, hi = count - 1;
+    while (lo <= hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (ids[mid] == id) return mid;
+        if (ids[mid] < id) lo = mid + 1;
+        else hi = mid - 1;
+    }
+    return -1;
+}
+
+typedef struct {
+    int id;
+    int class_index;
+    int subject;
+    int32_t due;
+} DimensionRow;
+
+static int compare_dimension_rows(const void *a, const void *b) {
+    int x = ((const DimensionRow *)a)->id;
+    int y = ((const DimensionRow *)b)->id;
+    return (x > y) - (x < y);
+}
+
+static int subject_index(AnalyticsStore *store, const char *subject, int *capacity) {
+    for (int i = 0; i < store->subject_count; i++) {
+        if (strcmp(store->subjects[i], subject) == 0) return i;
+    }
+    if (store->subject_count >= *capacity) {
+        *capacity = *capacity ? *capacity * 2 : 8;
+        if (!grow((void **)&store->subjects, sizeof(store->subjects[0]), *capacity)) return -1;
+    }
+    strncpy(store->subjects[store->subject_count], subject, MAX_SUBJECT_LENGTH - 1);
+    store->subjects[store->subject_count][MAX_SUBJECT_LENGTH - 1] = '\0';
+    return store->subject_count++;
+}
+
+static int compare_subjects(const void *a, const void *b) {
+    return strcmp((const char *)a, (const char *)b);
+}
+
+// Sort the subject dictionary by name and renumber the assignments to match
+static bool sort_subjects(AnalyticsStore *store, DimensionRow *assignments, int assignment_count) {
+    int n = store->subject_count;
+    if (n < 2) return true;
+
+    char (*sorted)[MAX_SUBJECT_LENGTH] = malloc(n * sizeof(sorted[0]));
+    int *renumber = malloc(n * sizeof(int));
+    if (!sorted || !renumber) {
+        free(sorted);
+        free(renumber);
+        return false;
+    }
+
+    memcpy(sorted, store->subjects, n * sizeof(sorted[0]));
+    qsort(sorted, n, sizeof(sorted[0]), compare_subjects);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            if (strcmp(store->subjects[i], sorted[j]) == 0) {
+                renumber[i] = j;
+                break;
+            }
+        }
+    }
+    for (int i = 0; i < assignment_count; i++) {
+        assignments[i].subject = renumber[assignments[i].subject];
+    }
+
+    free(store->subjects);
+    store->subjects = sorted;
+    free(renumber);
+    return true;
+}
+
+static bool load_classes(AnalyticsStore *store, int teacher_id) {
+    const char *sql = "SELECT id, name FROM classes WHERE teacher_id = ? ORDER BY name;";
+    sqlite3_stmt *stmt;
+    int capacity = 0;
+
+    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) return false;
+    sqlite3_bind_int(stmt, 1, teacher_id);
+
+    bool ok = true;
+    while (ok && sqlite3_step(stmt) == SQLITE_ROW) {
+        if (store->class_count >= capacity) {
+            capacity = capacity ? capacity * 2 : 8;
+            ok = grow((void **)&store->class_ids, sizeof(int), capacity) &&
+                 grow((void **)&store->class_names, sizeof(store->class_names[0]), capacity);
+            if (!ok) break;
+        }
+        int c = store->class_count++;
+        store->class_ids[c] = sqlite3_column_int(stmt, 0);
+        strncpy(store->class_names[c], (const char *)sqlite3_column_text(stmt, 1), MAX_NAME_LENGTH - 1);
+        store->class_names[c][MAX_NAME_LENGTH - 1] = '\0';
+    }
+
+    sqlite3_finalize(stmt);
+    return ok && store->class_count <= UINT16_MAX;
+}
+
+// Students and assignments of every class, sorted by id for lookups
+static bool load_dimensions(AnalyticsStore *store) {
+    const char *student_sql = "SELECT id FROM students WHERE class_id = ?;";
+    const char *assignment_sql = "SELECT id, subject, CAST(julianday(date(due_date)) - 2440587.5 AS INTEGER) "
+                                "FROM assignments WHERE class_id = ?;";
+    sqlite3_stmt *student_stmt, *assignment_stmt;
+
+    if (sqlite3_prepare_v2(g_db, student_sql, -1, &student_stmt, NULL) != SQLITE_OK) return false;
+    if (sqlite3_prepare_v2(g_db, assignment_sql, -1, &assignment_stmt, NULL) != SQLITE_OK) {
+        sqlite3_finalize(student_stmt);
+        return false;
+    }
+
+    DimensionRow *students = NULL, *assignments = NULL;
+    int student_count = 0, student_capacity = 0;
+    int assignment_count = 0, assignment_capacity = 0;
+    int subject_capacity = 0;
+    bool ok = true;
+
+    for (int c = 0; ok && c < store->class_count; c++) {
+        sqlite3_bind_int(student_stmt, 1, store->class_ids[c]);
+        while (ok && sqlite3_step(student_stmt) == SQLITE_ROW) {
+            if (student_count >= student_capacity) {
+                student_capacity = student_capacity ? student_capacity * 2 : 256;
+                if (!(ok = grow((void **)&students, sizeof(DimensionRow), student_capacity))) break;
+            }
+            students[student_count].id = sqlite3_column_int(student_stmt, 0);
+            students[student_count].class_index = c;
+            student_count++;
+        }
+        sqlite3_reset(student_stmt);
+
+        sqlite3_bind_int(assignment_stmt, 1, store->class_ids[c]);
+        while (ok && sqlite3_step(assignment_stmt) == SQLITE_ROW) {
+            if (assignment_count >= assignment_capacity) {
+                assignment_capacity = assignment_capacity ? assignment_capacity * 2 : 64;
+                if (!(ok = grow((void **)&assignments, sizeof(DimensionRow), assignment_capacity))) break;
+            }
+            DimensionRow *a = &assignments[assignment_count];
+            a->id = sqlite3_column_int(assignment_stmt, 0);
+            a->class_index = c;
+            a->subject = subject_index(store, (const char *)sqlite3_column_text(assignment_stmt, 1),
+                                       &subject_capacity);
+            a->due = sqlite3_column_int(assignment_stmt, 2);
+            ok = a->subject >= 0;
+            assignment_count++;
+        }
+        sqlite3_reset(assignment_stmt);
+    }
+
+    sqlite3_finalize(student_stmt);
+    sqlite3_finalize(assignment_stmt);
+
+    ok = ok && sort_subjects(store, assignments, assignment_count);
+
+    if (ok) {
+        qsort(students, student_count, sizeof(DimensionRow), compare_dimension_rows);
+        qsort(assignments, assignment_count, sizeof(DimensionRow), compare_dimension_rows);
+
+        int students_alloc = student_count > 0 ? student_count : 1;
+        int assignments_alloc = assignment_count > 0 ? assignment_count : 1;
+        store->student_ids = malloc(students_alloc * sizeof(int));
+        store->student_class = malloc(students_alloc * sizeof(uint16_t));
+        store->assignment_ids = malloc(assignments_alloc * sizeof(int));
+        store->assignment_class = malloc(assignments_alloc * sizeof(uint16_t));
+        store->assignment_subject = malloc(assignments_alloc * sizeof(uint16_t));
+        store->assignment_due = malloc(assignments_alloc * sizeof(int32_t));
+        ok = store->student_ids && store->student_class && store->assignment_ids &&
+             store->assignment_class && store->assignment_subject && store->assignment_due &&
+             store->subject_count <= UINT16_MAX;
+    }
+
+    if (ok) {
+        for (int i = 0; i < student_count; i++) {
+            store->student_ids[i] = students[i].id;
+            store->student_class[i] = (uint16_t)students[i].class_index;
+        }
+        store->student_count = student_count;
+
+        for (int i = 0; i < assignment_count; i++) {
+            store->assignment_ids[i] = assignments[i].id;
+            store->assignment_class[i] = (uint16_t)assignments[i].class_index;
+            store->assignment_subject[i] = (uint16_t)assignments[i].subject;
+            store->assignment_due[i] = assignments[i].due;
+        }
+        store->assignment_count = assignment_count;
+    }
+
+    free(students);
+    free(assignments);
+    return ok;
+}
+
+static bool load_attendance(AnalyticsStore *store) {
+    // Same rows as db_cursor_attendance_by_class, without the ordering
+    const char *sql = "SELECT a.student_id, CAST(julianday(a.date) - 2440587.5 AS INTEGER), a.status "
+                     "FROM students s "
+                     "INNER JOIN attendance a ON a.student_id = s.id "
+                     "WHERE s.class_id = ?1 "
+                     "UNION ALL "
+                     "SELECT s.id, CAST(julianday(ses.date) - 2440587.5 AS INTEGER), 1 "
+                     "FROM students s "
+                     "INNER JOIN attendance_sessions ses ON ses.class_id = s.class_id "
+                     "WHERE s.class_id = ?1 AND ses.sparse = 1 "
+                     "AND NOT EXISTS (SELECT 1 FROM attendance a "
+                     "WHERE a.student_id = s.id AND a.date = ses.date);";
+    sqlite3_stmt *stmt;
+
+    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) return false;
+
+    int capacity = 0;
+    bool ok = true;
+    store->first_day = INT32_MAX;
+    store->last_day = INT32_MIN;
+
+    for (int c = 0; ok && c < store->class_count; c++) {
+        sqlite3_bind_int(stmt, 1, store->class_ids[c]);
+        while (ok && sqlite3_step(stmt) == SQLITE_ROW) {
+            int student = find_id(store->student_ids, store->student_count, sqlite3_column_int(stmt, 0));
+            int status = sqlite3_column_int(stmt, 2);
+            if (student < 0 || status < ATTENDANCE_ABSENT || status > ATTENDANCE_LATE) continue;
+
+            if (store->attendance_count >= capacity) {
+                capacity = capacity ? capacity * 2 : 4096;
+                ok = grow((void **)&store->att_student, sizeof(uint32_t), capacity) &&
+                     grow((void **)&store->att_day, sizeof(int32_t), capacity) &&
+                     grow((void **)&store->att_status, sizeof(uint8_t), capacity);
+                if (!ok) break;
+            }
+
+            int i = store->attendance_count++;
+            int32_t day = sqlite3_column_int(stmt, 1);
+            store->att_student[i] = (uint32_t)student;
+            store->att_day[i] = day;
+            store->att_status[i] = (uint8_t)status;
+            if (day < store->first_day) store->first_day = day;
+            if (day > store->last_day) store->last_day = day;
+        }
+        sqlite3_reset(stmt);
+    }
+
+    sqlite3_finalize(stmt);
+    return ok;
+}
+
+static bool load_submissions(AnalyticsStore *store) {
+    const char *sql = "SELECT s.assignment_id, s.student_id, s.status, s.quality "
+                     "FROM assignments a "
+                     "INNER JOIN assignment_submissions s ON s.assignment_id = a.id "
+                     "WHERE a.class_id = ?;";
+    sqlite3_stmt *stmt;
+
+    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) return false;
+
+    int capacity = 0;
+    bool ok = true;
+
+    for (int c = 0; ok && c < store->class_count; c++) {
+        sqlite3_bind_int(stmt, 1, store->class_ids[c]);
+        while (ok && sqlite3_step(stmt) == SQLITE_ROW) {
+            int assignment = find_id(store->assignment_ids, store->assignment_count, sqlite3_column_int(stmt, 0));
+            int student = find_id(store->student_ids, store->student_count, sqlite3_column_int(stmt, 1));
+            int status = sqlite3_column_int(stmt, 2);
+            int quality = sqlite3_column_int(stmt, 3);
+            if (assignment < 0 || student < 0 || status < SUBMISSION_NONE || status > SUBMISSION_LATE ||
+                quality < QUALITY_POOR || quality > QUALITY_HIGH) {
+                continue;
+            }
+
+            if (store->submission_count >= capacity) {
+                capacity = capacity ? capacity * 2 : 1024;
+                ok = grow((void **)&store->sub_student, sizeof(uint32_t), capacity) &&
+                     grow((void **)&store->sub_assignment, sizeof(uint32_t), capacity) &&
+                     grow((void **)&store->sub_status, sizeof(uint8_t), capacity) &&
+                     grow((void **)&store->sub_quality, sizeof(uint8_t), capacity);
+                if (!ok) break;
+            }
+
+            int i = store->submission_count++;
+            store->sub_student[i] = (uint32_t)student;
+            store->sub_assignment[i] = (uint32_t)assignment;
+            store->sub_status[i] = (uint8_t)status;
+            store->sub_quality[i] = (uint8_t)quality;
+        }
+        sqlite3_reset(stmt);
+    }
+
+    sqlite3_finalize(stmt);
+    return ok;
+}
+
+bool analytics_load(AnalyticsStore *store, int teacher_id) {
+    if (!store) return false;
+    memset(store, 0, sizeof(*store));
+    if (!g_db) return false;
+
+    // One read transaction, so the facts are a consistent snapshot
+    sqlite3_exec(g_db, "SAVEPOINT analytics_load;", NULL, NULL, NULL);
+    bool ok = load_classes(store, teacher_id) && load_dimensions(store) &&
+              load_attendance(store) && load_submissions(store);
+    sqlite3_exec(g_db, "RELEASE analytics_load;", NULL, NULL, NULL);
+
+    if (!ok) {
+        fprintf(stderr, "Failed to load analytics for teacher %d\n", teacher_id);
+        analytics_free(store);
+    }
+    return ok;
+}
+
+void analytics_free(AnalyticsStore *store) {
+    if (!store) return;
+
+    free(store->class_ids);
+    free(store->class_names);
+    free(store->student_ids);
+    free(store->student_class);
+    free(store->subjects);
+    free(store->assignment_ids);
+    free(store->assignment_class);
+    free(store->assignment_subject);
+    free(store->assignment_due);
+    free(store->att_student);
+    free(store->att_day);
+    free(store->att_status);
+    free(store->sub_student);
+    free(store->sub_assignment);
+    free(store->sub_status);
+    free(store->sub_quality);
+    memset(store, 0, sizeof(*store));
+}
+
+// Reports
+
+static bool parse_bounds(const char *from, const char *to, int32_t *lo, int32_t *hi) {
+    *lo = INT32_MIN;
+    *hi = INT32_MAX;
+    if (from && from[0] && !analytics_day_number(from, lo)) return false;
+    if (to && to[0] && !analytics_day_number(to, hi)) return false;
+    return true;
+}
+
+AnalyticsMonthRow* analytics_monthly_attendance(const AnalyticsStore *store, const char *from,
+                                                const char *to, int *count) {
+    if (!store || !count) return NULL;
+    *count = 0;
+
+    int32_t lo, hi;
+    if (!parse_bounds(from, to, &lo, &hi)) return NULL;
+    if (lo < store->first_day) lo = store->first_day;
+    if (hi > store->last_day) hi = store->last_day;
+    if (store->attendance_count == 0 || lo > hi) {
+        return calloc(1, sizeof(AnalyticsMonthRow));
+    }
+
+    int n = store->attendance_count;
+    int first_year, first_month, last_year, last_month;
+    civil_from_days(lo, &first_year, &first_month);
+    civil_from_days(hi, &last_year, &last_month);
+    int months = (last_year - first_year) * 12 + last_month - first_month + 1;
+    int span = hi - lo + 1;
+
+    // Month offset of every day in the range, so the main loop is a lookup
+    uint32_t *month_of_day = malloc(span * sizeof(uint32_t));
+    uint32_t *keys = malloc(n * sizeof(uint32_t));
+    uint8_t *mask = malloc(n);
+    int *counts = calloc((size_t)store->class_count * months * 3, sizeof(int));
+    AnalyticsMonthRow *rows = NULL;
+
+    if (month_of_day && keys && mask && counts) {
+        for (int d = 0; d < span; d++) {
+            int year, month;
+            civil_from_days(lo + d, &year, &month);
+            month_of_day[d] = (uint32_t)((year - first_year) * 12 + month - first_month);
+        }
+
+        analytics_filter_range(store->att_day, n, lo, hi, mask);
+        for (int i = 0; i < n; i++) {
+            // Filtered-out facts index day 0 and add 0
+            int32_t offset = (store->att_day[i] - lo) * mask[i];
+            keys[i] = store->student_class[store->att_student[i]] * (uint32_t)months + month_of_day[offset];
+        }
+        analytics_count_by_key(keys, store->att_status, mask, n, 3, counts);
+
+        int capacity = 16;
+        rows = malloc(capacity * sizeof(AnalyticsMonthRow));
+        for (int c = 0; rows && c < store->class_count; c++) {
+            for (int m = 0; m < months; m++) {
+                int *cell = &counts[(c * months + m) * 3];
+                if (cell[0] + cell[1] + cell[2] == 0) continue;
+
+                if (*count >= capacity) {
+                    capacity *= 2;
+                    AnalyticsMonthRow *grown = realloc(rows, capacity * sizeof(AnalyticsMonthRow));
+                    if (!grown) {
+                        free(rows);
+                        rows = NULL;
+                        break;
+                    }
+                    rows = grown;
+                }
+
+                AnalyticsMonthRow *r = &rows[(*count)++];
+                int month_index = first_month - 1 + m;
+                r->class_id = store->class_ids[c];
+                r->year = first_year + month_index / 12;
+                r->month = month_index % 12 + 1;
+                r->absent = cell[ATTENDANCE_ABSENT];
+                r->present = cell[ATTENDANCE_PRESENT];
+                r->late = cell[ATTENDANCE_LATE];
+            }
+        }
+    }
+
+    if (!rows) *count = 0;
+    free(month_of_day);
+    free(keys);
+    free(mask);
+    free(counts);
+    return rows;
+}
+
+AnalyticsSubjectRow* analytics_subject_quality(const AnalyticsStore *store, const char *from,
+                                               const char *to, int *count) {
+    if (!store || !count) return NULL;
+    *count = 0;
+
+    int32_t lo, hi;
+    if (!parse_bounds(from, to, &lo, &hi)) return NULL;
+
+    int n = store->submission_count;
+    int groups = store->class_count * store->subject_count;
+    int alloc = n > 0 ? n : 1;
+    int32_t *due = malloc(alloc * sizeof(int32_t));
+    uint32_t *keys = malloc(alloc * sizeof(uint32_t));
+    uint8_t *mask = malloc(alloc);
+    uint8_t *submitted = malloc(alloc);
+    int *status_counts = calloc(groups > 0 ? groups * 3 : 1, sizeof(int));
+    int *quality_counts = calloc(groups > 0 ? groups * (QUALITY_HIGH + 1) : 1, sizeof(int));
+    int *enrolment = calloc(store->class_count > 0 ? store->class_count : 1, sizeof(int));
+    int *assigned_counts = calloc(groups > 0 ? groups : 1, sizeof(int));
+    AnalyticsSubjectRow *rows = NULL;
+
+    if (due && keys && mask && submitted && status_counts && quality_counts &&
+        enrolment && assigned_counts) {
+        // Every student of the class is assigned the work, whether or not
+        // the grading grid has stored a row for them yet
+        for (int i = 0; i < store->student_count; i++) {
+            enrolment[store->student_class[i]]++;
+        }
+        for (int a = 0; a < store->assignment_count; a++) {
+            if (store->assignment_due[a] < lo || store->assignment_due[a] > hi) continue;
+            int c = store->assignment_class[a];
+            assigned_counts[c * store->subject_count + store->assignment_subject[a]] += enrolment[c];
+        }
+
+        // Gather the assignment dimensions onto the facts, then count
+        for (int i = 0; i < n; i++) {
+            uint32_t a = store->sub_assignment[i];
+            due[i] = store->assignment_due[a];
+            keys[i] = store->assignment_class[a] * (uint32_t)store->subject_count + store->assignment_subject[a];
+        }
+        analytics_filter_range(due, n, lo, hi, mask);
+        for (int i = 0; i < n; i++) {
+            submitted[i] = mask[i] & (store->sub_status[i] != SUBMISSION_NONE);
+        }
+        analytics_count_by_key(keys, store->sub_status, mask, n, 3, status_counts);
+        analytics_count_by_key(keys, store->sub_quality, submitted, n, QUALITY_HIGH + 1, quality_counts);
+
+        rows = malloc((groups > 0 ? groups : 1) * sizeof(AnalyticsSubjectRow));
+        for (int g = 0; rows && g < groups; g++) {
+            int *status = &status_counts[g * 3];
+            int assigned = assigned_counts[g];
+            if (assigned == 0) continue;
+
+            AnalyticsSubjectRow *r = &rows[(*count)++];
+            r->class_id = store->class_ids[g / store->subject_count];
+            strcpy(r->subject, store->subjects[g % store->subject_count]);
+            r->assigned = assigned;
+            r->submitted = status[SUBMISSION_TIMELY] + status[SUBMISSION_LATE];
+            r->late = status[SUBMISSION_LATE];
+            memcpy(r->quality, &quality_counts[g * (QUALITY_HIGH + 1)], sizeof(r->quality));
+        }
+    }
+
+    free(due);
+    free(keys);
+    free(mask);
+    free(submitted);
+    free(status_counts);
+    free(quality_counts);
+    free(enrolment);
+    free(assigned_counts);
+    return rows;
+}
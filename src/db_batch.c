@@ -0,0 +1,287 @@
+#include "db_batch.h"
+#include "db_bitmap.h"
+#include "db_rollup.h"
+
+static bool exec_sql(const char *sql) {
+    char *err_msg = NULL;
+    if (sqlite3_exec(g_db, sql, NULL, NULL, &err_msg) != SQLITE_OK) {
+        fprintf(stderr, "SQL error: %s\n", err_msg);
+        sqlite3_free(err_msg);
+        return false;
+    }
+    return true;
+}
+
+bool db_begin(void) {
+    if (!g_db) return false;
+    return exec_sql("BEGIN TRANSACTION;");
+}
+
+bool db_commit(void) {
+    if (!g_db) return false;
+    return exec_sql("COMMIT;");
+}
+
+void db_rollback(void) {
+    if (g_db && !sqlite3_get_autocommit(g_db)) {
+        exec_sql("ROLLBACK;");
+    }
+}
+
+// Savepoints nest, so batches also work inside a caller's transaction
+static bool batch_begin(void) {
+    return exec_sql("SAVEPOINT db_batch;");
+}
+
+static bool batch_end(bool ok) {
+    if (ok) {
+        return exec_sql("RELEASE db_batch;");
+    }
+    exec_sql("ROLLBACK TO db_batch;");
+    exec_sql("RELEASE db_batch;");
+    return false;
+}
+
+int db_mark_attendance_batch(time_t date, const AttendanceEntry *entries, int count) {
+    if (!g_db || (!entries && count > 0) || count < 0) return -1;
+    if (count == 0) return 0;
+
+    const char *sql = "INSERT OR REPLACE INTO attendance (student_id, date, status, notes) "
+                     "VALUES (?, date(?, 'unixepoch'), ?, ?);";
+    // Same rule as db_mark_attendance: explicit rows make a full day
+    const char *session_sql = "INSERT OR IGNORE INTO attendance_sessions (class_id, date, sparse) "
+                             "SELECT class_id, date(?, 'unixepoch'), 0 FROM students "
+                             "WHERE id = ? AND class_id IS NOT NULL;";
+    sqlite3_stmt *stmt;
+    sqlite3_stmt *session_stmt;
+
+    if (!batch_begin()) return -1;
+
+    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+        batch_end(false);
+        return -1;
+    }
+    if (sqlite3_prepare_v2(g_db, session_sql, -1, &session_stmt, NULL) != SQLITE_OK) {
+        sqlite3_finalize(stmt);
+        batch_end(false);
+        return -1;
+    }
+
+    int term;
+    int day = bitmap_day_from_time(date, &term);
+    char day_text[11];
+    db_rollup_date(date, day_text, sizeof(day_text));
+    BitmapWriter bitmaps;
+    RollupWriter rollups;
+    if (!db_bitmap_writer_open(&bitmaps)) {
+        sqlite3_finalize(stmt);
+        sqlite3_finalize(session_stmt);
+        batch_end(false);
+        return -1;
+    }
+    if (!db_rollup_writer_open(&rollups)) {
+        db_bitmap_writer_close(&bitmaps);
+        sqlite3_finalize(stmt);
+        sqlite3_finalize(session_stmt);
+        batch_end(false);
+        return -1;
+    }
+
+    int saved = 0;
+    bool ok = true;
+    for (int i = 0; i < count; i++) {
+        int class_id, old_status;
+        if (!db_rollup_writer_lookup(&rollups, entries[i].student_id, day_text, &class_id, &old_status)) {
+            class_id = 0;
+            old_status = -1;
+        }
+
+        sqlite3_bind_int(stmt, 1, entries[i].student_id);
+        sqlite3_bind_int64(stmt, 2, (sqlite3_int64)date);
+        sqlite3_bind_int(stmt, 3, (int)entries[i].status);
+        sqlite3_bind_text(stmt, 4, entries[i].notes ? entries[i].notes : "", -1, SQLITE_STATIC);
+        sqlite3_bind_int64(session_stmt, 1, (sqlite3_int64)date);
+        sqlite3_bind_int(session_stmt, 2, entries[i].student_id);
+
+        if (sqlite3_step(stmt) != SQLITE_DONE || sqlite3_step(session_stmt) != SQLITE_DONE ||
+            !db_bitmap_writer_set(&bitmaps, entries[i].student_id, term, day, (int)entries[i].status) ||
+            !db_rollup_writer_move(&rollups, class_id, entries[i].student_id, day_text,
+                                   old_status, (int)entries[i].status)) {
+            fprintf(stderr, "Failed to save attendance for student %d: %s\n",
+                    entries[i].student_id, sqlite3_errmsg(g_db));
+            ok = false;
+            break;
+        }
+        sqlite3_reset(stmt);
+        sqlite3_reset(session_stmt);
+        saved++;
+    }
+
+    ok = ok && db_rollup_writer_flush(&rollups);
+    db_rollup_writer_close(&rollups);
+    db_bitmap_writer_close(&bitmaps);
+    sqlite3_finalize(stmt);
+    sqlite3_finalize(session_stmt);
+    return batch_end(ok) ? saved : -1;
+}
+
+// Create the class's session row for the date (in the class's current mode)
+// if needed, and report whether that day is sparse and whether it is new
+static bool open_session(int class_id, time_t date, bool *sparse, bool *created) {
+    const char *insert_sql = "INSERT OR IGNORE INTO attendance_sessions (class_id, date, sparse) "
+                            "SELECT id, date(?, 'unixepoch'), attendance_mode FROM classes WHERE id = ?;";
+    const char *select_sql = "SELECT sparse FROM attendance_sessions "
+                            "WHERE class_id = ? AND date = date(?, 'unixepoch');";
+    sqlite3_stmt *stmt;
+
+    if (sqlite3_prepare_v2(g_db, insert_sql, -1, &stmt, NULL) != SQLITE_OK) return false;
+    sqlite3_bind_int64(stmt, 1, (sqlite3_int64)date);
+    sqlite3_bind_int(stmt, 2, class_id);
+    int rc = sqlite3_step(stmt);
+    *created = sqlite3_changes(g_db) > 0;
+    sqlite3_finalize(stmt);
+    if (rc != SQLITE_DONE) return false;
+
+    if (sqlite3_prepare_v2(g_db, select_sql, -1, &stmt, NULL) != SQLITE_OK) return false;
+    sqlite3_bind_int(stmt, 1, class_id);
+    sqlite3_bind_int64(stmt, 2, (sqlite3_int64)date);
+    bool found = sqlite3_step(stmt) == SQLITE_ROW;
+    if (found) {
+        *sparse = sqlite3_column_int(stmt, 0) == 1;
+    }
+    sqlite3_finalize(stmt);
+    return found;
+}
+
+int db_save_attendance_day(int class_id, time_t date, const AttendanceEntry *entries, int count) {
+    if (!g_db || class_id <= 0 || (!entries && count > 0) || count < 0) return -1;
+
+    const char *upsert_sql = "INSERT OR REPLACE INTO attendance (student_id, date, status, notes) "
+                            "VALUES (?, date(?, 'unixepoch'), ?, ?);";
+    const char *delete_sql = "DELETE FROM attendance WHERE student_id = ? AND date = date(?, 'unixepoch');";
+    sqlite3_stmt *upsert_stmt;
+    sqlite3_stmt *delete_stmt;
+    bool sparse = false;
+    bool created = false;
+    char day_text[11];
+    db_rollup_date(date, day_text, sizeof(day_text));
+
+    if (!batch_begin()) return -1;
+
+    // A new sparse day starts with everyone present
+    if (!open_session(class_id, date, &sparse, &created) ||
+        (created && sparse && !db_rollup_open_sparse_day(class_id, day_text))) {
+        fprintf(stderr, "Failed to open attendance session for class %d: %s\n",
+                class_id, sqlite3_errmsg(g_db));
+        batch_end(false);
+        return -1;
+    }
+
+    if (sqlite3_prepare_v2(g_db, upsert_sql, -1, &upsert_stmt, NULL) != SQLITE_OK) {
+        batch_end(false);
+        return -1;
+    }
+    if (sqlite3_prepare_v2(g_db, delete_sql, -1, &delete_stmt, NULL) != SQLITE_OK) {
+        sqlite3_finalize(upsert_stmt);
+        batch_end(false);
+        return -1;
+    }
+
+    int term;
+    int day = bitmap_day_from_time(date, &term);
+    BitmapWriter bitmaps;
+    RollupWriter rollups;
+    if (!db_bitmap_writer_open(&bitmaps)) {
+        sqlite3_finalize(upsert_stmt);
+        sqlite3_finalize(delete_stmt);
+        batch_end(false);
+        return -1;
+    }
+    if (!db_rollup_writer_open(&rollups)) {
+        db_bitmap_writer_close(&bitmaps);
+        sqlite3_finalize(upsert_stmt);
+        sqlite3_finalize(delete_stmt);
+        batch_end(false);
+        return -1;
+    }
+
+    int saved = 0;
+    bool ok = true;
+    for (int i = 0; i < count; i++) {
+        int student_class, old_status;
+        if (!db_rollup_writer_lookup(&rollups, entries[i].student_id, day_text, &student_class, &old_status)) {
+            student_class = 0;
+            old_status = -1;
+        }
+
+        const char *notes = entries[i].notes ? entries[i].notes : "";
+        bool implied = sparse && entries[i].status == ATTENDANCE_PRESENT && notes[0] == '\0';
+        sqlite3_stmt *stmt = implied ? delete_stmt : upsert_stmt;
+
+        sqlite3_bind_int(stmt, 1, entries[i].student_id);
+        sqlite3_bind_int64(stmt, 2, (sqlite3_int64)date);
+        if (!implied) {
+            sqlite3_bind_int(stmt, 3, (int)entries[i].status);
+            sqlite3_bind_text(stmt, 4, notes, -1, SQLITE_STATIC);
+        }
+
+        // The index mirrors stored rows, so an implied present clears the day
+        if (sqlite3_step(stmt) != SQLITE_DONE ||
+            !db_bitmap_writer_set(&bitmaps, entries[i].student_id, term, day,
+                                  implied ? -1 : (int)entries[i].status) ||
+            !db_rollup_writer_move(&rollups, student_class, entries[i].student_id, day_text,
+                                   old_status, (int)entries[i].status)) {
+            fprintf(stderr, "Failed to save attendance for student %d: %s\n",
+                    entries[i].student_id, sqlite3_errmsg(g_db));
+            ok = false;
+            break;
+        }
+        sqlite3_reset(stmt);
+        saved++;
+    }
+
+    ok = ok && db_rollup_writer_flush(&rollups);
+    db_rollup_writer_close(&rollups);
+    db_bitmap_writer_close(&bitmaps);
+    sqlite3_finalize(upsert_stmt);
+    sqlite3_finalize(delete_stmt);
+    return batch_end(ok) ? saved : -1;
+}
+
+int db_save_submissions_batch(int assignment_id, const SubmissionEntry *entries, int count) {
+    if (!g_db || (!entries && count > 0) || count < 0) return -1;
+    if (count == 0) return 0;
+
+    const char *sql = "INSERT OR REPLACE INTO assignment_submissions (assignment_id, student_id, status, quality, submitted_at, notes) "
+                     "VALUES (?, ?, ?, ?, datetime('now'), ?);";
+    sqlite3_stmt *stmt;
+
+    if (!batch_begin()) return -1;
+
+    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+        batch_end(false);
+        return -1;
+    }
+
+    int saved = 0;
+    bool ok = true;
+    for (int i = 0; i < count; i++) {
+        sqlite3_bind_int(stmt, 1, assignment_id);
+        sqlite3_bind_int(stmt, 2, entries[i].student_id);
+        sqlite3_bind_int(stmt, 3, (int)entries[i].status);
+        sqlite3_bind_int(stmt, 4, (int)entries[i].quality);
+        sqlite3_bind_text(stmt, 5, entries[i].notes ? entries[i].notes : "", -1, SQLITE_STATIC);
+
+        if (sqlite3_step(stmt) != SQLITE_DONE) {
+            fprintf(stderr, "Failed to save submission for student %d: %s\n",
+                    entries[i].student_id, sqlite3_errmsg(g_db));
+            ok = false;
+            break;
+        }
+        sqlite3_reset(stmt);
+        saved++;
+    }
+
+    sqlite3_finalize(stmt);
+    return batch_end(ok) ? saved : -1;
+}
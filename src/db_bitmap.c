@@ -0,0 +1,706 @@
+#include "db_bitmap.h"
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+#define BITMAP_BLOB_SIZE (BITMAP_PLANES * BITMAP_WORDS * 8)
+
+// Days and terms
+
+static bool is_leap_year(int year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+static int day_of_year(int year, int month, int day) {
+    static const int days_before[12] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
+    if (month < 1 || month > 12 || day < 1 || day > 31) return -1;
+    return days_before[month - 1] + (month > 2 && is_leap_year(year) ? 1 : 0) + day - 1;
+}
+
+int bitmap_day_from_date(const char *date, int *term) {
+    int year, month, day;
+    if (!date || sscanf(date, "%d-%d-%d", &year, &month, &day) != 3) return -1;
+
+    int index = day_of_year(year, month, day);
+    if (index >= 0 && term) *term = year;
+    return index;
+}
+
+int bitmap_day_from_time(time_t t, int *term) {
+    // UTC civil date from days since the epoch, like SQLite's 'unixepoch'
+    long long days = (long long)t / 86400;
+    if ((long long)t % 86400 < 0) days--;
+    days += 719468;
+
+    long long era = (days >= 0 ? days : days - 146096) / 146097;
+    long long doe = days - era * 146097;
+    long long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    long long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    long long mp = (5 * doy + 2) / 153;
+    int day = (int)(doy - (153 * mp + 2) / 5 + 1);
+    int month = (int)(mp < 10 ? mp + 3 : mp - 9);
+    int year = (int)(yoe + era * 400 + (month <= 2 ? 1 : 0));
+
+    int index = day_of_year(year, month, day);
+    if (index >= 0 && term) *term = year;
+    return index;
+}
+
+// Kernels
+
+static inline int popcount64(uint64_t x) {
+#if defined(__GNUC__)
+    return __builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (int)((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+static inline int ctz64(uint64_t x) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(x);
+#else
+    int n = 0;
+    while (!(x & 1)) {
+        x >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+static inline uint64_t pext64(uint64_t src, uint64_t mask) {
+#if defined(__BMI2__)
+    return _pext_u64(src, mask);
+#else
+    uint64_t out = 0;
+    for (int k = 0; mask; k++) {
+        if (src & mask & -mask) out |= 1ULL << k;
+        mask &= mask - 1;
+    }
+    return out;
+#endif
+}
+
+int bitmap_popcount(const uint64_t *bits) {
+    int n = 0;
+    for (int w = 0; w < BITMAP_WORDS; w++) {
+        n += popcount64(bits[w]);
+    }
+    return n;
+}
+
+void bitmap_range_mask(uint64_t *mask, int first_day, int last_day) {
+    if (first_day < 0) first_day = 0;
+    if (last_day > BITMAP_DAYS - 1) last_day = BITMAP_DAYS - 1;
+
+    for (int w = 0; w < BITMAP_WORDS; w++) {
+        int lo = w * 64;
+        int hi = lo + 63;
+        if (first_day > last_day || hi < first_day || lo > last_day) {
+            mask[w] = 0;
+            continue;
+        }
+        uint64_t m = ~0ULL;
+        if (first_day > lo) m &= ~0ULL << (first_day - lo);
+        if (last_day < hi) m &= ~0ULL >> (hi - last_day);
+        mask[w] = m;
+    }
+}
+
+int bitmap_compress(const uint64_t *src, const uint64_t *mask, uint64_t *out) {
+    int n = 0;
+    memset(out, 0, BITMAP_WORDS * sizeof(uint64_t));
+
+    for (int w = 0; w < BITMAP_WORDS; w++) {
+        if (!mask[w]) continue;
+
+        uint64_t packed = pext64(src[w], mask[w]);
+        int width = popcount64(mask[w]);
+        int shift = n % 64;
+
+        out[n / 64] |= packed << shift;
+        if (shift > 0 && width > 64 - shift) {
+            out[n / 64 + 1] |= packed >> (64 - shift);
+        }
+        n += width;
+    }
+    return n;
+}
+
+void bitmap_runs(const uint64_t *bits, int nbits, int *current, int *longest) {
+    for (int w = 0; w * 64 < nbits; w++) {
+        int width = nbits - w * 64 < 64 ? nbits - w * 64 : 64;
+        uint64_t x = bits[w];
+        int pos = 0;
+
+        while (pos < width) {
+            uint64_t rest = x >> pos;
+            if (rest & 1) {
+                int len = ~rest ? ctz64(~rest) : 64;
+                if (len > width - pos) len = width - pos;
+                *current += len;
+                if (*current > *longest) *longest = *current;
+                pos += len;
+            } else {
+                *current = 0;
+                if (!rest) break;
+                pos += ctz64(rest);
+            }
+        }
+    }
+}
+
+// Blob storage: the planes as little-endian 64-bit words
+
+static void bits_decode(const void *blob, int size, AttendanceBits *out) {
+    const unsigned char *bytes = blob;
+    memset(out, 0, sizeof(*out));
+    if (!bytes || size != BITMAP_BLOB_SIZE) return;
+
+    for (int p = 0; p < BITMAP_PLANES; p++) {
+        for (int w = 0; w < BITMAP_WORDS; w++) {
+            uint64_t v = 0;
+            for (int b = 0; b < 8; b++) {
+                v |= (uint64_t)bytes[(p * BITMAP_WORDS + w) * 8 + b] << (8 * b);
+            }
+            out->plane[p][w] = v;
+        }
+    }
+}
+
+static void bits_encode(const AttendanceBits *in, unsigned char *blob) {
+    for (int p = 0; p < BITMAP_PLANES; p++) {
+        for (int w = 0; w < BITMAP_WORDS; w++) {
+            for (int b = 0; b < 8; b++) {
+                blob[(p * BITMAP_WORDS + w) * 8 + b] = (unsigned char)(in->plane[p][w] >> (8 * b));
+            }
+        }
+    }
+}
+
+static bool bits_empty(const AttendanceBits *bits) {
+    for (int p = 0; p < BITMAP_PLANES; p++) {
+        for (int w = 0; w < BITMAP_WORDS; w++) {
+            if (bits->plane[p][w]) return false;
+        }
+    }
+    return true;
+}
+
+static bool bits_store(BitmapWriter *writer, int student_id, int term, const AttendanceBits *bits) {
+    sqlite3_stmt *stmt = bits_empty(bits) ? writer->remove : writer->upsert;
+    unsigned char blob[BITMAP_BLOB_SIZE];
+
+    sqlite3_bind_int(stmt, 1, student_id);
+    sqlite3_bind_int(stmt, 2, term);
+    if (stmt == writer->upsert) {
+        bits_encode(bits, blob);
+        sqlite3_bind_blob(stmt, 3, blob, sizeof(blob), SQLITE_TRANSIENT);
+    }
+
+    int rc = sqlite3_step(stmt);
+    sqlite3_reset(stmt);
+    return rc == SQLITE_DONE;
+}
+
+// Index maintenance
+
+bool db_bitmap_writer_open(BitmapWriter *writer) {
+    if (!writer) return false;
+    memset(writer, 0, sizeof(*writer));
+    if (!g_db) return false;
+
+    const char *select_sql = "SELECT bits FROM attendance_bitmaps WHERE student_id = ? AND term = ?;";
+    const char *upsert_sql = "INSERT OR REPLACE INTO attendance_bitmaps (student_id, term, bits) "
+                            "VALUES (?, ?, ?);";
+    const char *remove_sql = "DELETE FROM attendance_bitmaps WHERE student_id = ? AND term = ?;";
+
+    if (sqlite3_prepare_v2(g_db, select_sql, -1, &writer->select, NULL) != SQLITE_OK ||
+        sqlite3_prepare_v2(g_db, upsert_sql, -1, &writer->upsert, NULL) != SQLITE_OK ||
+        sqlite3_prepare_v2(g_db, remove_sql, -1, &writer->remove, NULL) != SQLITE_OK) {
+        db_bitmap_writer_close(writer);
+        return false;
+    }
+    return true;
+}
+
+static void bits_load(BitmapWriter *writer, int student_id, int term, AttendanceBits *bits) {
+    sqlite3_bind_int(writer->select, 1, student_id);
+    sqlite3_bind_int(writer->select, 2, term);
+    if (sqlite3_step(writer->select) == SQLITE_ROW) {
+        bits_decode(sqlite3_column_blob(writer->select, 0),
+                    sqlite3_column_bytes(writer->select, 0), bits);
+    } else {
+        memset(bits, 0, sizeof(*bits));
+    }
+    sqlite3_reset(writer->select);
+}
+
+bool db_bitmap_writer_set(BitmapWriter *writer, int student_id, int term, int day, int status) {
+    if (!writer || !writer->select || day < 0 || day >= BITMAP_DAYS) return false;
+
+    AttendanceBits bits;
+    bits_load(writer, student_id, term, &bits);
+
+    uint64_t bit = 1ULL << (day % 64);
+    for (int p = 0; p < BITMAP_PLANES; p++) {
+        bits.plane[p][day / 64] &= ~bit;
+    }
+    if (status >= 0 && status < BITMAP_PLANES) {
+        bits.plane[status][day / 64] |= bit;
+    }
+
+    return bits_store(writer, student_id, term, &bits);
+}
+
+void db_bitmap_writer_close(BitmapWriter *writer) {
+    if (!writer) return;
+    sqlite3_finalize(writer->select);
+    sqlite3_finalize(writer->upsert);
+    sqlite3_finalize(writer->remove);
+    memset(writer, 0, sizeof(*writer));
+}
+
+bool db_bitmap_update_class_days(int class_id) {
+    if (!g_db) return false;
+
+    // Every student of the class on every bulk date, with the status stored
+    // now (NULL when none); students in idx_students_class_roll order and
+    // each student's dates in order, so no sort is needed
+    const char *sql = "SELECT s.id, d.date, a.status FROM students s "
+                     "CROSS JOIN temp.bulk_dates d "
+                     "LEFT JOIN attendance a ON a.student_id = s.id AND a.date = d.date "
+                     "WHERE s.class_id = ? ORDER BY s.roll_number, s.id, d.date;";
+    sqlite3_stmt *stmt;
+    BitmapWriter writer;
+
+    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) return false;
+    if (!db_bitmap_writer_open(&writer)) {
+        sqlite3_finalize(stmt);
+        return false;
+    }
+
+    sqlite3_bind_int(stmt, 1, class_id);
+
+    // One read and one write per student and term touched
+    AttendanceBits bits;
+    int student_id = 0;
+    int term = 0;
+    bool pending = false;
+    bool ok = true;
+
+    while (ok && sqlite3_step(stmt) == SQLITE_ROW) {
+        int row_student = sqlite3_column_int(stmt, 0);
+        int row_term;
+        int day = bitmap_day_from_date((const char *)sqlite3_column_text(stmt, 1), &row_term);
+        if (day < 0) continue;
+
+        if (pending && (row_student != student_id || row_term != term)) {
+            ok = bits_store(&writer, student_id, term, &bits);
+            pending = false;
+        }
+        if (!pending) {
+            student_id = row_student;
+            term = row_term;
+            bits_load(&writer, student_id, term, &bits);
+            pending = true;
+        }
+
+        uint64_t bit = 1ULL << (day % 64);
+        for (int p = 0; p < BITMAP_PLANES; p++) {
+            bits.plane[p][day / 64] &= ~bit;
+        }
+        if (sqlite3_column_type(stmt, 2) != SQLITE_NULL) {
+            int status = sqlite3_column_int(stmt, 2);
+            if (status >= 0 && status < BITMAP_PLANES) {
+                bits.plane[status][day / 64] |= bit;
+            }
+        }
+    }
+    if (ok && pending) {
+        ok = bits_store(&writer, student_id, term, &bits);
+    }
+
+    db_bitmap_writer_close(&writer);
+    sqlite3_finalize(stmt);
+    return ok;
+}
+
+bool db_bitmap_rebuild(void) {
+    if (!g_db) return false;
+
+    // Primary key order: one student and term at a time
+    const char *sql = "SELECT student_id, date, status FROM attendance ORDER BY student_id, date;";
+    sqlite3_stmt *stmt;
+    BitmapWriter writer;
+
+    if (sqlite3_exec(g_db, "DELETE FROM attendance_bitmaps;", NULL, NULL, NULL) != SQLITE_OK) return false;
+    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) return false;
+    if (!db_bitmap_writer_open(&writer)) {
+        sqlite3_finalize(stmt);
+        return false;
+    }
+
+    AttendanceBits bits;
+    int student_id = 0;
+    int term = 0;
+    bool pending = false;
+    bool ok = true;
+
+    while (ok && sqlite3_step(stmt) == SQLITE_ROW) {
+        int row_student = sqlite3_column_int(stmt, 0);
+        int row_term;
+        int day = bitmap_day_from_date((const char *)sqlite3_column_text(stmt, 1), &row_term);
+        int status = sqlite3_column_int(stmt, 2);
+        if (day < 0 || status < 0 || status >= BITMAP_PLANES) continue;
+
+        if (pending && (row_student != student_id || row_term != term)) {
+            ok = bits_store(&writer, student_id, term, &bits);
+            pending = false;
+        }
+        if (!pending) {
+            memset(&bits, 0, sizeof(bits));
+            student_id = row_student;
+            term = row_term;
+            pending = true;
+        }
+        bits.plane[status][day / 64] |= 1ULL << (day % 64);
+    }
+    if (ok && pending) {
+        ok = bits_store(&writer, student_id, term, &bits);
+    }
+
+    db_bitmap_writer_close(&writer);
+    sqlite3_finalize(stmt);
+    return ok;
+}
+
+// Reports
+
+// A class's recorded days in one term, and the report range within it
+typedef struct {
+    int term;
+    uint64_t days[BITMAP_WORDS];
+    uint64_t sparse[BITMAP_WORDS];
+} ClassTerm;
+
+typedef struct {
+    int from_term, from_day;
+    int to_term, to_day;
+} DayRange;
+
+static void range_mask_for_term(const DayRange *range, int term, uint64_t *mask) {
+    if (term < range->from_term || term > range->to_term) {
+        memset(mask, 0, BITMAP_WORDS * sizeof(uint64_t));
+        return;
+    }
+    bitmap_range_mask(mask, term == range->from_term ? range->from_day : 0,
+                      term == range->to_term ? range->to_day : BITMAP_DAYS - 1);
+}
+
+static bool parse_range(const char *from, const char *to, DayRange *range) {
+    range->from_term = -1;
+    range->from_day = 0;
+    range->to_term = 1 << 30;
+    range->to_day = BITMAP_DAYS - 1;
+
+    if (from && from[0] && (range->from_day = bitmap_day_from_date(from, &range->from_term)) < 0) {
+        return false;
+    }
+    if (to && to[0] && (range->to_day = bitmap_day_from_date(to, &range->to_term)) < 0) {
+        return false;
+    }
+    return true;
+}
+
+// Session days of the class, one entry per term in ascending order
+static ClassTerm* load_class_terms(int class_id, int *count) {
+    const char *sql = "SELECT date, sparse FROM attendance_sessions WHERE class_id = ? ORDER BY date;";
+    sqlite3_stmt *stmt;
+
+    *count = 0;
+    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) return NULL;
+
+    sqlite3_bind_int(stmt, 1, class_id);
+
+    int capacity = 4;
+    ClassTerm *terms = malloc(capacity * sizeof(ClassTerm));
+    if (!terms) {
+        sqlite3_finalize(stmt);
+        return NULL;
+    }
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        int term;
+        int day = bitmap_day_from_date((const char *)sqlite3_column_text(stmt, 0), &term);
+        if (day < 0) continue;
+
+        if (*count == 0 || terms[*count - 1].term != term) {
+            if (*count >= capacity) {
+                capacity *= 2;
+                ClassTerm *grown = realloc(terms, capacity * sizeof(ClassTerm));
+                if (!grown) break;
+                terms = grown;
+            }
+            memset(&terms[*count], 0, sizeof(ClassTerm));
+            terms[*count].term = term;
+            (*count)++;
+        }
+
+        ClassTerm *t = &terms[*count - 1];
+        uint64_t bit = 1ULL << (day % 64);
+        t->days[day / 64] |= bit;
+        if (sqlite3_column_int(stmt, 1) == 1) {
+            t->sparse[day / 64] |= bit;
+        }
+    }
+
+    sqlite3_finalize(stmt);
+    return terms;
+}
+
+typedef struct {
+    int present;
+    int absent;
+    int late;
+    int longest_absent;
+} BitmapTally;
+
+// Add one term of a student to the tally. bits may be NULL (no explicit rows)
+// and class_term NULL (the class recorded nothing that term).
+static void tally_term(BitmapTally *tally, int *absent_run, const AttendanceBits *bits,
+                       const ClassTerm *class_term, const uint64_t *range) {
+    static const AttendanceBits no_bits;
+    if (!bits) bits = &no_bits;
+
+    const uint64_t *present = bits->plane[ATTENDANCE_PRESENT];
+    const uint64_t *absent = bits->plane[ATTENDANCE_ABSENT];
+    const uint64_t *late = bits->plane[ATTENDANCE_LATE];
+    uint64_t p[BITMAP_WORDS], a[BITMAP_WORDS], l[BITMAP_WORDS], days[BITMAP_WORDS];
+
+    for (int w = 0; w < BITMAP_WORDS; w++) {
+        uint64_t recorded = present[w] | absent[w] | late[w];
+        uint64_t implied = class_term ? class_term->sparse[w] & ~recorded : 0;
+        p[w] = (present[w] | implied) & range[w];
+        a[w] = absent[w] & range[w];
+        l[w] = late[w] & range[w];
+        days[w] = ((class_term ? class_term->days[w] : 0) | recorded) & range[w];
+    }
+
+    tally->present += bitmap_popcount(p);
+    tally->absent += bitmap_popcount(a);
+    tally->late += bitmap_popcount(l);
+
+    // Consecutive over the days the class met, so weekends don't break a run
+    uint64_t packed[BITMAP_WORDS];
+    int n = bitmap_compress(a, days, packed);
+    bitmap_runs(packed, n, absent_run, &tally->longest_absent);
+}
+
+// Merge a student's term rows with the class terms in term order
+static void tally_student(BitmapTally *tally, const int *row_terms, const AttendanceBits *rows, int row_count,
+                          const ClassTerm *terms, int term_count, const DayRange *range) {
+    int absent_run = 0;
+    int r = 0, t = 0;
+    memset(tally, 0, sizeof(*tally));
+
+    while (r < row_count || t < term_count) {
+        int term;
+        const AttendanceBits *bits = NULL;
+        const ClassTerm *class_term = NULL;
+
+        if (t >= term_count || (r < row_count && row_terms[r] < terms[t].term)) {
+            term = row_terms[r];
+            bits = &rows[r++];
+        } else if (r >= row_count || terms[t].term < row_terms[r]) {
+            term = terms[t].term;
+            class_term = &terms[t++];
+        } else {
+            term = terms[t].term;
+            bits = &rows[r++];
+            class_term = &terms[t++];
+        }
+
+        uint64_t mask[BITMAP_WORDS];
+        range_mask_for_term(range, term, mask);
+        tally_term(tally, &absent_run, bits, class_term, mask);
+    }
+}
+
+#define MAX_STUDENT_TERMS 64
+
+// A student has a handful of terms; insertion sort keeps the SQL free of a
+// second ORDER BY key
+static void sort_terms(int *terms, AttendanceBits *rows, int count) {
+    for (int i = 1; i < count; i++) {
+        int term = terms[i];
+        AttendanceBits bits = rows[i];
+        int j = i - 1;
+        while (j >= 0 && terms[j] > term) {
+            terms[j + 1] = terms[j];
+            rows[j + 1] = rows[j];
+            j--;
+        }
+        terms[j + 1] = term;
+        rows[j + 1] = bits;
+    }
+}
+
+AttendanceSummary** db_get_attendance_summary_range(int class_id, const char *from, const char *to, int *count) {
+    if (!g_db || !count) return NULL;
+    *count = 0;
+
+    DayRange range;
+    if (!parse_range(from, to, &range)) return NULL;
+
+    const char *sql = "SELECT s.id, s.name, s.roll_number, b.term, b.bits "
+                     "FROM students s "
+                     "LEFT JOIN attendance_bitmaps b ON b.student_id = s.id "
+                     "WHERE s.class_id = ? "
+                     "ORDER BY s.roll_number;";
+    sqlite3_stmt *stmt;
+
+    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+        return NULL;
+    }
+
+    int term_count;
+    ClassTerm *terms = load_class_terms(class_id, &term_count);
+    if (!terms) {
+        sqlite3_finalize(stmt);
+        return NULL;
+    }
+
+    sqlite3_bind_int(stmt, 1, class_id);
+
+    int capacity = 10;
+    AttendanceSummary **result = malloc(capacity * sizeof(AttendanceSummary*));
+    if (!result) {
+        free(terms);
+        sqlite3_finalize(stmt);
+        return NULL;
+    }
+
+    int row_terms[MAX_STUDENT_TERMS];
+    AttendanceBits *rows = malloc(MAX_STUDENT_TERMS * sizeof(AttendanceBits));
+    int row_count = 0;
+    AttendanceSummary *current = NULL;
+    bool ok = rows != NULL;
+
+    // One row per student and term; finish a student when the next starts
+    int rc;
+    while (ok) {
+        rc = sqlite3_step(stmt);
+        int student_id = rc == SQLITE_ROW ? sqlite3_column_int(stmt, 0) : 0;
+
+        if (current && (rc != SQLITE_ROW || student_id != current->student_id)) {
+            sort_terms(row_terms, rows, row_count);
+            BitmapTally tally;
+            tally_student(&tally, row_terms, rows, row_count, terms, term_count, &range);
+            current->present = tally.present;
+            current->absent = tally.absent;
+            current->late = tally.late;
+            current->total_days = tally.present + tally.absent + tally.late;
+            current->longest_absent_streak = tally.longest_absent;
+            current = NULL;
+            row_count = 0;
+        }
+        if (rc != SQLITE_ROW) break;
+
+        if (!current) {
+            if (*count >= capacity) {
+                capacity *= 2;
+                AttendanceSummary **grown = realloc(result, capacity * sizeof(AttendanceSummary*));
+                if (!grown) {
+                    ok = false;
+                    break;
+                }
+                result = grown;
+            }
+
+            current = calloc(1, sizeof(AttendanceSummary));
+            if (!current) {
+                ok = false;
+                break;
+            }
+            current->student_id = student_id;
+            strncpy(current->name, (const char *)sqlite3_column_text(stmt, 1), MAX_NAME_LENGTH - 1);
+            strncpy(current->roll_number, (const char *)sqlite3_column_text(stmt, 2), 49);
+            result[(*count)++] = current;
+        }
+
+        if (sqlite3_column_type(stmt, 3) != SQLITE_NULL && row_count < MAX_STUDENT_TERMS) {
+            row_terms[row_count] = sqlite3_column_int(stmt, 3);
+            bits_decode(sqlite3_column_blob(stmt, 4), sqlite3_column_bytes(stmt, 4), &rows[row_count]);
+            row_count++;
+        }
+    }
+
+    free(rows);
+    free(terms);
+    sqlite3_finalize(stmt);
+
+    if (!ok) {
+        db_free_attendance_summary(result, *count);
+        *count = 0;
+        return NULL;
+    }
+    return result;
+}
+
+bool db_bitmap_student_stats(int student_id, const char *from, const char *to,
+                             int *total, int *present, int *absent, int *late, int *longest_absent) {
+    if (!g_db) return false;
+
+    DayRange range;
+    if (!parse_range(from, to, &range)) return false;
+
+    const char *sql = "SELECT term, bits FROM attendance_bitmaps WHERE student_id = ? ORDER BY term;";
+    const char *class_sql = "SELECT class_id FROM students WHERE id = ?;";
+    sqlite3_stmt *stmt;
+    int class_id = 0;
+
+    if (sqlite3_prepare_v2(g_db, class_sql, -1, &stmt, NULL) != SQLITE_OK) return false;
+    sqlite3_bind_int(stmt, 1, student_id);
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        class_id = sqlite3_column_int(stmt, 0);
+    }
+    sqlite3_finalize(stmt);
+
+    int term_count = 0;
+    ClassTerm *terms = class_id > 0 ? load_class_terms(class_id, &term_count) : NULL;
+
+    int row_terms[MAX_STUDENT_TERMS];
+    AttendanceBits *rows = malloc(MAX_STUDENT_TERMS * sizeof(AttendanceBits));
+    int row_count = 0;
+
+    if (!rows || sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+        free(rows);
+        free(terms);
+        return false;
+    }
+    sqlite3_bind_int(stmt, 1, student_id);
+    while (row_count < MAX_STUDENT_TERMS && sqlite3_step(stmt) == SQLITE_ROW) {
+        row_terms[row_count] = sqlite3_column_int(stmt, 0);
+        bits_decode(sqlite3_column_blob(stmt, 1), sqlite3_column_bytes(stmt, 1), &rows[row_count]);
+        row_count++;
+    }
+    sqlite3_finalize(stmt);
+
+    BitmapTally tally;
+    tally_student(&tally, row_terms, rows, row_count, terms, term_count, &range);
+    free(rows);
+    free(terms);
+
+    *present = tally.present;
+    *absent = tally.absent;
+    *late = tally.late;
+    *total = tally.present + tally.absent + tally.late;
+    if (longest_absent) *longest_absent = tally.longest_absent;
+    return true;
+}
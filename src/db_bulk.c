@@ -0,0 +1,420 @@
+#include "db_bulk.h"
+#include "db_bitmap.h"
+#include "db_rollup.h"
+#include "validation.h"
+
+// TEMP tables of this connection. bulk_dates lists the days the running
+// operation touches; the journal keeps, per operation, the class's rows on
+// those days as they were before it.
+static const char *JOURNAL_SQL =
+    "CREATE TEMP TABLE IF NOT EXISTS bulk_dates (date TEXT PRIMARY KEY) WITHOUT ROWID;"
+    "CREATE TEMP TABLE IF NOT EXISTS bulk_ops ("
+    "op INTEGER PRIMARY KEY, class_id INTEGER NOT NULL, label TEXT NOT NULL);"
+    "CREATE TEMP TABLE IF NOT EXISTS bulk_journal_dates ("
+    "op INTEGER NOT NULL, date TEXT NOT NULL, PRIMARY KEY (op, date)) WITHOUT ROWID;"
+    "CREATE TEMP TABLE IF NOT EXISTS bulk_journal_attendance ("
+    "op INTEGER NOT NULL, student_id INTEGER NOT NULL, date TEXT NOT NULL, "
+    "status INTEGER NOT NULL, notes TEXT, PRIMARY KEY (op, student_id, date)) WITHOUT ROWID;"
+    "CREATE TEMP TABLE IF NOT EXISTS bulk_journal_sessions ("
+    "op INTEGER NOT NULL, date TEXT NOT NULL, sparse INTEGER NOT NULL, "
+    "PRIMARY KEY (op, date)) WITHOUT ROWID;"
+    "CREATE TEMP TABLE IF NOT EXISTS bulk_journal_holidays ("
+    "op INTEGER NOT NULL, date TEXT NOT NULL, name TEXT, PRIMARY KEY (op, date)) WITHOUT ROWID;"
+    "DELETE FROM temp.bulk_dates;";
+
+// Every day of [?3, ?4], at most BULK_MAX_DAYS of them
+#define RANGE_DAYS_SQL \
+    "WITH RECURSIVE days(date, n) AS (SELECT ?3, 1 UNION ALL " \
+    "SELECT date(date, '+1 day'), n + 1 FROM days WHERE date < ?4 AND n < 366) "
+
+static bool exec_sql(const char *sql) {
+    char *err_msg = NULL;
+    if (sqlite3_exec(g_db, sql, NULL, NULL, &err_msg) != SQLITE_OK) {
+        fprintf(stderr, "SQL error: %s\n", err_msg);
+        sqlite3_free(err_msg);
+        return false;
+    }
+    return true;
+}
+
+// Run one statement. Parameters, where the SQL uses them: ?1 class_id,
+// ?2 n, ?3 a and ?4 b.
+static bool exec_op(const char *sql, int class_id, sqlite3_int64 n, const char *a, const char *b) {
+    sqlite3_stmt *stmt;
+    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+        fprintf(stderr, "Bulk attendance statement failed: %s\n", sqlite3_errmsg(g_db));
+        return false;
+    }
+
+    int params = sqlite3_bind_parameter_count(stmt);
+    sqlite3_bind_int(stmt, 1, class_id);
+    if (params >= 2) sqlite3_bind_int64(stmt, 2, n);
+    if (params >= 3) sqlite3_bind_text(stmt, 3, a, -1, SQLITE_STATIC);
+    if (params >= 4) sqlite3_bind_text(stmt, 4, b, -1, SQLITE_STATIC);
+
+    int rc = sqlite3_step(stmt);
+    if (rc != SQLITE_DONE && rc != SQLITE_ROW) {
+        fprintf(stderr, "Bulk attendance statement failed: %s\n", sqlite3_errmsg(g_db));
+    }
+    sqlite3_finalize(stmt);
+    return rc == SQLITE_DONE || rc == SQLITE_ROW;
+}
+
+static int count_bulk_dates(void) {
+    sqlite3_stmt *stmt;
+    int count = -1;
+    if (sqlite3_prepare_v2(g_db, "SELECT COUNT(*) FROM temp.bulk_dates;", -1, &stmt, NULL) == SQLITE_OK) {
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            count = sqlite3_column_int(stmt, 0);
+        }
+        sqlite3_finalize(stmt);
+    }
+    return count;
+}
+
+// Savepoints nest, so operations also work inside a caller's transaction
+static bool op_begin(void) {
+    if (!g_db) return false;
+    if (!exec_sql("SAVEPOINT db_bulk;")) return false;
+    if (!exec_sql(JOURNAL_SQL)) {
+        exec_sql("ROLLBACK TO db_bulk;");
+        exec_sql("RELEASE db_bulk;");
+        return false;
+    }
+    return true;
+}
+
+static int op_end(bool ok, int days) {
+    if (ok) {
+        return exec_sql("RELEASE db_bulk;") ? days : -1;
+    }
+    exec_sql("ROLLBACK TO db_bulk;");
+    exec_sql("RELEASE db_bulk;");
+    return -1;
+}
+
+// Journal the class's rows on the bulk dates under a new operation, then
+// take the days out of the rollups and clear them
+static bool journal_and_clear(int class_id, const char *label) {
+    const char *op_sql = "INSERT INTO temp.bulk_ops (class_id, label) VALUES (?1, ?3);";
+    const char *journal_sql[] = {
+        "INSERT INTO temp.bulk_journal_dates (op, date) SELECT ?2, date FROM temp.bulk_dates;",
+        "INSERT INTO temp.bulk_journal_attendance (op, student_id, date, status, notes) "
+        "SELECT ?2, a.student_id, a.date, a.status, a.notes FROM temp.bulk_dates d "
+        "INNER JOIN attendance a ON a.date = d.date "
+        "INNER JOIN students s ON s.id = a.student_id WHERE s.class_id = ?1;",
+        "INSERT INTO temp.bulk_journal_sessions (op, date, sparse) "
+        "SELECT ?2, ses.date, ses.sparse FROM temp.bulk_dates d "
+        "INNER JOIN attendance_sessions ses ON ses.class_id = ?1 AND ses.date = d.date;",
+        "INSERT INTO temp.bulk_journal_holidays (op, date, name) "
+        "SELECT ?2, h.date, h.name FROM temp.bulk_dates d "
+        "INNER JOIN class_holidays h ON h.class_id = ?1 AND h.date = d.date;",
+    };
+    const char *clear_sql[] = {
+        "DELETE FROM attendance WHERE date IN (SELECT date FROM temp.bulk_dates) "
+        "AND student_id IN (SELECT id FROM students WHERE class_id = ?1);",
+        "DELETE FROM attendance_sessions WHERE class_id = ?1 "
+        "AND date IN (SELECT date FROM temp.bulk_dates);",
+        "DELETE FROM class_holidays WHERE class_id = ?1 "
+        "AND date IN (SELECT date FROM temp.bulk_dates);",
+    };
+
+    if (!exec_op(op_sql, class_id, 0, label, NULL)) return false;
+    sqlite3_int64 op = sqlite3_last_insert_rowid(g_db);
+
+    for (size_t i = 0; i < sizeof(journal_sql) / sizeof(journal_sql[0]); i++) {
+        if (!exec_op(journal_sql[i], class_id, op, NULL, NULL)) return false;
+    }
+    if (!db_rollup_remove_class_days(class_id)) return false;
+    for (size_t i = 0; i < sizeof(clear_sql) / sizeof(clear_sql[0]); i++) {
+        if (!exec_op(clear_sql[i], class_id, 0, NULL, NULL)) return false;
+    }
+    return true;
+}
+
+// Bring the rollups and the bitmap index up to date with the new days
+static bool reindex(int class_id) {
+    return db_rollup_add_class_days(class_id) && db_bitmap_update_class_days(class_id);
+}
+
+// Both ends valid, in order and at most BULK_MAX_DAYS days apart
+static bool valid_range(const char *from, const char *to) {
+    if (!g_db || !from || !to || !validate_date(from) || !validate_date(to) || strcmp(from, to) > 0) {
+        return false;
+    }
+
+    sqlite3_stmt *stmt;
+    int days = -1;
+    if (sqlite3_prepare_v2(g_db, "SELECT julianday(?2) - julianday(?1) + 1;", -1, &stmt, NULL) == SQLITE_OK) {
+        sqlite3_bind_text(stmt, 1, from, -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 2, to, -1, SQLITE_STATIC);
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            days = sqlite3_column_int(stmt, 0);
+        }
+        sqlite3_finalize(stmt);
+    }
+    if (days > BULK_MAX_DAYS) {
+        fprintf(stderr, "Bulk attendance range %s to %s is longer than %d days\n", from, to, BULK_MAX_DAYS);
+    }
+    return days > 0 && days <= BULK_MAX_DAYS;
+}
+
+int db_bulk_delete_date(int class_id, const char *date) {
+    if (class_id <= 0 || !date || !validate_date(date)) return -1;
+    if (!op_begin()) return -1;
+
+    // Only a recorded day: a session, or rows from before sessions existed
+    const char *date_sql =
+        "INSERT INTO temp.bulk_dates (date) SELECT ?3 "
+        "WHERE EXISTS (SELECT 1 FROM attendance_sessions WHERE class_id = ?1 AND date = ?3) "
+        "OR EXISTS (SELECT 1 FROM students s INNER JOIN attendance a "
+        "ON a.student_id = s.id AND a.date = ?3 WHERE s.class_id = ?1);";
+    char label[64];
+    snprintf(label, sizeof(label), "delete %s", date);
+    bool ok = exec_op(date_sql, class_id, 0, date, NULL);
+    int days = ok ? count_bulk_dates() : -1;
+    // Nothing to delete: no journal entry, so Undo is not offered for it
+    if (days == 0) return op_end(true, 0);
+
+    ok = days > 0 && journal_and_clear(class_id, label) && reindex(class_id);
+    return op_end(ok, days);
+}
+
+int db_bulk_fill_range(int class_id, const char *from, const char *to,
+                       AttendanceStatus status, bool weekdays_only) {
+    if (class_id <= 0 || !valid_range(from, to) ||
+        status < ATTENDANCE_ABSENT || status > ATTENDANCE_LATE) {
+        return -1;
+    }
+
+    const char *dates_sql =
+        RANGE_DAYS_SQL
+        "INSERT INTO temp.bulk_dates (date) SELECT days.date FROM days "
+        "WHERE (?2 = 0 OR strftime('%w', days.date) NOT IN ('0', '6')) "
+        "AND NOT EXISTS (SELECT 1 FROM attendance_sessions ses "
+        "WHERE ses.class_id = ?1 AND ses.date = days.date) "
+        "AND NOT EXISTS (SELECT 1 FROM class_holidays h WHERE h.class_id = ?1 AND h.date = days.date);";
+    const char *session_sql = "INSERT INTO attendance_sessions (class_id, date, sparse) "
+                             "SELECT c.id, d.date, c.attendance_mode FROM classes c, temp.bulk_dates d "
+                             "WHERE c.id = ?1;";
+    const char *rows_sql = "INSERT INTO attendance (student_id, date, status, notes) "
+                          "SELECT s.id, d.date, ?2, '' FROM students s, temp.bulk_dates d "
+                          "WHERE s.class_id = ?1;";
+    // Sparse days already mean everyone was present
+    bool implied = status == ATTENDANCE_PRESENT &&
+                   db_get_attendance_mode(class_id) == ATTENDANCE_STORE_SPARSE;
+
+    if (!op_begin()) return -1;
+
+    bool ok = exec_op(dates_sql, class_id, weekdays_only ? 1 : 0, from, to);
+    int days = ok ? count_bulk_dates() : -1;
+    if (days <= 0) {
+        op_end(false, 0);
+        return days;
+    }
+
+    char label[64];
+    snprintf(label, sizeof(label), "fill %s to %s", from, to);
+    ok = journal_and_clear(class_id, label) &&
+         exec_op(session_sql, class_id, 0, NULL, NULL) &&
+         (implied || exec_op(rows_sql, class_id, status, NULL, NULL)) &&
+         reindex(class_id);
+    return op_end(ok, days);
+}
+
+int db_bulk_copy_date(int class_id, const char *from_date, const char *to_date) {
+    if (class_id <= 0 || !from_date || !to_date || !validate_date(from_date) ||
+        !validate_date(to_date) || strcmp(from_date, to_date) == 0) {
+        return -1;
+    }
+
+    const char *source_sql = "INSERT INTO temp.bulk_dates (date) SELECT ?4 FROM attendance_sessions "
+                            "WHERE class_id = ?1 AND date = ?3;";
+    const char *session_sql = "INSERT INTO attendance_sessions (class_id, date, sparse) "
+                             "SELECT class_id, ?4, sparse FROM attendance_sessions "
+                             "WHERE class_id = ?1 AND date = ?3;";
+    const char *rows_sql = "INSERT INTO attendance (student_id, date, status, notes) "
+                          "SELECT a.student_id, ?4, a.status, a.notes FROM students s "
+                          "INNER JOIN attendance a ON a.student_id = s.id AND a.date = ?3 "
+                          "WHERE s.class_id = ?1;";
+
+    if (!op_begin()) return -1;
+
+    // Nothing to copy when the class has no record of from_date
+    bool ok = exec_op(source_sql, class_id, 0, from_date, to_date);
+    int days = ok ? count_bulk_dates() : -1;
+    if (days <= 0) {
+        op_end(false, 0);
+        return days;
+    }
+
+    char label[64];
+    snprintf(label, sizeof(label), "copy %s to %s", from_date, to_date);
+    ok = journal_and_clear(class_id, label) &&
+         exec_op(session_sql, class_id, 0, from_date, to_date) &&
+         exec_op(rows_sql, class_id, 0, from_date, to_date) &&
+         reindex(class_id);
+    return op_end(ok, days);
+}
+
+int db_bulk_mark_holiday(int class_id, const char *from, const char *to, const char *name) {
+    if (class_id <= 0 || !valid_range(from, to)) return -1;
+
+    const char *dates_sql = RANGE_DAYS_SQL
+                           "INSERT INTO temp.bulk_dates (date) SELECT date FROM days;";
+    const char *holiday_sql = "INSERT INTO class_holidays (class_id, date, name) "
+                             "SELECT ?1, date, ?3 FROM temp.bulk_dates;";
+
+    if (!op_begin()) return -1;
+
+    char label[64];
+    snprintf(label, sizeof(label), "holiday %s to %s", from, to);
+    bool ok = exec_op(dates_sql, class_id, 0, from, to) &&
+              journal_and_clear(class_id, label) &&
+              exec_op(holiday_sql, class_id, 0, name && name[0] ? name : NULL, NULL) &&
+              reindex(class_id);
+    int days = ok ? count_bulk_dates() : -1;
+    return op_end(ok && days >= 0, days);
+}
+
+// Most recent journaled operation of the class, or 0
+static sqlite3_int64 last_op(int class_id, char *label, size_t size) {
+    const char *sql = "SELECT op, label FROM temp.bulk_ops WHERE class_id = ? ORDER BY op DESC LIMIT 1;";
+    sqlite3_stmt *stmt;
+    sqlite3_int64 op = 0;
+
+    // No journal yet before the first operation of the session
+    if (!g_db || sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) return 0;
+    sqlite3_bind_int(stmt, 1, class_id);
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        op = sqlite3_column_int64(stmt, 0);
+        if (label && size > 0) {
+            snprintf(label, size, "%s", (const char *)sqlite3_column_text(stmt, 1));
+        }
+    }
+    sqlite3_finalize(stmt);
+    return op;
+}
+
+bool db_bulk_can_undo(int class_id, char *label, size_t size) {
+    return last_op(class_id, label, size) != 0;
+}
+
+bool db_bulk_undo(int class_id, char *label, size_t size) {
+    sqlite3_int64 op = last_op(class_id, label, size);
+    if (op == 0) return false;
+
+    const char *dates_sql = "INSERT INTO temp.bulk_dates (date) "
+                           "SELECT date FROM temp.bulk_journal_dates WHERE op = ?2;";
+    const char *clear_sql[] = {
+        "DELETE FROM attendance WHERE date IN (SELECT date FROM temp.bulk_dates) "
+        "AND student_id IN (SELECT id FROM students WHERE class_id = ?1);",
+        "DELETE FROM attendance_sessions WHERE class_id = ?1 "
+        "AND date IN (SELECT date FROM temp.bulk_dates);",
+        "DELETE FROM class_holidays WHERE class_id = ?1 "
+        "AND date IN (SELECT date FROM temp.bulk_dates);",
+    };
+    // Students deleted since the operation are left out
+    const char *restore_sql[] = {
+        "INSERT INTO attendance (student_id, date, status, notes) "
+        "SELECT j.student_id, j.date, j.status, j.notes FROM temp.bulk_journal_attendance j "
+        "WHERE j.op = ?2 AND EXISTS (SELECT 1 FROM students s WHERE s.id = j.student_id);",
+        "INSERT INTO attendance_sessions (class_id, date, sparse) "
+        "SELECT ?1, date, sparse FROM temp.bulk_journal_sessions WHERE op = ?2;",
+        "INSERT INTO class_holidays (class_id, date, name) "
+        "SELECT ?1, date, name FROM temp.bulk_journal_holidays WHERE op = ?2;",
+    };
+    const char *forget_sql[] = {
+        "DELETE FROM temp.bulk_journal_dates WHERE op = ?2;",
+        "DELETE FROM temp.bulk_journal_attendance WHERE op = ?2;",
+        "DELETE FROM temp.bulk_journal_sessions WHERE op = ?2;",
+        "DELETE FROM temp.bulk_journal_holidays WHERE op = ?2;",
+        "DELETE FROM temp.bulk_ops WHERE op = ?2;",
+    };
+
+    if (!op_begin()) return false;
+
+    bool ok = exec_op(dates_sql, class_id, op, NULL, NULL) && db_rollup_remove_class_days(class_id);
+    for (size_t i = 0; ok && i < sizeof(clear_sql) / sizeof(clear_sql[0]); i++) {
+        ok = exec_op(clear_sql[i], class_id, op, NULL, NULL);
+    }
+    for (size_t i = 0; ok && i < sizeof(restore_sql) / sizeof(restore_sql[0]); i++) {
+        ok = exec_op(restore_sql[i], class_id, op, NULL, NULL);
+    }
+    ok = ok && reindex(class_id);
+    for (size_t i = 0; ok && i < sizeof(forget_sql) / sizeof(forget_sql[0]); i++) {
+        ok = exec_op(forget_sql[i], class_id, op, NULL, NULL);
+    }
+    return op_end(ok, 0) == 0;
+}
+
+int db_bulk_refresh_range(int class_id, const char *from, const char *to) {
+    if (class_id <= 0 || !from || !to || !validate_date(from) || !validate_date(to)) return -1;
+    if (!op_begin()) return -1;
+
+    bool ok = exec_op("INSERT INTO temp.bulk_dates (date) SELECT date FROM attendance_sessions "
+                      "WHERE class_id = ?1 AND date >= ?3 AND date <= ?4;", class_id, 0, from, to) &&
+              db_rollup_refresh_class_days(class_id) &&
+              db_bitmap_update_class_days(class_id);
+    return op_end(ok, ok ? count_bulk_dates() : 0);
+}
+
+char** db_get_class_holidays(int class_id, const char *from, const char *to, int *count) {
+    if (!g_db || !count) return NULL;
+
+    const char *sql = "SELECT date FROM class_holidays "
+                     "WHERE class_id = ? AND date >= ? AND date <= ? ORDER BY date;";
+    sqlite3_stmt *stmt;
+
+    *count = 0;
+
+    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+        return NULL;
+    }
+
+    sqlite3_bind_int(stmt, 1, class_id);
+    sqlite3_bind_text(stmt, 2, from ? from : "", -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 3, to ? to : "~", -1, SQLITE_STATIC);
+
+    int capacity = 16;
+    char **dates = malloc(capacity * sizeof(char*));
+    if (!dates) {
+        sqlite3_finalize(stmt);
+        return NULL;
+    }
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        const char *date = (const char *)sqlite3_column_text(stmt, 0);
+        if (!date) continue;
+
+        if (*count >= capacity) {
+            capacity *= 2;
+            char **temp = realloc(dates, capacity * sizeof(char*));
+            if (!temp) {
+                db_free_attendance_dates(dates, *count);
+                sqlite3_finalize(stmt);
+                *count = 0;
+                return NULL;
+            }
+            dates = temp;
+        }
+
+        dates[*count] = strdup(date);
+        if (!dates[*count]) {
+            db_free_attendance_dates(dates, *count);
+            sqlite3_finalize(stmt);
+            *count = 0;
+            return NULL;
+        }
+        (*count)++;
+    }
+
+    sqlite3_finalize(stmt);
+
+    if (*count == 0) {
+        free(dates);
+        return NULL;
+    }
+
+    return dates;
+}
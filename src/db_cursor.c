@@ -0,0 +1,159 @@
+#include "db_cursor.h"
+
+static bool cursor_open(DbCursor *cursor, const char *sql) {
+    if (!cursor) return false;
+
+    cursor->stmt = NULL;
+    cursor->done = true;
+
+    if (!g_db) return false;
+
+    if (sqlite3_prepare_v2(g_db, sql, -1, &cursor->stmt, NULL) != SQLITE_OK) {
+        cursor->stmt = NULL;
+        return false;
+    }
+
+    cursor->done = false;
+    return true;
+}
+
+static bool cursor_step(DbCursor *cursor) {
+    if (!cursor || !cursor->stmt || cursor->done) return false;
+
+    if (sqlite3_step(cursor->stmt) == SQLITE_ROW) {
+        return true;
+    }
+
+    cursor->done = true;
+    return false;
+}
+
+static void copy_text(char *dest, const unsigned char *src, size_t size) {
+    if (src) {
+        strncpy(dest, (const char *)src, size - 1);
+        dest[size - 1] = '\0';
+    } else {
+        dest[0] = '\0';
+    }
+}
+
+bool db_cursor_students_by_class(DbCursor *cursor, int class_id) {
+    const char *sql = "SELECT id, name, email, roll_number, phone, class_id, strftime('%s', created_at) "
+                     "FROM students WHERE class_id = ? ORDER BY name;";
+    if (!cursor_open(cursor, sql)) return false;
+
+    sqlite3_bind_int(cursor->stmt, 1, class_id);
+    return true;
+}
+
+bool db_cursor_attendance_by_student(DbCursor *cursor, int student_id) {
+    // Same rows as db_get_attendance_by_student, including sparse days
+    const char *sql = "SELECT student_id, strftime('%s', date), status, notes, date AS day "
+                     "FROM attendance WHERE student_id = ?1 "
+                     "UNION ALL "
+                     "SELECT ?1, strftime('%s', ses.date), 1, '', ses.date "
+                     "FROM attendance_sessions ses "
+                     "WHERE ses.class_id = (SELECT class_id FROM students WHERE id = ?1) "
+                     "AND ses.sparse = 1 "
+                     "AND NOT EXISTS (SELECT 1 FROM attendance a "
+                     "WHERE a.student_id = ?1 AND a.date = ses.date) "
+                     "ORDER BY day DESC;";
+    if (!cursor_open(cursor, sql)) return false;
+
+    sqlite3_bind_int(cursor->stmt, 1, student_id);
+    return true;
+}
+
+bool db_cursor_attendance_by_class(DbCursor *cursor, int class_id) {
+    // Trailing columns are the sort key; the reader ignores them
+    const char *sql = "SELECT a.student_id, strftime('%s', a.date), a.status, a.notes, "
+                     "s.name, s.id, a.date "
+                     "FROM students s "
+                     "INNER JOIN attendance a ON a.student_id = s.id "
+                     "WHERE s.class_id = ?1 "
+                     "UNION ALL "
+                     "SELECT s.id, strftime('%s', ses.date), 1, '', s.name, s.id, ses.date "
+                     "FROM students s "
+                     "INNER JOIN attendance_sessions ses ON ses.class_id = s.class_id "
+                     "WHERE s.class_id = ?1 AND ses.sparse = 1 "
+                     "AND NOT EXISTS (SELECT 1 FROM attendance a "
+                     "WHERE a.student_id = s.id AND a.date = ses.date) "
+                     "ORDER BY 5, 6, 7;";
+    if (!cursor_open(cursor, sql)) return false;
+
+    sqlite3_bind_int(cursor->stmt, 1, class_id);
+    return true;
+}
+
+bool db_cursor_submissions_by_assignment(DbCursor *cursor, int assignment_id) {
+    const char *sql = "SELECT assignment_id, student_id, status, quality, strftime('%s', submitted_at), notes "
+                     "FROM assignment_submissions WHERE assignment_id = ?;";
+    if (!cursor_open(cursor, sql)) return false;
+
+    sqlite3_bind_int(cursor->stmt, 1, assignment_id);
+    return true;
+}
+
+bool db_cursor_next_student(DbCursor *cursor, Student *out) {
+    if (!out || !cursor_step(cursor)) return false;
+
+    sqlite3_stmt *stmt = cursor->stmt;
+    out->id = sqlite3_column_int(stmt, 0);
+    copy_text(out->name, sqlite3_column_text(stmt, 1), sizeof(out->name));
+    copy_text(out->email, sqlite3_column_text(stmt, 2), sizeof(out->email));
+    copy_text(out->roll_number, sqlite3_column_text(stmt, 3), sizeof(out->roll_number));
+    copy_text(out->phone, sqlite3_column_text(stmt, 4), sizeof(out->phone));
+    out->class_id = sqlite3_column_int(stmt, 5);
+    out->created_at = (time_t)sqlite3_column_int64(stmt, 6);
+    return true;
+}
+
+bool db_cursor_next_attendance(DbCursor *cursor, Attendance *out) {
+    if (!out || !cursor_step(cursor)) return false;
+
+    sqlite3_stmt *stmt = cursor->stmt;
+    out->student_id = sqlite3_column_int(stmt, 0);
+    out->date = (time_t)sqlite3_column_int64(stmt, 1);
+    out->status = (AttendanceStatus)sqlite3_column_int(stmt, 2);
+    copy_text(out->notes, sqlite3_column_text(stmt, 3), sizeof(out->notes));
+    return true;
+}
+
+bool db_cursor_next_submission(DbCursor *cursor, AssignmentSubmission *out) {
+    if (!out || !cursor_step(cursor)) return false;
+
+    sqlite3_stmt *stmt = cursor->stmt;
+    out->assignment_id = sqlite3_column_int(stmt, 0);
+    out->student_id = sqlite3_column_int(stmt, 1);
+    out->status = (SubmissionStatus)sqlite3_column_int(stmt, 2);
+    out->quality = (QualityAssessment)sqlite3_column_int(stmt, 3);
+    out->submitted_at = (time_t)sqlite3_column_int64(stmt, 4);
+    copy_text(out->notes, sqlite3_column_text(stmt, 5), sizeof(out->notes));
+    return true;
+}
+
+int db_cursor_fetch_students(DbCursor *cursor, Student *page, int max) {
+    int n = 0;
+    while (n < max && db_cursor_next_student(cursor, &page[n])) {
+        n++;
+    }
+    return n;
+}
+
+int db_cursor_fetch_attendance(DbCursor *cursor, Attendance *page, int max) {
+    int n = 0;
+    while (n < max && db_cursor_next_attendance(cursor, &page[n])) {
+        n++;
+    }
+    return n;
+}
+
+void db_cursor_close(DbCursor *cursor) {
+    if (cursor && cursor->stmt) {
+        sqlite3_finalize(cursor->stmt);
+        cursor->stmt = NULL;
+    }
+    if (cursor) {
+        cursor->done = true;
+    }
+}
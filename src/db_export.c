@@ -0,0 +1,338 @@
+#include "db_export.h"
+#include "db_bitmap.h"
+#include <strings.h>
+
+// One export file: stdio with an EXPORT_BUFFER_SIZE buffer, plus the state
+// of the row being written
+typedef struct {
+    FILE *file;
+    char *buffer;
+    ExportFormat format;
+    const char *const *headers;
+    int columns;
+    int column;            // fields written of the current row
+    long rows;
+} ExportWriter;
+
+static void write_json_string(FILE *file, const char *text) {
+    fputc('"', file);
+    for (const unsigned char *c = (const unsigned char *)text; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            fputc('\\', file);
+            fputc(*c, file);
+        } else if (*c == '\n') {
+            fputs("\\n", file);
+        } else if (*c == '\t') {
+            fputs("\\t", file);
+        } else if (*c < 0x20) {
+            fprintf(file, "\\u%04x", *c);
+        } else {
+            fputc(*c, file);
+        }
+    }
+    fputc('"', file);
+}
+
+// Quoted only when it holds a comma, a quote, a line break or edge spaces
+static void write_csv_string(FILE *file, const char *text) {
+    size_t len = strlen(text);
+    bool quote = len > 0 && (text[0] == ' ' || text[len - 1] == ' ');
+    for (size_t i = 0; !quote && i < len; i++) {
+        quote = text[i] == ',' || text[i] == '"' || text[i] == '\n' || text[i] == '\r';
+    }
+    if (!quote) {
+        fwrite(text, 1, len, file);
+        return;
+    }
+    fputc('"', file);
+    for (size_t i = 0; i < len; i++) {
+        if (text[i] == '"') fputc('"', file);
+        fputc(text[i], file);
+    }
+    fputc('"', file);
+}
+
+static bool writer_open(ExportWriter *w, const char *path, ExportFormat format,
+                        const char *const *headers, int columns) {
+    memset(w, 0, sizeof(*w));
+    if (!path) return false;
+
+    w->file = fopen(path, "wb");
+    if (!w->file) {
+        fprintf(stderr, "Cannot write %s\n", path);
+        return false;
+    }
+    w->buffer = malloc(EXPORT_BUFFER_SIZE);
+    if (w->buffer) {
+        setvbuf(w->file, w->buffer, _IOFBF, EXPORT_BUFFER_SIZE);
+    }
+    w->format = format;
+    w->headers = headers;
+    w->columns = columns;
+
+    if (format == EXPORT_JSON) {
+        fputc('[', w->file);
+        return true;
+    }
+    for (int i = 0; i < columns; i++) {
+        if (i > 0) fputc(',', w->file);
+        write_csv_string(w->file, headers[i]);
+    }
+    fputs("\r\n", w->file);
+    return true;
+}
+
+// Separator and key before the next field
+static void begin_field(ExportWriter *w) {
+    if (w->format == EXPORT_JSON) {
+        fputs(w->column == 0 ? (w->rows == 0 ? "\n  {" : ",\n  {") : ", ", w->file);
+        write_json_string(w->file, w->headers[w->column]);
+        fputs(": ", w->file);
+    } else if (w->column > 0) {
+        fputc(',', w->file);
+    }
+}
+
+// The end of a row once its last field is written
+static void end_field(ExportWriter *w) {
+    if (++w->column < w->columns) return;
+    fputs(w->format == EXPORT_JSON ? "}" : "\r\n", w->file);
+    w->column = 0;
+    w->rows++;
+}
+
+// NULL is an empty CSV field and a JSON null
+static void write_text(ExportWriter *w, const char *text) {
+    begin_field(w);
+    if (!text) {
+        if (w->format == EXPORT_JSON) fputs("null", w->file);
+    } else if (w->format == EXPORT_JSON) {
+        write_json_string(w->file, text);
+    } else {
+        write_csv_string(w->file, text);
+    }
+    end_field(w);
+}
+
+static void write_int(ExportWriter *w, long long value) {
+    begin_field(w);
+    fprintf(w->file, "%lld", value);
+    end_field(w);
+}
+
+static void write_real(ExportWriter *w, double value) {
+    begin_field(w);
+    fprintf(w->file, "%.15g", value);
+    end_field(w);
+}
+
+// part as a percentage of whole, to one decimal like the report views
+static double percent(long long part, long long whole) {
+    return (long long)(part * 1000.0 / whole + 0.5) / 10.0;
+}
+
+// Write the statement's rows, each column as the type SQLite returns
+static bool write_statement(ExportWriter *w, sqlite3_stmt *stmt) {
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        for (int i = 0; i < w->columns; i++) {
+            switch (sqlite3_column_type(stmt, i)) {
+                case SQLITE_INTEGER: write_int(w, sqlite3_column_int64(stmt, i)); break;
+                case SQLITE_FLOAT: write_real(w, sqlite3_column_double(stmt, i)); break;
+                case SQLITE_NULL: write_text(w, NULL); break;
+                default: write_text(w, (const char *)sqlite3_column_text(stmt, i)); break;
+            }
+        }
+        if (ferror(w->file)) return false;
+    }
+    if (rc != SQLITE_DONE) {
+        fprintf(stderr, "Export query failed: %s\n", sqlite3_errmsg(g_db));
+    }
+    return rc == SQLITE_DONE;
+}
+
+// Finish the file; on failure (ok false, or a write error) it is removed.
+// Returns the rows written, or -1.
+static long writer_close(ExportWriter *w, const char *path, bool ok) {
+    if (w->format == EXPORT_JSON) {
+        fputs(w->rows > 0 ? "\n]\n" : "]\n", w->file);
+    }
+    ok = ok && !ferror(w->file);
+    ok = fclose(w->file) == 0 && ok;
+    free(w->buffer);
+    if (!ok) {
+        remove(path);
+        return -1;
+    }
+    return w->rows;
+}
+
+static long export_query(const char *path, ExportFormat format, const char *const *headers, int columns,
+                         const char *sql, int param1, int param2) {
+    if (!g_db) return -1;
+
+    sqlite3_stmt *stmt;
+    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+        fprintf(stderr, "Export query failed: %s\n", sqlite3_errmsg(g_db));
+        return -1;
+    }
+    sqlite3_bind_int(stmt, 1, param1);
+    if (sqlite3_bind_parameter_count(stmt) >= 2) sqlite3_bind_int(stmt, 2, param2);
+
+    ExportWriter w;
+    long rows = -1;
+    if (writer_open(&w, path, format, headers, columns)) {
+        rows = writer_close(&w, path, write_statement(&w, stmt));
+    }
+    sqlite3_finalize(stmt);
+    return rows;
+}
+
+ExportFormat db_export_format_for_path(const char *path) {
+    size_t len = path ? strlen(path) : 0;
+    return len >= 5 && strcasecmp(path + len - 5, ".json") == 0 ? EXPORT_JSON : EXPORT_CSV;
+}
+
+long db_export_attendance_report(const char *path, ExportFormat format, int class_id,
+                                 const char *from, const char *to, int min_streak) {
+    static const char *const headers[] = {
+        "Student Name", "Roll Number", "Total Days", "Present", "Absent", "Late",
+        "Attendance %", "Longest Absence",
+    };
+    if (!g_db || class_id <= 0) return -1;
+
+    // Counted from the bitmap index, one row per student of the class, so
+    // the rows come from the summary rather than a cursor
+    int count;
+    AttendanceSummary **rows = db_get_attendance_summary_range(class_id, from, to, &count);
+
+    ExportWriter w;
+    if (!writer_open(&w, path, format, headers, 8)) {
+        db_free_attendance_summary(rows, count);
+        return -1;
+    }
+    for (int i = 0; rows && i < count; i++) {
+        AttendanceSummary *r = rows[i];
+        if (r->longest_absent_streak < min_streak) continue;
+
+        write_text(&w, r->name);
+        write_text(&w, r->roll_number);
+        write_int(&w, r->total_days);
+        write_int(&w, r->present);
+        write_int(&w, r->absent);
+        write_int(&w, r->late);
+        if (r->total_days > 0) {
+            write_real(&w, percent(r->present + r->late, r->total_days));
+        } else {
+            write_text(&w, NULL);
+        }
+        write_int(&w, r->longest_absent_streak);
+    }
+    db_free_attendance_summary(rows, count);
+    return writer_close(&w, path, true);
+}
+
+long db_export_assignment_report(const char *path, ExportFormat format, int class_id) {
+    static const char *const headers[] = {
+        "Assignment", "Subject", "Total Students", "Completed", "Pending", "Completion %",
+    };
+    // db_get_assignment_summary's query, with the class size bound as ?2
+    const char *sql = "SELECT title, subject, ?2, completed, ?2 - completed, "
+                     "ROUND(completed * 100.0 / ?2, 1) FROM ("
+                     "SELECT a.title, a.subject, "
+                     "COUNT(CASE WHEN s.status IN (1, 2) THEN 1 END) AS completed "
+                     "FROM assignments a "
+                     "LEFT JOIN assignment_submissions s ON a.id = s.assignment_id "
+                     "WHERE a.class_id = ?1 "
+                     "GROUP BY a.due_date, a.id "
+                     "ORDER BY a.title);";
+
+    if (!g_db || class_id <= 0) return -1;
+    return export_query(path, format, headers, 6, sql, class_id, db_count_students_by_class(class_id));
+}
+
+long db_export_student_report(const char *path, ExportFormat format, int student_id) {
+    static const char *const headers[] = {
+        "Month", "Days", "Present", "Absent", "Late", "Attendance %",
+    };
+    const char *sql = "SELECT period, present + absent + late, present, absent, late "
+                     "FROM attendance_rollup_student_month "
+                     "WHERE student_id = ? AND present + absent + late > 0 ORDER BY period;";
+    sqlite3_stmt *stmt;
+
+    if (!g_db || student_id <= 0) return -1;
+    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) return -1;
+    sqlite3_bind_int(stmt, 1, student_id);
+
+    ExportWriter w;
+    if (!writer_open(&w, path, format, headers, 6)) {
+        sqlite3_finalize(stmt);
+        return -1;
+    }
+
+    // Months as they come, then their sum
+    long long totals[4] = {0, 0, 0, 0};
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        write_text(&w, (const char *)sqlite3_column_text(stmt, 0));
+        for (int i = 0; i < 4; i++) {
+            long long value = sqlite3_column_int64(stmt, i + 1);
+            totals[i] += value;
+            write_int(&w, value);
+        }
+        write_real(&w, percent(sqlite3_column_int64(stmt, 2) + sqlite3_column_int64(stmt, 4),
+                               sqlite3_column_int64(stmt, 1)));
+    }
+    sqlite3_finalize(stmt);
+
+    write_text(&w, "All");
+    for (int i = 0; i < 4; i++) {
+        write_int(&w, totals[i]);
+    }
+    if (totals[0] > 0) {
+        write_real(&w, percent(totals[1] + totals[3], totals[0]));
+    } else {
+        write_text(&w, NULL);
+    }
+    return writer_close(&w, path, rc == SQLITE_DONE);
+}
+
+long db_export_attendance_history(const char *path, ExportFormat format, int class_id) {
+    static const char *const headers[] = {"Date", "Roll Number", "Student Name", "Status", "Notes"};
+    // Sessions in date order, and the class's students in roll number order
+    // within each, so the rows need no sort
+    const char *sql = "SELECT ses.date, s.roll_number, s.name, "
+                     "CASE COALESCE(a.status, 1) WHEN 0 THEN 'Absent' WHEN 1 THEN 'Present' "
+                     "WHEN 2 THEN 'Late' END, a.notes "
+                     "FROM attendance_sessions ses "
+                     "INNER JOIN students s ON s.class_id = ses.class_id "
+                     "LEFT JOIN attendance a ON a.student_id = s.id AND a.date = ses.date "
+                     "WHERE ses.class_id = ? AND (a.status IS NOT NULL OR ses.sparse = 1) "
+                     "ORDER BY ses.date, s.roll_number, s.id;";
+
+    if (!g_db || class_id <= 0) return -1;
+    return export_query(path, format, headers, 5, sql, class_id, 0);
+}
+
+long db_export_submission_history(const char *path, ExportFormat format, int class_id) {
+    static const char *const headers[] = {
+        "Due Date", "Assignment", "Subject", "Roll Number", "Student Name",
+        "Status", "Quality", "Submitted At", "Notes",
+    };
+    // Assignments in idx_assignments_class_due order and each one's
+    // submissions in key order
+    const char *sql = "SELECT date(a.due_date), a.title, a.subject, st.roll_number, st.name, "
+                     "CASE s.status WHEN 1 THEN 'Timely Submission' WHEN 2 THEN 'Late Submission' "
+                     "ELSE 'No Submission' END, "
+                     "CASE s.quality WHEN 0 THEN 'Poor' WHEN 1 THEN 'Below Average' "
+                     "WHEN 2 THEN 'Above Average' WHEN 3 THEN 'High' END, "
+                     "s.submitted_at, s.notes "
+                     "FROM assignments a "
+                     "INNER JOIN assignment_submissions s ON s.assignment_id = a.id "
+                     "INNER JOIN students st ON st.id = s.student_id "
+                     "WHERE a.class_id = ? "
+                     "ORDER BY a.due_date, a.id, s.student_id;";
+
+    if (!g_db || class_id <= 0) return -1;
+    return export_query(path, format, headers, 9, sql, class_id, 0);
+}
@@ -0,0 +1,607 @@
+#include "db_import.h"
+#include "db_batch.h"
+#include "db_bulk.h"
+#include "csv.h"
+#include "validation.h"
+#include <strings.h>
+
+#define FIELD_SIZE(type, field) sizeof(((type *)0)->field)
+
+static bool exec_sql(const char *sql) {
+    char *err_msg = NULL;
+    if (sqlite3_exec(g_db, sql, NULL, NULL, &err_msg) != SQLITE_OK) {
+        fprintf(stderr, "SQL error: %s\n", err_msg);
+        sqlite3_free(err_msg);
+        return false;
+    }
+    return true;
+}
+
+static bool add_error(ImportReport *report, int line, const char *format, const char *value) {
+    if (report->error_count % 64 == 0) {
+        ImportError *grown = realloc(report->errors, (report->error_count + 64) * sizeof(ImportError));
+        if (!grown) return false;
+        report->errors = grown;
+    }
+    ImportError *error = &report->errors[report->error_count++];
+    error->line = line;
+    snprintf(error->message, sizeof(error->message), format, value);
+    report->rejected++;
+    return true;
+}
+
+static int compare_errors(const void *a, const void *b) {
+    const ImportError *ea = a;
+    const ImportError *eb = b;
+    return (ea->line > eb->line) - (ea->line < eb->line);
+}
+
+static void fail(ImportReport *report, const char *message) {
+    snprintf(report->failure, sizeof(report->failure), "%s", message);
+}
+
+static void too_long(ImportReport *report, const CsvReader *reader) {
+    snprintf(report->failure, sizeof(report->failure),
+             "Line %d is longer than %d bytes", reader->line, CSV_MAX_RECORD);
+}
+
+// Staged roster rows, by line; the indexes find earlier lines with a value
+static const char *STAGE_STUDENTS_SQL =
+    "CREATE TEMP TABLE IF NOT EXISTS import_students ("
+    "line INTEGER PRIMARY KEY, name TEXT NOT NULL, email TEXT NOT NULL, "
+    "roll_number TEXT NOT NULL, phone TEXT NOT NULL);"
+    "CREATE INDEX IF NOT EXISTS temp.import_students_email ON import_students (email, line);"
+    "CREATE INDEX IF NOT EXISTS temp.import_students_roll ON import_students (roll_number, line);"
+    "DELETE FROM temp.import_students;";
+
+// A staged row (i) that cannot be added: its email or roll number is
+// registered already or is on an earlier line of the file
+#define STUDENT_DUPLICATE_SQL \
+    "(EXISTS (SELECT 1 FROM students s WHERE s.email = i.email) " \
+    "OR EXISTS (SELECT 1 FROM students s WHERE s.roll_number = i.roll_number) " \
+    "OR EXISTS (SELECT 1 FROM temp.import_students d WHERE d.email = i.email AND d.line < i.line) " \
+    "OR EXISTS (SELECT 1 FROM temp.import_students d WHERE d.roll_number = i.roll_number AND d.line < i.line))"
+
+// The student form's rules: the problem with a row (a format for the
+// offending *value), or NULL when it is fine
+static const char* check_student(const char *name, const char *email, const char *roll, const char *phone,
+                                 const char **value) {
+    *value = "";
+    if (!validate_required(name)) return "name is missing";
+    if (strlen(name) >= FIELD_SIZE(Student, name)) return "name is too long";
+    *value = email;
+    if (!validate_email(email)) return "email \"%s\" is not valid";
+    if (strlen(email) >= FIELD_SIZE(Student, email)) return "email is too long";
+    if (!validate_roll_number(roll)) return "roll number is missing";
+    if (strlen(roll) >= FIELD_SIZE(Student, roll_number)) return "roll number is too long";
+    *value = phone;
+    if (phone[0] && !validate_phone(phone)) return "phone \"%s\" is not valid";
+    if (strlen(phone) >= FIELD_SIZE(Student, phone)) return "phone is too long";
+    return NULL;
+}
+
+// Stream the file into temp.import_students, reporting rows that break
+// the form's rules
+static bool stage_students(CsvReader *reader, ImportReport *report) {
+    static const char *const name_headers[] = {"name", "student name", "full name", NULL};
+    static const char *const email_headers[] = {"email", "e-mail", NULL};
+    static const char *const roll_headers[] = {"roll", "roll number", "roll_number", "roll no", "roll no.", NULL};
+    static const char *const phone_headers[] = {"phone", "phone number", NULL};
+    const char *insert_sql = "INSERT INTO temp.import_students (line, name, email, roll_number, phone) "
+                            "VALUES (?, ?, ?, ?, ?);";
+
+    if (csv_next(reader) <= 0) {
+        fail(report, "The file is empty");
+        return false;
+    }
+    int name_col = csv_find_column(reader, name_headers);
+    int email_col = csv_find_column(reader, email_headers);
+    int roll_col = csv_find_column(reader, roll_headers);
+    int phone_col = csv_find_column(reader, phone_headers);
+    if (name_col < 0 || email_col < 0 || roll_col < 0) {
+        fail(report, "The header row needs \"name\", \"email\" and \"roll\" columns");
+        return false;
+    }
+
+    sqlite3_stmt *stmt;
+    if (!exec_sql(STAGE_STUDENTS_SQL) ||
+        sqlite3_prepare_v2(g_db, insert_sql, -1, &stmt, NULL) != SQLITE_OK) {
+        fail(report, "Database error");
+        return false;
+    }
+
+    bool ok = db_begin();
+    int fields = 0;
+    while (ok && (fields = csv_next(reader)) > 0) {
+        report->rows++;
+        const char *name = csv_field(reader, name_col);
+        const char *email = csv_field(reader, email_col);
+        const char *roll = csv_field(reader, roll_col);
+        const char *phone = phone_col >= 0 ? csv_field(reader, phone_col) : "";
+
+        const char *value;
+        const char *problem = check_student(name, email, roll, phone, &value);
+        if (problem) {
+            ok = add_error(report, reader->line, problem, value);
+            continue;
+        }
+
+        sqlite3_bind_int(stmt, 1, reader->line);
+        sqlite3_bind_text(stmt, 2, name, -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 3, email, -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 4, roll, -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 5, phone, -1, SQLITE_STATIC);
+        ok = sqlite3_step(stmt) == SQLITE_DONE;
+        sqlite3_reset(stmt);
+
+        if (ok && report->rows % IMPORT_BATCH_ROWS == 0) {
+            ok = db_commit() && db_begin();
+        }
+    }
+    sqlite3_finalize(stmt);
+
+    if (fields < 0) {
+        too_long(report, reader);
+        ok = false;
+    }
+    if (ok) {
+        ok = db_commit();
+    } else {
+        db_rollback();
+    }
+    if (!ok && !report->failure[0]) fail(report, "Database error");
+    return ok;
+}
+
+// Report the staged rows STUDENT_DUPLICATE_SQL turns away, in one pass
+// that joins them against the students and the earlier staged rows
+static bool report_duplicates(ImportReport *report) {
+    const char *sql = "SELECT i.line, i.email, i.roll_number, "
+                     "EXISTS (SELECT 1 FROM students s WHERE s.email = i.email), "
+                     "EXISTS (SELECT 1 FROM students s WHERE s.roll_number = i.roll_number), "
+                     "(SELECT MIN(d.line) FROM temp.import_students d WHERE d.email = i.email), "
+                     "(SELECT MIN(d.line) FROM temp.import_students d WHERE d.roll_number = i.roll_number) "
+                     "FROM temp.import_students i WHERE " STUDENT_DUPLICATE_SQL " ORDER BY i.line;";
+    sqlite3_stmt *stmt;
+
+    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) return false;
+
+    bool ok = true;
+    int rc;
+    while (ok && (rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        int line = sqlite3_column_int(stmt, 0);
+        const char *email = (const char *)sqlite3_column_text(stmt, 1);
+        const char *roll = (const char *)sqlite3_column_text(stmt, 2);
+        int first_email = sqlite3_column_int(stmt, 5);
+        char message[64];
+
+        if (sqlite3_column_int(stmt, 3)) {
+            ok = add_error(report, line, "email %s is already registered", email);
+        } else if (sqlite3_column_int(stmt, 4)) {
+            ok = add_error(report, line, "roll number %s is already registered", roll);
+        } else if (first_email < line) {
+            snprintf(message, sizeof(message), "email %%s repeats line %d", first_email);
+            ok = add_error(report, line, message, email);
+        } else {
+            snprintf(message, sizeof(message), "roll number %%s repeats line %d", sqlite3_column_int(stmt, 6));
+            ok = add_error(report, line, message, roll);
+        }
+    }
+    sqlite3_finalize(stmt);
+    return ok && rc == SQLITE_DONE;
+}
+
+// Insert the rows left, IMPORT_BATCH_ROWS lines per transaction
+static bool insert_students(int class_id, int last_line, ImportReport *report) {
+    const char *sql = "INSERT INTO students (name, email, roll_number, phone, class_id) "
+                     "SELECT i.name, i.email, i.roll_number, i.phone, ?1 FROM temp.import_students i "
+                     "WHERE i.line > ?2 AND i.line <= ?3 AND NOT " STUDENT_DUPLICATE_SQL " ORDER BY i.line;";
+    sqlite3_stmt *stmt;
+
+    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) return false;
+
+    bool ok = true;
+    for (int line = 0; ok && line < last_line; line += IMPORT_BATCH_ROWS) {
+        ok = db_begin();
+        sqlite3_bind_int(stmt, 1, class_id);
+        sqlite3_bind_int(stmt, 2, line);
+        sqlite3_bind_int(stmt, 3, line + IMPORT_BATCH_ROWS);
+        ok = ok && sqlite3_step(stmt) == SQLITE_DONE;
+        int inserted = sqlite3_changes(g_db);
+        sqlite3_reset(stmt);
+
+        if (ok && db_commit()) {
+            report->imported += inserted;
+        } else {
+            db_rollback();
+            ok = false;
+        }
+    }
+    sqlite3_finalize(stmt);
+    return ok;
+}
+
+bool db_import_students_csv(const char *path, int class_id, ImportReport *report) {
+    if (!report) return false;
+    memset(report, 0, sizeof(*report));
+    if (!g_db || class_id <= 0) {
+        fail(report, "No class selected");
+        return false;
+    }
+
+    CsvReader reader;
+    if (!csv_open(&reader, path)) {
+        fail(report, "The file could not be opened");
+        return false;
+    }
+
+    bool ok = stage_students(&reader, report);
+    int last_line = reader.line;
+    csv_close(&reader);
+
+    if (ok && !report_duplicates(report)) {
+        fail(report, "Database error while checking for duplicates");
+        ok = false;
+    }
+    if (ok && !insert_students(class_id, last_line, report)) {
+        snprintf(report->failure, sizeof(report->failure),
+                 "Database error after importing %d students", report->imported);
+        ok = false;
+    }
+    exec_sql("DELETE FROM temp.import_students;");
+
+    qsort(report->errors, report->error_count, sizeof(ImportError), compare_errors);
+    return ok;
+}
+
+// Roll numbers of a class's students, so imported rows resolve without a
+// query each: open addressing with linear probing on FNV-1a hashes
+typedef struct {
+    int student_id;        // 0 for an empty slot
+    char roll_number[FIELD_SIZE(Student, roll_number)];
+} RollSlot;
+
+typedef struct {
+    RollSlot *slots;       // [capacity], a power of two at least twice count
+    unsigned capacity;
+    int count;
+} RollMap;
+
+static unsigned hash_roll(const char *roll) {
+    unsigned hash = 2166136261u;
+    for (; *roll; roll++) {
+        hash ^= (unsigned char)*roll;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static RollSlot* roll_map_slot(const RollMap *map, const char *roll) {
+    unsigned i = hash_roll(roll) & (map->capacity - 1);
+    while (map->slots[i].student_id && strcmp(map->slots[i].roll_number, roll) != 0) {
+        i = (i + 1) & (map->capacity - 1);
+    }
+    return &map->slots[i];
+}
+
+static bool roll_map_load(RollMap *map, int class_id) {
+    const char *count_sql = "SELECT COUNT(*) FROM students WHERE class_id = ?;";
+    const char *sql = "SELECT id, roll_number FROM students WHERE class_id = ?;";
+    sqlite3_stmt *stmt;
+
+    memset(map, 0, sizeof(*map));
+    if (sqlite3_prepare_v2(g_db, count_sql, -1, &stmt, NULL) != SQLITE_OK) return false;
+    sqlite3_bind_int(stmt, 1, class_id);
+    int students = sqlite3_step(stmt) == SQLITE_ROW ? sqlite3_column_int(stmt, 0) : 0;
+    sqlite3_finalize(stmt);
+
+    map->capacity = 16;
+    while (map->capacity < 2u * (unsigned)students) map->capacity *= 2;
+    map->slots = calloc(map->capacity, sizeof(RollSlot));
+    if (!map->slots) return false;
+
+    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+        sqlite3_finalize(stmt);
+        free(map->slots);
+        map->slots = NULL;
+        return false;
+    }
+    sqlite3_bind_int(stmt, 1, class_id);
+    while (map->count < students && sqlite3_step(stmt) == SQLITE_ROW) {
+        const char *roll = (const char *)sqlite3_column_text(stmt, 1);
+        if (!roll) continue;
+        RollSlot *slot = roll_map_slot(map, roll);
+        slot->student_id = sqlite3_column_int(stmt, 0);
+        snprintf(slot->roll_number, sizeof(slot->roll_number), "%s", roll);
+        map->count++;
+    }
+    sqlite3_finalize(stmt);
+    return true;
+}
+
+// Student id of a roll number in the class, or 0
+static int roll_map_find(const RollMap *map, const char *roll) {
+    return roll_map_slot(map, roll)->student_id;
+}
+
+static void roll_map_free(RollMap *map) {
+    free(map->slots);
+    map->slots = NULL;
+}
+
+// "P", "present" or "1"; "A", "absent" or "0"; "L", "late" or "2"
+static int parse_status(const char *cell) {
+    static const char *const names[][3] = {
+        [ATTENDANCE_ABSENT] = {"a", "absent", "0"},
+        [ATTENDANCE_PRESENT] = {"p", "present", "1"},
+        [ATTENDANCE_LATE] = {"l", "late", "2"},
+    };
+    for (int status = 0; status < 3; status++) {
+        for (int n = 0; n < 3; n++) {
+            if (strcasecmp(cell, names[status][n]) == 0) return status;
+        }
+    }
+    return -1;
+}
+
+static bool is_import_date(const char *text) {
+    return strlen(text) == 10 && validate_date(text);
+}
+
+// Rows and sessions of the import, IMPORT_BATCH_ROWS rows per transaction.
+// New days take the class's storage mode, as when attendance is taken in the
+// app. Rollups and bitmaps are left alone until the end of the file; from and
+// to bound the dates written, for refreshing them then.
+typedef struct {
+    sqlite3_stmt *mark;
+    sqlite3_stmt *unmark;         // a plain present on a sparse day is implied
+    sqlite3_stmt *session;
+    sqlite3_stmt *session_mode;
+    int class_id;
+    char mode_date[11];           // the day session_sparse was read for
+    bool session_sparse;
+    ImportReport *report;
+    char from[11];
+    char to[11];
+} MarkWriter;
+
+static bool mark_writer_open(MarkWriter *writer, int class_id, ImportReport *report) {
+    const char *mark_sql = "INSERT OR REPLACE INTO attendance (student_id, date, status, notes) "
+                          "VALUES (?, ?, ?, ?);";
+    const char *unmark_sql = "DELETE FROM attendance WHERE student_id = ? AND date = ?;";
+    const char *session_sql = "INSERT OR IGNORE INTO attendance_sessions (class_id, date, sparse) "
+                             "SELECT id, ?2, attendance_mode FROM classes WHERE id = ?1;";
+    const char *session_mode_sql = "SELECT sparse FROM attendance_sessions WHERE class_id = ? AND date = ?;";
+
+    memset(writer, 0, sizeof(*writer));
+    writer->class_id = class_id;
+    writer->report = report;
+    if (sqlite3_prepare_v2(g_db, mark_sql, -1, &writer->mark, NULL) != SQLITE_OK ||
+        sqlite3_prepare_v2(g_db, unmark_sql, -1, &writer->unmark, NULL) != SQLITE_OK ||
+        sqlite3_prepare_v2(g_db, session_sql, -1, &writer->session, NULL) != SQLITE_OK ||
+        sqlite3_prepare_v2(g_db, session_mode_sql, -1, &writer->session_mode, NULL) != SQLITE_OK) {
+        return false;
+    }
+    return db_begin();
+}
+
+// Whether the (existing) session of date is sparse; the wide layout asks
+// about each date in turn, the long one usually about the same date again
+static bool mark_writer_sparse(MarkWriter *writer, const char *date, bool *sparse) {
+    if (strcmp(date, writer->mode_date) != 0) {
+        sqlite3_bind_int(writer->session_mode, 1, writer->class_id);
+        sqlite3_bind_text(writer->session_mode, 2, date, -1, SQLITE_STATIC);
+        bool found = sqlite3_step(writer->session_mode) == SQLITE_ROW;
+        if (found) writer->session_sparse = sqlite3_column_int(writer->session_mode, 0) == 1;
+        sqlite3_reset(writer->session_mode);
+        if (!found) return false;
+        memcpy(writer->mode_date, date, sizeof(writer->mode_date));
+    }
+    *sparse = writer->session_sparse;
+    return true;
+}
+
+static bool mark_writer_put(MarkWriter *writer, int student_id, const char *date, int status, const char *notes) {
+    sqlite3_bind_int(writer->session, 1, writer->class_id);
+    sqlite3_bind_text(writer->session, 2, date, -1, SQLITE_STATIC);
+    bool ok = sqlite3_step(writer->session) == SQLITE_DONE;
+    sqlite3_reset(writer->session);
+
+    bool implied = false;
+    if (ok && status == ATTENDANCE_PRESENT && notes[0] == '\0') {
+        ok = mark_writer_sparse(writer, date, &implied);
+    }
+    if (!ok) return false;
+
+    sqlite3_stmt *stmt = implied ? writer->unmark : writer->mark;
+    sqlite3_bind_int(stmt, 1, student_id);
+    sqlite3_bind_text(stmt, 2, date, -1, SQLITE_STATIC);
+    if (!implied) {
+        sqlite3_bind_int(stmt, 3, status);
+        sqlite3_bind_text(stmt, 4, notes, -1, SQLITE_STATIC);
+    }
+    ok = sqlite3_step(stmt) == SQLITE_DONE;
+    sqlite3_reset(stmt);
+    if (!ok) return false;
+
+    if (!writer->from[0] || strcmp(date, writer->from) < 0) memcpy(writer->from, date, sizeof(writer->from));
+    if (strcmp(date, writer->to) > 0) memcpy(writer->to, date, sizeof(writer->to));
+    if (++writer->report->imported % IMPORT_BATCH_ROWS == 0) {
+        return db_commit() && db_begin();
+    }
+    return true;
+}
+
+// Commit the last batch (or roll it back when !ok) and finalize
+static bool mark_writer_close(MarkWriter *writer, bool ok) {
+    if (ok) {
+        ok = db_commit();
+    } else {
+        db_rollback();
+    }
+    sqlite3_finalize(writer->mark);
+    sqlite3_finalize(writer->unmark);
+    sqlite3_finalize(writer->session);
+    sqlite3_finalize(writer->session_mode);
+    return ok;
+}
+
+// Long layout: one mark per record
+static bool import_long(CsvReader *reader, const RollMap *map, int roll_col, int date_col, int status_col,
+                        int notes_col, MarkWriter *writer) {
+    ImportReport *report = writer->report;
+    bool ok = true;
+    int fields = 0;
+
+    while (ok && (fields = csv_next(reader)) > 0) {
+        report->rows++;
+        const char *roll = csv_field(reader, roll_col);
+        const char *date = csv_field(reader, date_col);
+        const char *cell = csv_field(reader, status_col);
+        const char *notes = notes_col >= 0 ? csv_field(reader, notes_col) : "";
+        int student_id = roll_map_find(map, roll);
+        int status = parse_status(cell);
+
+        if (!student_id) {
+            ok = add_error(report, reader->line, "roll number \"%s\" is not in this class", roll);
+        } else if (!is_import_date(date)) {
+            ok = add_error(report, reader->line, "date \"%s\" is not YYYY-MM-DD", date);
+        } else if (status < 0) {
+            ok = add_error(report, reader->line, "status \"%s\" is not present, absent or late", cell);
+        } else {
+            ok = mark_writer_put(writer, student_id, date, status, notes);
+        }
+    }
+    if (fields < 0) {
+        too_long(report, reader);
+        ok = false;
+    }
+    return ok;
+}
+
+// Wide layout: one record per student, one mark per non-empty date cell.
+// dates[i] is the date of column i, or "" when it is not a date column.
+static bool import_wide(CsvReader *reader, const RollMap *map, int roll_col, char (*dates)[11], int columns,
+                        MarkWriter *writer) {
+    ImportReport *report = writer->report;
+    bool ok = true;
+    int fields = 0;
+
+    while (ok && (fields = csv_next(reader)) > 0) {
+        report->rows++;
+        const char *roll = csv_field(reader, roll_col);
+        int student_id = roll_map_find(map, roll);
+        if (!student_id) {
+            ok = add_error(report, reader->line, "roll number \"%s\" is not in this class", roll);
+            continue;
+        }
+
+        for (int i = 0; ok && i < columns && i < fields; i++) {
+            if (!dates[i][0]) continue;
+            const char *cell = csv_field(reader, i);
+            if (!cell[0]) continue;
+
+            int status = parse_status(cell);
+            if (status < 0) {
+                char message[64];
+                snprintf(message, sizeof(message), "status \"%%s\" on %s is not present, absent or late", dates[i]);
+                ok = add_error(report, reader->line, message, cell);
+            } else {
+                ok = mark_writer_put(writer, student_id, dates[i], status, "");
+            }
+        }
+    }
+    if (fields < 0) {
+        too_long(report, reader);
+        ok = false;
+    }
+    return ok;
+}
+
+bool db_import_attendance_csv(const char *path, int class_id, ImportReport *report) {
+    static const char *const roll_headers[] = {"roll", "roll number", "roll_number", "roll no", "roll no.", NULL};
+    static const char *const date_headers[] = {"date", NULL};
+    static const char *const status_headers[] = {"status", "attendance", NULL};
+    static const char *const notes_headers[] = {"notes", "note", "remarks", NULL};
+
+    if (!report) return false;
+    memset(report, 0, sizeof(*report));
+    if (!g_db || class_id <= 0) {
+        fail(report, "No class selected");
+        return false;
+    }
+
+    CsvReader reader;
+    if (!csv_open(&reader, path)) {
+        fail(report, "The file could not be opened");
+        return false;
+    }
+    if (csv_next(&reader) <= 0) {
+        fail(report, "The file is empty");
+        csv_close(&reader);
+        return false;
+    }
+
+    int roll_col = csv_find_column(&reader, roll_headers);
+    int date_col = csv_find_column(&reader, date_headers);
+    int status_col = csv_find_column(&reader, status_headers);
+    int notes_col = csv_find_column(&reader, notes_headers);
+    bool long_layout = date_col >= 0 && status_col >= 0;
+
+    // The header dates outlive the header record
+    int columns = reader.field_count;
+    int date_columns = 0;
+    char (*dates)[11] = calloc(columns, sizeof(*dates));
+    for (int i = 0; dates && !long_layout && i < columns; i++) {
+        const char *header = csv_field(&reader, i);
+        if (i != roll_col && is_import_date(header)) {
+            memcpy(dates[i], header, sizeof(dates[i]));
+            date_columns++;
+        }
+    }
+
+    RollMap map = {0};
+    MarkWriter writer;
+    bool ok = false;
+    if (!dates) {
+        fail(report, "Out of memory");
+    } else if (roll_col < 0 || (!long_layout && date_columns == 0)) {
+        fail(report, "The header row needs a \"roll\" column and either \"date\" and \"status\" "
+                     "columns or one YYYY-MM-DD column per day");
+    } else if (!roll_map_load(&map, class_id)) {
+        fail(report, "Database error");
+    } else if (map.count == 0) {
+        fail(report, "The class has no students");
+    } else if (!mark_writer_open(&writer, class_id, report)) {
+        mark_writer_close(&writer, false);
+        fail(report, "Database error");
+    } else {
+        ok = long_layout ? import_long(&reader, &map, roll_col, date_col, status_col, notes_col, &writer)
+                         : import_wide(&reader, &map, roll_col, dates, columns, &writer);
+        ok = mark_writer_close(&writer, ok);
+        if (!ok) {
+            // The last, uncommitted batch was rolled back
+            report->imported -= report->imported % IMPORT_BATCH_ROWS;
+            if (!report->failure[0]) {
+                snprintf(report->failure, sizeof(report->failure),
+                         "Database error after importing %d marks", report->imported);
+            }
+        }
+        // Once for the whole file, over the span of dates it wrote
+        if (report->imported > 0 && db_bulk_refresh_range(class_id, writer.from, writer.to) < 0) {
+            fail(report, "The attendance was imported, but its totals could not be updated");
+            ok = false;
+        }
+    }
+    roll_map_free(&map);
+    free(dates);
+    csv_close(&reader);
+    return ok;
+}
+
+void db_free_import_report(ImportReport *report) {
+    if (!report) return;
+    free(report->errors);
+    report->errors = NULL;
+    report->error_count = 0;
+}
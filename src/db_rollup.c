@@ -0,0 +1,450 @@
+#include "db_rollup.h"
+
+// Table, key column and the period a date falls in (?2 is the date)
+static const struct {
+    const char *table;
+    const char *key;
+    const char *period;
+} ROLLUPS[ROLLUP_TABLES] = {
+    {"attendance_rollup_class_day", "class_id", "?2"},
+    {"attendance_rollup_class_week", "class_id", "date(?2, '-6 days', 'weekday 1')"},
+    {"attendance_rollup_class_month", "class_id", "strftime('%Y-%m', ?2)"},
+    {"attendance_rollup_student_month", "student_id", "strftime('%Y-%m', ?2)"},
+};
+
+void db_rollup_date(time_t date, char *out, size_t size) {
+    struct tm *tm_info = gmtime(&date);
+    if (!tm_info || strftime(out, size, "%Y-%m-%d", tm_info) == 0) {
+        out[0] = '\0';
+    }
+}
+
+bool db_rollup_writer_open(RollupWriter *writer) {
+    if (!writer) return false;
+    memset(writer, 0, sizeof(*writer));
+    if (!g_db) return false;
+
+    const char *lookup_sql = "SELECT s.class_id, COALESCE(a.status, CASE WHEN ses.sparse = 1 THEN 1 END, -1) "
+                            "FROM students s "
+                            "LEFT JOIN attendance a ON a.student_id = s.id AND a.date = ?2 "
+                            "LEFT JOIN attendance_sessions ses ON ses.class_id = s.class_id AND ses.date = ?2 "
+                            "WHERE s.id = ?1;";
+    if (sqlite3_prepare_v2(g_db, lookup_sql, -1, &writer->lookup, NULL) != SQLITE_OK) {
+        db_rollup_writer_close(writer);
+        return false;
+    }
+
+    for (int t = 0; t < ROLLUP_TABLES; t++) {
+        char sql[512];
+        snprintf(sql, sizeof(sql),
+                 "INSERT INTO %s (%s, period, present, absent, late) VALUES (?1, %s, ?3, ?4, ?5) "
+                 "ON CONFLICT (%s, period) DO UPDATE SET present = present + excluded.present, "
+                 "absent = absent + excluded.absent, late = late + excluded.late;",
+                 ROLLUPS[t].table, ROLLUPS[t].key, ROLLUPS[t].period, ROLLUPS[t].key);
+        if (sqlite3_prepare_v2(g_db, sql, -1, &writer->bump[t], NULL) != SQLITE_OK) {
+            db_rollup_writer_close(writer);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool db_rollup_writer_lookup(RollupWriter *writer, int student_id, const char *date,
+                             int *class_id, int *status) {
+    if (!writer || !writer->lookup || !date) return false;
+
+    sqlite3_bind_int(writer->lookup, 1, student_id);
+    sqlite3_bind_text(writer->lookup, 2, date, -1, SQLITE_TRANSIENT);
+    bool found = sqlite3_step(writer->lookup) == SQLITE_ROW;
+    *class_id = found ? sqlite3_column_int(writer->lookup, 0) : 0;
+    *status = found ? sqlite3_column_int(writer->lookup, 1) : -1;
+    sqlite3_reset(writer->lookup);
+    return found;
+}
+
+static bool bump(RollupWriter *writer, RollupTable table, int key, const char *date, const int counts[3]) {
+    sqlite3_stmt *stmt = writer->bump[table];
+    sqlite3_bind_int(stmt, 1, key);
+    sqlite3_bind_text(stmt, 2, date, -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(stmt, 3, counts[ATTENDANCE_PRESENT]);
+    sqlite3_bind_int(stmt, 4, counts[ATTENDANCE_ABSENT]);
+    sqlite3_bind_int(stmt, 5, counts[ATTENDANCE_LATE]);
+    int rc = sqlite3_step(stmt);
+    sqlite3_reset(stmt);
+    return rc == SQLITE_DONE;
+}
+
+static bool valid_status(int status) {
+    return status >= ATTENDANCE_ABSENT && status <= ATTENDANCE_LATE;
+}
+
+bool db_rollup_writer_move(RollupWriter *writer, int class_id, int student_id, const char *date,
+                           int old_status, int new_status) {
+    if (!writer || !writer->lookup || !date) return false;
+    if (!valid_status(old_status)) old_status = -1;
+    if (!valid_status(new_status)) new_status = -1;
+    if (old_status == new_status) return true;
+
+    int counts[3] = {0, 0, 0};
+    if (old_status >= 0) counts[old_status]--;
+    if (new_status >= 0) counts[new_status]++;
+
+    if (!bump(writer, ROLLUP_STUDENT_MONTH, student_id, date, counts)) return false;
+    if (class_id <= 0) return true;
+
+    // Writers save one day of one class at a time, so this stays short
+    RollupDelta *delta = NULL;
+    for (int i = 0; i < writer->pending_count; i++) {
+        if (writer->pending[i].class_id == class_id && strcmp(writer->pending[i].date, date) == 0) {
+            delta = &writer->pending[i];
+            break;
+        }
+    }
+    if (!delta) {
+        if (writer->pending_count >= writer->pending_capacity) {
+            int capacity = writer->pending_capacity ? writer->pending_capacity * 2 : 4;
+            RollupDelta *grown = realloc(writer->pending, capacity * sizeof(RollupDelta));
+            if (!grown) return false;
+            writer->pending = grown;
+            writer->pending_capacity = capacity;
+        }
+        delta = &writer->pending[writer->pending_count++];
+        memset(delta, 0, sizeof(*delta));
+        delta->class_id = class_id;
+        strncpy(delta->date, date, sizeof(delta->date) - 1);
+    }
+    for (int s = 0; s < 3; s++) {
+        delta->counts[s] += counts[s];
+    }
+    return true;
+}
+
+bool db_rollup_writer_flush(RollupWriter *writer) {
+    if (!writer || !writer->lookup) return false;
+
+    bool ok = true;
+    for (int i = 0; ok && i < writer->pending_count; i++) {
+        RollupDelta *delta = &writer->pending[i];
+        for (int t = ROLLUP_CLASS_DAY; ok && t <= ROLLUP_CLASS_MONTH; t++) {
+            ok = bump(writer, (RollupTable)t, delta->class_id, delta->date, delta->counts);
+        }
+    }
+    writer->pending_count = 0;
+    return ok;
+}
+
+void db_rollup_writer_close(RollupWriter *writer) {
+    if (!writer) return;
+    if (writer->lookup) sqlite3_finalize(writer->lookup);
+    for (int t = 0; t < ROLLUP_TABLES; t++) {
+        if (writer->bump[t]) sqlite3_finalize(writer->bump[t]);
+    }
+    free(writer->pending);
+    memset(writer, 0, sizeof(*writer));
+}
+
+bool db_rollup_open_sparse_day(int class_id, const char *date) {
+    if (!g_db || !date) return false;
+
+    const char *count_sql = "SELECT COUNT(*) FROM students s "
+                           "WHERE s.class_id = ?1 AND NOT EXISTS (SELECT 1 FROM attendance a "
+                           "WHERE a.student_id = s.id AND a.date = ?2);";
+    const char *student_sql = "INSERT INTO attendance_rollup_student_month (student_id, period, present, absent, late) "
+                             "SELECT s.id, strftime('%Y-%m', ?2), 1, 0, 0 FROM students s "
+                             "WHERE s.class_id = ?1 AND NOT EXISTS (SELECT 1 FROM attendance a "
+                             "WHERE a.student_id = s.id AND a.date = ?2) "
+                             "ON CONFLICT (student_id, period) DO UPDATE SET present = present + 1;";
+    sqlite3_stmt *stmt;
+    int implied = 0;
+
+    if (sqlite3_prepare_v2(g_db, count_sql, -1, &stmt, NULL) != SQLITE_OK) return false;
+    sqlite3_bind_int(stmt, 1, class_id);
+    sqlite3_bind_text(stmt, 2, date, -1, SQLITE_STATIC);
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        implied = sqlite3_column_int(stmt, 0);
+    }
+    sqlite3_finalize(stmt);
+    if (implied == 0) return true;
+
+    if (sqlite3_prepare_v2(g_db, student_sql, -1, &stmt, NULL) != SQLITE_OK) return false;
+    sqlite3_bind_int(stmt, 1, class_id);
+    sqlite3_bind_text(stmt, 2, date, -1, SQLITE_STATIC);
+    bool ok = sqlite3_step(stmt) == SQLITE_DONE;
+    sqlite3_finalize(stmt);
+
+    RollupWriter writer;
+    if (!ok || !db_rollup_writer_open(&writer)) return false;
+    int counts[3] = {0, 0, 0};
+    counts[ATTENDANCE_PRESENT] = implied;
+    for (int t = ROLLUP_CLASS_DAY; ok && t <= ROLLUP_CLASS_MONTH; t++) {
+        ok = bump(&writer, (RollupTable)t, class_id, date, counts);
+    }
+    db_rollup_writer_close(&writer);
+    return ok;
+}
+
+// Every status of the class's students on the bulk dates, as
+// db_get_attendance_sheet sees it (?1 is the class)
+#define CLASS_DAY_STATUS_SQL \
+    "SELECT a.student_id, a.date, a.status FROM temp.bulk_dates d " \
+    "INNER JOIN attendance a ON a.date = d.date " \
+    "INNER JOIN students s ON s.id = a.student_id WHERE s.class_id = ?1 " \
+    "UNION ALL " \
+    "SELECT s.id, ses.date, 1 FROM temp.bulk_dates d " \
+    "INNER JOIN attendance_sessions ses ON ses.class_id = ?1 AND ses.date = d.date " \
+    "INNER JOIN students s ON s.class_id = ses.class_id " \
+    "WHERE ses.sparse = 1 AND NOT EXISTS (SELECT 1 FROM attendance a " \
+    "WHERE a.student_id = s.id AND a.date = ses.date)"
+
+// The whole months the bulk dates fall in, as one [start, end) range of
+// dates, and the test for a date in one of those months
+#define BULK_MONTHS_SPAN_SQL \
+    "SELECT date(MIN(date), 'start of month') AS start, " \
+    "date(MAX(date), 'start of month', '+1 month') AS end FROM temp.bulk_dates"
+#define IN_BULK_MONTHS_SQL(date) \
+    "strftime('%Y-%m', " date ") IN (SELECT strftime('%Y-%m', date) FROM temp.bulk_dates)"
+
+#define ROLLUP_UPSERT_SQL(key) \
+    " ON CONFLICT (" key ", period) DO UPDATE SET present = present + excluded.present, " \
+    "absent = absent + excluded.absent, late = late + excluded.late;"
+
+static bool exec_class_sql(const char *sql, int class_id, int sign) {
+    sqlite3_stmt *stmt;
+    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+        fprintf(stderr, "Rollup update failed: %s\n", sqlite3_errmsg(g_db));
+        return false;
+    }
+    sqlite3_bind_int(stmt, 1, class_id);
+    if (sign) sqlite3_bind_int(stmt, 2, sign);
+    bool ok = sqlite3_step(stmt) == SQLITE_DONE;
+    sqlite3_finalize(stmt);
+    return ok;
+}
+
+// Student months move by each student's status on the days
+static bool move_student_months(int class_id, int sign) {
+    const char *sql =
+        "INSERT INTO attendance_rollup_student_month (student_id, period, present, absent, late) "
+        "SELECT day.student_id, strftime('%Y-%m', day.date), ?2 * SUM(day.status = 1), "
+        "?2 * SUM(day.status = 0), ?2 * SUM(day.status = 2) "
+        "FROM (" CLASS_DAY_STATUS_SQL ") day WHERE true GROUP BY 1, 2"
+        ROLLUP_UPSERT_SQL("student_id");
+    return exec_class_sql(sql, class_id, sign);
+}
+
+// Class buckets give back exactly what the days added, whatever the class
+// looks like now
+static bool remove_class_buckets(int class_id) {
+    const char *week_sql =
+        "INSERT INTO attendance_rollup_class_week (class_id, period, present, absent, late) "
+        "SELECT class_id, date(period, '-6 days', 'weekday 1'), -SUM(present), -SUM(absent), -SUM(late) "
+        "FROM attendance_rollup_class_day "
+        "WHERE class_id = ?1 AND period IN (SELECT date FROM temp.bulk_dates) GROUP BY 1, 2"
+        ROLLUP_UPSERT_SQL("class_id");
+    const char *month_sql =
+        "INSERT INTO attendance_rollup_class_month (class_id, period, present, absent, late) "
+        "SELECT class_id, strftime('%Y-%m', period), -SUM(present), -SUM(absent), -SUM(late) "
+        "FROM attendance_rollup_class_day "
+        "WHERE class_id = ?1 AND period IN (SELECT date FROM temp.bulk_dates) GROUP BY 1, 2"
+        ROLLUP_UPSERT_SQL("class_id");
+    const char *day_sql = "DELETE FROM attendance_rollup_class_day "
+                         "WHERE class_id = ?1 AND period IN (SELECT date FROM temp.bulk_dates);";
+
+    return exec_class_sql(week_sql, class_id, 0) &&
+           exec_class_sql(month_sql, class_id, 0) &&
+           exec_class_sql(day_sql, class_id, 0);
+}
+
+// Day, week and month buckets of the class from the statuses stored now
+static bool add_class_buckets(int class_id) {
+    static const char *periods[] = {
+        "day.date", "date(day.date, '-6 days', 'weekday 1')", "strftime('%Y-%m', day.date)",
+    };
+    bool ok = true;
+    for (int t = ROLLUP_CLASS_DAY; ok && t <= ROLLUP_CLASS_MONTH; t++) {
+        char sql[2048];
+        snprintf(sql, sizeof(sql),
+                 "INSERT INTO %s (class_id, period, present, absent, late) "
+                 "SELECT ?1, %s, SUM(day.status = 1), SUM(day.status = 0), SUM(day.status = 2) "
+                 "FROM (" CLASS_DAY_STATUS_SQL ") day WHERE true GROUP BY 2"
+                 ROLLUP_UPSERT_SQL("class_id"),
+                 ROLLUPS[t].table, periods[t]);
+        ok = exec_class_sql(sql, class_id, 0);
+    }
+    return ok;
+}
+
+bool db_rollup_remove_class_days(int class_id) {
+    if (!g_db) return false;
+    return move_student_months(class_id, -1) && remove_class_buckets(class_id);
+}
+
+bool db_rollup_add_class_days(int class_id) {
+    if (!g_db) return false;
+    return move_student_months(class_id, 1) && add_class_buckets(class_id);
+}
+
+bool db_rollup_refresh_class_days(int class_id) {
+    if (!g_db) return false;
+
+    // The class's students' months on those days, counted again from every
+    // row of the month, like db_rollup_rebuild does
+    const char *clear_sql =
+        "DELETE FROM attendance_rollup_student_month "
+        "WHERE student_id IN (SELECT id FROM students WHERE class_id = ?1) "
+        "AND period IN (SELECT strftime('%Y-%m', date) FROM temp.bulk_dates);";
+    const char *count_sql =
+        "INSERT INTO attendance_rollup_student_month (student_id, period, present, absent, late) "
+        "SELECT day.student_id, strftime('%Y-%m', day.date), SUM(day.status = 1), SUM(day.status = 0), "
+        "SUM(day.status = 2) FROM ("
+        "SELECT a.student_id, a.date, a.status FROM (" BULK_MONTHS_SPAN_SQL ") m "
+        "INNER JOIN students s ON s.class_id = ?1 "
+        "INNER JOIN attendance a ON a.student_id = s.id AND a.date >= m.start AND a.date < m.end "
+        "WHERE " IN_BULK_MONTHS_SQL("a.date") " "
+        "UNION ALL "
+        "SELECT s.id, ses.date, 1 FROM (" BULK_MONTHS_SPAN_SQL ") m "
+        "INNER JOIN attendance_sessions ses ON ses.class_id = ?1 AND ses.date >= m.start AND ses.date < m.end "
+        "INNER JOIN students s ON s.class_id = ses.class_id "
+        "WHERE " IN_BULK_MONTHS_SQL("ses.date") " AND ses.sparse = 1 AND NOT EXISTS (SELECT 1 FROM attendance a "
+        "WHERE a.student_id = s.id AND a.date = ses.date)"
+        ") day GROUP BY 1, 2;";
+
+    return remove_class_buckets(class_id) &&
+           exec_class_sql(clear_sql, class_id, 0) &&
+           exec_class_sql(count_sql, class_id, 0) &&
+           add_class_buckets(class_id);
+}
+
+bool db_rollup_rebuild(void) {
+    if (!g_db) return false;
+
+    const char *sql =
+        "DELETE FROM attendance_rollup_class_day;"
+        "DELETE FROM attendance_rollup_class_week;"
+        "DELETE FROM attendance_rollup_class_month;"
+        "DELETE FROM attendance_rollup_student_month;"
+        "INSERT INTO attendance_rollup_class_day (class_id, period, present, absent, late) "
+        "SELECT class_id, date, SUM(status = 1), SUM(status = 0), SUM(status = 2) FROM ("
+        "SELECT s.class_id, a.date, a.status FROM attendance a "
+        "INNER JOIN students s ON s.id = a.student_id "
+        "INNER JOIN classes c ON c.id = s.class_id "
+        "UNION ALL "
+        "SELECT ses.class_id, ses.date, 1 FROM attendance_sessions ses "
+        "INNER JOIN students s ON s.class_id = ses.class_id "
+        "WHERE ses.sparse = 1 AND NOT EXISTS (SELECT 1 FROM attendance a "
+        "WHERE a.student_id = s.id AND a.date = ses.date)"
+        ") GROUP BY class_id, date;"
+        "INSERT INTO attendance_rollup_class_week (class_id, period, present, absent, late) "
+        "SELECT class_id, date(period, '-6 days', 'weekday 1'), SUM(present), SUM(absent), SUM(late) "
+        "FROM attendance_rollup_class_day GROUP BY 1, 2;"
+        "INSERT INTO attendance_rollup_class_month (class_id, period, present, absent, late) "
+        "SELECT class_id, strftime('%Y-%m', period), SUM(present), SUM(absent), SUM(late) "
+        "FROM attendance_rollup_class_day GROUP BY 1, 2;"
+        "INSERT INTO attendance_rollup_student_month (student_id, period, present, absent, late) "
+        "SELECT student_id, strftime('%Y-%m', date), SUM(status = 1), SUM(status = 0), SUM(status = 2) FROM ("
+        "SELECT student_id, date, status FROM attendance "
+        "UNION ALL "
+        "SELECT s.id, ses.date, 1 FROM attendance_sessions ses "
+        "INNER JOIN students s ON s.class_id = ses.class_id "
+        "WHERE ses.sparse = 1 AND NOT EXISTS (SELECT 1 FROM attendance a "
+        "WHERE a.student_id = s.id AND a.date = ses.date)"
+        ") GROUP BY 1, 2;";
+    char *err_msg = NULL;
+
+    if (sqlite3_exec(g_db, sql, NULL, NULL, &err_msg) != SQLITE_OK) {
+        fprintf(stderr, "Rollup rebuild failed: %s\n", err_msg);
+        sqlite3_free(err_msg);
+        return false;
+    }
+    return true;
+}
+
+// Periods from from to to inclusive; NULL leaves that side open
+static AttendanceRollup** read_rollups(RollupTable table, int key, const char *from, const char *to,
+                                       int *count) {
+    if (!g_db || !count) return NULL;
+    *count = 0;
+
+    // Periods emptied by deletes keep a zero row until the next rebuild
+    char sql[256];
+    snprintf(sql, sizeof(sql),
+             "SELECT period, present, absent, late FROM %s "
+             "WHERE %s = ? AND period >= ? AND period <= ? "
+             "AND present + absent + late > 0 ORDER BY period;",
+             ROLLUPS[table].table, ROLLUPS[table].key);
+    sqlite3_stmt *stmt;
+
+    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+        return NULL;
+    }
+
+    sqlite3_bind_int(stmt, 1, key);
+    sqlite3_bind_text(stmt, 2, from ? from : "", -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 3, to ? to : "~", -1, SQLITE_STATIC);
+
+    int capacity = 32;
+    AttendanceRollup **rows = malloc(capacity * sizeof(AttendanceRollup*));
+    if (!rows) {
+        sqlite3_finalize(stmt);
+        return NULL;
+    }
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        if (*count >= capacity) {
+            capacity *= 2;
+            AttendanceRollup **temp = realloc(rows, capacity * sizeof(AttendanceRollup*));
+            if (!temp) {
+                db_free_rollups(rows, *count);
+                sqlite3_finalize(stmt);
+                *count = 0;
+                return NULL;
+            }
+            rows = temp;
+        }
+
+        AttendanceRollup *row = malloc(sizeof(AttendanceRollup));
+        if (!row) {
+            db_free_rollups(rows, *count);
+            sqlite3_finalize(stmt);
+            *count = 0;
+            return NULL;
+        }
+
+        const char *period = (const char *)sqlite3_column_text(stmt, 0);
+        strncpy(row->period, period ? period : "", sizeof(row->period) - 1);
+        row->period[sizeof(row->period) - 1] = '\0';
+        row->present = sqlite3_column_int(stmt, 1);
+        row->absent = sqlite3_column_int(stmt, 2);
+        row->late = sqlite3_column_int(stmt, 3);
+        rows[(*count)++] = row;
+    }
+
+    sqlite3_finalize(stmt);
+    return rows;
+}
+
+AttendanceRollup** db_get_class_rollup(int class_id, RollupTable table, int *count) {
+    return db_get_class_rollup_range(class_id, table, NULL, NULL, count);
+}
+
+AttendanceRollup** db_get_class_rollup_range(int class_id, RollupTable table,
+                                             const char *from, const char *to, int *count) {
+    if (table < ROLLUP_CLASS_DAY || table > ROLLUP_CLASS_MONTH) {
+        if (count) *count = 0;
+        return NULL;
+    }
+    return read_rollups(table, class_id, from, to, count);
+}
+
+AttendanceRollup** db_get_student_rollup(int student_id, int *count) {
+    return read_rollups(ROLLUP_STUDENT_MONTH, student_id, NULL, NULL, count);
+}
+
+void db_free_rollups(AttendanceRollup **rows, int count) {
+    if (rows) {
+        for (int i = 0; i < count; i++) {
+            free(rows[i]);
+        }
+        free(rows);
+    }
+}
@@ -0,0 +1,1012 @@
+#include "db_snapshot.h"
+#include "db_batch.h"
+#include "db_bulk.h"
+#include "validation.h"
+#include <stdint.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+static const char SNAPSHOT_MAGIC[8] = {'A', 'K', 'S', 'N', 'A', 'P', '\r', '\n'};
+#define SNAPSHOT_HEADER_SIZE 32
+#define SNAPSHOT_ZSTD_LEVEL 3
+#define SNAPSHOT_MAX_PAYLOAD ((uint64_t)1 << 32)   // largest payload a reader inflates
+#define SNAPSHOT_MAX_COLUMNS 8
+
+typedef enum {
+    SECTION_STRINGS = 1,
+    SECTION_CLASS,
+    SECTION_STUDENTS,
+    SECTION_ASSIGNMENTS,
+    SECTION_SUBMISSIONS,
+    SECTION_SESSIONS,
+    SECTION_ATTENDANCE,
+    SECTION_HOLIDAYS,
+    SECTION_COUNT
+} SnapshotSection;
+
+bool db_snapshot_has_zstd(void) {
+#ifdef HAVE_ZSTD
+    return true;
+#else
+    return false;
+#endif
+}
+
+// ---- Writing ----
+
+typedef struct {
+    uint8_t *data;
+    size_t size;
+    size_t capacity;
+    bool failed;           // an allocation failed; later writes are dropped
+} ByteBuffer;
+
+static bool buffer_reserve(ByteBuffer *b, size_t extra) {
+    if (b->failed) return false;
+    if (b->size + extra <= b->capacity) return true;
+    size_t capacity = b->capacity ? b->capacity : 4096;
+    while (capacity < b->size + extra) capacity *= 2;
+    uint8_t *grown = realloc(b->data, capacity);
+    if (!grown) {
+        b->failed = true;
+        return false;
+    }
+    b->data = grown;
+    b->capacity = capacity;
+    return true;
+}
+
+static void put_bytes(ByteBuffer *b, const void *data, size_t len) {
+    if (!buffer_reserve(b, len)) return;
+    memcpy(b->data + b->size, data, len);
+    b->size += len;
+}
+
+static void put_u32(ByteBuffer *b, uint32_t value) {
+    uint8_t bytes[4];
+    for (int i = 0; i < 4; i++) bytes[i] = (uint8_t)(value >> (8 * i));
+    put_bytes(b, bytes, 4);
+}
+
+static void put_u64(ByteBuffer *b, uint64_t value) {
+    uint8_t bytes[8];
+    for (int i = 0; i < 8; i++) bytes[i] = (uint8_t)(value >> (8 * i));
+    put_bytes(b, bytes, 8);
+}
+
+static void put_varint(ByteBuffer *b, uint64_t value) {
+    uint8_t bytes[10];
+    int n = 0;
+    while (value >= 0x80) {
+        bytes[n++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    bytes[n++] = (uint8_t)value;
+    put_bytes(b, bytes, n);
+}
+
+// FNV-1a over the payload, so damage that still parses is caught too
+static uint64_t payload_checksum(const uint8_t *data, size_t size) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static void buffer_free(ByteBuffer *b) {
+    free(b->data);
+    memset(b, 0, sizeof(*b));
+}
+
+// Distinct text values in first-seen order, found again through open
+// addressing with linear probing on FNV-1a hashes
+typedef struct {
+    ByteBuffer entries;    // varint length and bytes of each string
+    uint32_t *starts;      // [count] offset of each string's bytes in entries
+    uint32_t *lengths;     // [count]
+    uint32_t count;
+    uint32_t *slots;       // [slot_count] string index + 1, 0 for an empty slot
+    uint32_t slot_count;   // a power of two at least twice count
+} Dictionary;
+
+static uint32_t hash_text(const uint8_t *text, size_t len) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= text[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t* dict_slot(const Dictionary *d, const uint8_t *text, uint32_t len) {
+    uint32_t i = hash_text(text, len) & (d->slot_count - 1);
+    while (d->slots[i]) {
+        uint32_t entry = d->slots[i] - 1;
+        if (d->lengths[entry] == len &&
+            memcmp(d->entries.data + d->starts[entry], text, len) == 0) break;
+        i = (i + 1) & (d->slot_count - 1);
+    }
+    return &d->slots[i];
+}
+
+static bool dict_grow(Dictionary *d) {
+    uint32_t slot_count = d->slot_count ? d->slot_count * 2 : 1024;
+    uint32_t *starts = realloc(d->starts, (slot_count / 2) * sizeof(uint32_t));
+    if (starts) d->starts = starts;
+    uint32_t *lengths = realloc(d->lengths, (slot_count / 2) * sizeof(uint32_t));
+    if (lengths) d->lengths = lengths;
+    uint32_t *slots = calloc(slot_count, sizeof(uint32_t));
+    if (!starts || !lengths || !slots) {
+        free(slots);
+        return false;
+    }
+
+    free(d->slots);
+    d->slots = slots;
+    d->slot_count = slot_count;
+    for (uint32_t entry = 0; entry < d->count; entry++) {
+        *dict_slot(d, d->entries.data + d->starts[entry], d->lengths[entry]) = entry + 1;
+    }
+    return true;
+}
+
+// Index of text plus one, adding it if new; 0 for NULL or when out of memory
+// (d->entries.failed is set then)
+static uint64_t dict_intern(Dictionary *d, const uint8_t *text, int len) {
+    if (!text) return 0;
+    if (2 * (d->count + 1) > d->slot_count && !dict_grow(d)) {
+        d->entries.failed = true;
+        return 0;
+    }
+
+    uint32_t *slot = dict_slot(d, text, (uint32_t)len);
+    if (*slot) return *slot;
+
+    put_varint(&d->entries, (uint64_t)len);
+    d->starts[d->count] = (uint32_t)d->entries.size;
+    d->lengths[d->count] = (uint32_t)len;
+    put_bytes(&d->entries, text, len);
+    if (d->entries.failed || d->entries.size > UINT32_MAX) {
+        d->entries.failed = true;
+        return 0;
+    }
+    *slot = ++d->count;
+    return *slot;
+}
+
+static void dict_free(Dictionary *d) {
+    buffer_free(&d->entries);
+    free(d->starts);
+    free(d->lengths);
+    free(d->slots);
+    memset(d, 0, sizeof(*d));
+}
+
+// Positions of a class's students or assignments in snapshot order, sorted
+// by id, for turning references into positions
+typedef struct {
+    int id;
+    int position;
+} IdPosition;
+
+typedef struct {
+    IdPosition *ids;       // [count]
+    int count;
+} IdList;
+
+static int compare_ids(const void *a, const void *b) {
+    const IdPosition *ia = a;
+    const IdPosition *ib = b;
+    return (ia->id > ib->id) - (ia->id < ib->id);
+}
+
+// sql selects the ids in the order the section lists the rows
+static bool id_list_load(IdList *list, const char *sql, int class_id) {
+    sqlite3_stmt *stmt;
+    int capacity = 0;
+
+    memset(list, 0, sizeof(*list));
+    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) return false;
+    sqlite3_bind_int(stmt, 1, class_id);
+
+    bool ok = true;
+    while (ok && sqlite3_step(stmt) == SQLITE_ROW) {
+        if (list->count == capacity) {
+            capacity = capacity ? capacity * 2 : 256;
+            IdPosition *grown = realloc(list->ids, capacity * sizeof(IdPosition));
+            if (!grown) {
+                ok = false;
+                break;
+            }
+            list->ids = grown;
+        }
+        list->ids[list->count].id = sqlite3_column_int(stmt, 0);
+        list->ids[list->count].position = list->count;
+        list->count++;
+    }
+    sqlite3_finalize(stmt);
+    if (ok && list->count > 0) qsort(list->ids, list->count, sizeof(IdPosition), compare_ids);
+    return ok;
+}
+
+// Position of id in the section, or -1
+static int id_list_find(const IdList *list, int id) {
+    IdPosition key = {id, 0};
+    const IdPosition *found = list->count > 0 ?
+        bsearch(&key, list->ids, list->count, sizeof(IdPosition), compare_ids) : NULL;
+    return found ? found->position : -1;
+}
+
+typedef struct {
+    Dictionary strings;
+    IdList students;
+    IdList assignments;
+    ByteBuffer tables;     // every section but the strings
+} SnapshotWriter;
+
+static uint64_t zigzag(int64_t value) {
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+// Append the rows of sql (bound to class_id) as a table section. Each letter
+// of kinds gives a column's kind: 'i' integer, 't' text, 's' a student id
+// and 'a' an assignment id, written as positions. Rows referring to a
+// student or assignment outside the class are left out.
+static bool write_table(SnapshotWriter *w, SnapshotSection tag, const char *sql,
+                        int class_id, const char *kinds) {
+    int columns = (int)strlen(kinds);
+    ByteBuffer data[SNAPSHOT_MAX_COLUMNS] = {{0}};
+    int64_t previous[SNAPSHOT_MAX_COLUMNS] = {0};
+    int64_t values[SNAPSHOT_MAX_COLUMNS];
+    uint32_t rows = 0;
+    sqlite3_stmt *stmt;
+
+    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+        fprintf(stderr, "Failed to prepare snapshot query: %s\n", sqlite3_errmsg(g_db));
+        return false;
+    }
+    sqlite3_bind_int(stmt, 1, class_id);
+
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        bool skip = false;
+        for (int c = 0; c < columns && !skip; c++) {
+            switch (kinds[c]) {
+                case 't':
+                    values[c] = (int64_t)dict_intern(&w->strings, sqlite3_column_text(stmt, c),
+                                                     sqlite3_column_bytes(stmt, c));
+                    break;
+                case 's':
+                    values[c] = id_list_find(&w->students, sqlite3_column_int(stmt, c));
+                    skip = values[c] < 0;
+                    break;
+                case 'a':
+                    values[c] = id_list_find(&w->assignments, sqlite3_column_int(stmt, c));
+                    skip = values[c] < 0;
+                    break;
+                default:
+                    values[c] = sqlite3_column_int64(stmt, c);
+                    break;
+            }
+        }
+        if (skip) continue;
+
+        for (int c = 0; c < columns; c++) {
+            if (kinds[c] == 't') {
+                put_varint(&data[c], (uint64_t)values[c]);
+            } else {
+                put_varint(&data[c], zigzag(values[c] - previous[c]));
+                previous[c] = values[c];
+            }
+        }
+        rows++;
+    }
+    sqlite3_finalize(stmt);
+
+    bool ok = rc == SQLITE_DONE && !w->strings.entries.failed;
+    if (!ok) fprintf(stderr, "Snapshot query failed: %s\n", sqlite3_errmsg(g_db));
+
+    uint64_t length = 8;
+    for (int c = 0; c < columns; c++) {
+        ok = ok && !data[c].failed;
+        length += 8 + data[c].size;
+    }
+    if (ok) {
+        put_u32(&w->tables, tag);
+        put_u64(&w->tables, length);
+        put_u32(&w->tables, rows);
+        put_u32(&w->tables, (uint32_t)columns);
+        for (int c = 0; c < columns; c++) {
+            put_u64(&w->tables, data[c].size);
+            put_bytes(&w->tables, data[c].data, data[c].size);
+        }
+        ok = !w->tables.failed;
+    }
+    for (int c = 0; c < columns; c++) buffer_free(&data[c]);
+    return ok;
+}
+
+static bool write_class_tables(SnapshotWriter *w, int class_id) {
+    return write_table(w, SECTION_CLASS,
+                       "SELECT name, description, attendance_mode FROM classes WHERE id = ?1;",
+                       class_id, "tti") &&
+           write_table(w, SECTION_STUDENTS,
+                       "SELECT name, email, roll_number, phone, created_at FROM students "
+                       "WHERE class_id = ?1 ORDER BY roll_number;",
+                       class_id, "ttttt") &&
+           write_table(w, SECTION_ASSIGNMENTS,
+                       "SELECT title, subject, description, due_date, created_at FROM assignments "
+                       "WHERE class_id = ?1 ORDER BY due_date, id;",
+                       class_id, "ttttt") &&
+           write_table(w, SECTION_SUBMISSIONS,
+                       "SELECT sub.assignment_id, sub.student_id, sub.status, sub.quality, "
+                       "sub.submitted_at, sub.notes FROM assignments a "
+                       "INNER JOIN assignment_submissions sub ON sub.assignment_id = a.id "
+                       "WHERE a.class_id = ?1 ORDER BY a.due_date, a.id, sub.student_id;",
+                       class_id, "asiitt") &&
+           write_table(w, SECTION_SESSIONS,
+                       "SELECT date, sparse FROM attendance_sessions WHERE class_id = ?1 ORDER BY date;",
+                       class_id, "ti") &&
+           write_table(w, SECTION_ATTENDANCE,
+                       "SELECT a.student_id, a.date, a.status, a.notes FROM students s "
+                       "INNER JOIN attendance a ON a.student_id = s.id "
+                       "WHERE s.class_id = ?1 ORDER BY s.roll_number, s.id, a.date;",
+                       class_id, "stit") &&
+           write_table(w, SECTION_HOLIDAYS,
+                       "SELECT date, name FROM class_holidays WHERE class_id = ?1 ORDER BY date;",
+                       class_id, "tt");
+}
+
+// The payload: the strings section, then the tables
+static bool build_payload(SnapshotWriter *w, ByteBuffer *payload) {
+    ByteBuffer count = {0};
+    put_varint(&count, w->strings.count);
+
+    put_u32(payload, SECTION_STRINGS);
+    put_u64(payload, count.size + w->strings.entries.size);
+    put_bytes(payload, count.data, count.size);
+    put_bytes(payload, w->strings.entries.data, w->strings.entries.size);
+    put_bytes(payload, w->tables.data, w->tables.size);
+    bool ok = !count.failed && !payload->failed;
+    buffer_free(&count);
+    return ok;
+}
+
+long db_snapshot_export(const char *path, int class_id, bool compress) {
+    if (!g_db || !path || class_id <= 0) return -1;
+
+    Class *cls = db_get_class_by_id(class_id);
+    if (!cls) return -1;
+    free(cls);
+
+    // One read transaction, so the sections agree with each other
+    SnapshotWriter w;
+    memset(&w, 0, sizeof(w));
+    ByteBuffer payload = {0};
+    ByteBuffer file_data = {0};
+    bool ok = db_begin() &&
+              id_list_load(&w.students, "SELECT id FROM students WHERE class_id = ?1 "
+                           "ORDER BY roll_number;", class_id) &&
+              id_list_load(&w.assignments, "SELECT id FROM assignments WHERE class_id = ?1 "
+                           "ORDER BY due_date, id;", class_id) &&
+              write_class_tables(&w, class_id) &&
+              build_payload(&w, &payload);
+    db_rollback();
+
+    uint32_t flags = 0;
+    const ByteBuffer *body = &payload;
+#ifdef HAVE_ZSTD
+    if (ok && compress) {
+        size_t bound = ZSTD_compressBound(payload.size);
+        if (buffer_reserve(&file_data, bound)) {
+            size_t size = ZSTD_compress(file_data.data, bound, payload.data, payload.size,
+                                        SNAPSHOT_ZSTD_LEVEL);
+            if (ZSTD_isError(size)) {
+                fprintf(stderr, "Snapshot compression failed: %s\n", ZSTD_getErrorName(size));
+                ok = false;
+            }
+            file_data.size = size;
+            flags |= SNAPSHOT_ZSTD;
+            body = &file_data;
+        } else {
+            ok = false;
+        }
+    }
+#else
+    (void)compress;
+#endif
+
+    long written = -1;
+    if (ok) {
+        ByteBuffer header = {0};
+        put_bytes(&header, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+        put_u32(&header, SNAPSHOT_VERSION);
+        put_u32(&header, flags);
+        put_u64(&header, payload.size);
+        put_u64(&header, payload_checksum(payload.data, payload.size));
+
+        FILE *file = fopen(path, "wb");
+        if (!file) {
+            fprintf(stderr, "Cannot write %s\n", path);
+        } else {
+            bool written_ok = !header.failed &&
+                              fwrite(header.data, 1, header.size, file) == header.size &&
+                              fwrite(body->data, 1, body->size, file) == body->size;
+            if (fclose(file) == 0 && written_ok) {
+                written = (long)(header.size + body->size);
+            } else {
+                fprintf(stderr, "Failed to write %s\n", path);
+                remove(path);
+            }
+        }
+        buffer_free(&header);
+    }
+
+    buffer_free(&file_data);
+    buffer_free(&payload);
+    buffer_free(&w.tables);
+    dict_free(&w.strings);
+    free(w.students.ids);
+    free(w.assignments.ids);
+    return written;
+}
+
+// ---- Reading ----
+
+// A read-only mapping of a whole file
+typedef struct {
+    const uint8_t *data;
+    size_t size;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+} MappedFile;
+
+#ifdef _WIN32
+static bool map_file(MappedFile *m, const char *path) {
+    memset(m, 0, sizeof(*m));
+    m->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                          FILE_ATTRIBUTE_NORMAL, NULL);
+    if (m->file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m->file, &size) || size.QuadPart == 0) {
+        CloseHandle(m->file);
+        return false;
+    }
+    m->size = (size_t)size.QuadPart;
+    m->mapping = CreateFileMappingA(m->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (m->mapping) m->data = MapViewOfFile(m->mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!m->data) {
+        if (m->mapping) CloseHandle(m->mapping);
+        CloseHandle(m->file);
+        return false;
+    }
+    return true;
+}
+
+static void unmap_file(MappedFile *m) {
+    UnmapViewOfFile(m->data);
+    CloseHandle(m->mapping);
+    CloseHandle(m->file);
+}
+#else
+static bool map_file(MappedFile *m, const char *path) {
+    memset(m, 0, sizeof(*m));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return false;
+    m->data = data;
+    m->size = (size_t)st.st_size;
+    return true;
+}
+
+static void unmap_file(MappedFile *m) {
+    munmap((void *)m->data, m->size);
+}
+#endif
+
+// Bounds-checked cursor over part of the payload; any read past the end
+// sets failed and returns 0
+typedef struct {
+    const uint8_t *p;
+    const uint8_t *end;
+    bool failed;
+} Reader;
+
+static uint64_t get_fixed(Reader *r, int bytes) {
+    if (r->end - r->p < bytes) {
+        r->failed = true;
+        r->p = r->end;
+        return 0;
+    }
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++) value |= (uint64_t)r->p[i] << (8 * i);
+    r->p += bytes;
+    return value;
+}
+
+static uint64_t get_varint(Reader *r) {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (r->p == r->end) break;
+        uint8_t byte = *r->p++;
+        value |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return value;
+    }
+    r->failed = true;
+    r->p = r->end;
+    return 0;
+}
+
+// Take the next len bytes as a reader of their own
+static Reader get_part(Reader *r, uint64_t len) {
+    Reader part = {r->p, r->p, false};
+    if ((uint64_t)(r->end - r->p) < len) {
+        r->failed = true;
+        part.failed = true;
+        r->p = r->end;
+        return part;
+    }
+    part.end = r->p + len;
+    r->p += len;
+    return part;
+}
+
+typedef struct {
+    const uint8_t *text;
+    uint32_t length;
+} SnapshotString;
+
+typedef struct {
+    MappedFile file;
+    uint8_t *inflated;                 // the decompressed payload, if compressed
+    Reader sections[SECTION_COUNT];    // where each known section lies
+    bool present[SECTION_COUNT];
+    SnapshotString *strings;           // [string_count]
+    uint64_t string_count;
+} SnapshotReader;
+
+// A table section, read column by column as rows are asked for
+typedef struct {
+    uint32_t rows;
+    Reader columns[SNAPSHOT_MAX_COLUMNS];
+    int64_t previous[SNAPSHOT_MAX_COLUMNS];
+    const SnapshotReader *snapshot;
+    bool failed;
+} TableReader;
+
+static void fail(SnapshotReport *report, const char *message) {
+    if (!report->failure[0]) snprintf(report->failure, sizeof(report->failure), "%s", message);
+}
+
+static bool read_payload(SnapshotReader *s, SnapshotReport *report) {
+    const uint8_t *data = s->file.data;
+    if (s->file.size < SNAPSHOT_HEADER_SIZE || memcmp(data, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+        fail(report, "The file is not a class snapshot");
+        return false;
+    }
+
+    Reader header = {data + sizeof(SNAPSHOT_MAGIC), data + SNAPSHOT_HEADER_SIZE, false};
+    uint32_t version = (uint32_t)get_fixed(&header, 4);
+    uint32_t flags = (uint32_t)get_fixed(&header, 4);
+    uint64_t payload_size = get_fixed(&header, 8);
+    uint64_t checksum = get_fixed(&header, 8);
+    if (version == 0 || version > SNAPSHOT_VERSION) {
+        fail(report, "The snapshot was written by a newer version of the application");
+        return false;
+    }
+    if (flags & ~SNAPSHOT_ZSTD) {
+        fail(report, "The snapshot uses features this version does not know");
+        return false;
+    }
+
+    Reader payload = {data + SNAPSHOT_HEADER_SIZE, data + s->file.size, false};
+    if (flags & SNAPSHOT_ZSTD) {
+#ifdef HAVE_ZSTD
+        size_t compressed = s->file.size - SNAPSHOT_HEADER_SIZE;
+        unsigned long long frame_size = ZSTD_getFrameContentSize(payload.p, compressed);
+        if (frame_size != payload_size || payload_size > SNAPSHOT_MAX_PAYLOAD ||
+            !(s->inflated = malloc(payload_size ? payload_size : 1))) {
+            fail(report, "The snapshot is damaged");
+            return false;
+        }
+        size_t size = ZSTD_decompress(s->inflated, payload_size, payload.p, compressed);
+        if (ZSTD_isError(size) || size != payload_size) {
+            fail(report, "The snapshot is damaged");
+            return false;
+        }
+        payload.p = s->inflated;
+        payload.end = s->inflated + payload_size;
+#else
+        fail(report, "The snapshot is compressed, and this build has no zstd support");
+        return false;
+#endif
+    } else if (payload_size != s->file.size - SNAPSHOT_HEADER_SIZE) {
+        fail(report, "The snapshot is damaged");
+        return false;
+    }
+    if (payload_checksum(payload.p, payload_size) != checksum) {
+        fail(report, "The snapshot is damaged");
+        return false;
+    }
+
+    while (payload.p < payload.end && !payload.failed) {
+        uint32_t tag = (uint32_t)get_fixed(&payload, 4);
+        uint64_t length = get_fixed(&payload, 8);
+        Reader section = get_part(&payload, length);
+        if (tag > 0 && tag < SECTION_COUNT) {
+            s->sections[tag] = section;
+            s->present[tag] = true;
+        }
+    }
+    if (payload.failed || !s->present[SECTION_STRINGS] || !s->present[SECTION_CLASS] ||
+        !s->present[SECTION_STUDENTS]) {
+        fail(report, "The snapshot is damaged");
+        return false;
+    }
+
+    // Each string takes at least its length byte, which bounds the count
+    Reader strings = s->sections[SECTION_STRINGS];
+    s->string_count = get_varint(&strings);
+    if (s->string_count > (uint64_t)(strings.end - strings.p) ||
+        !(s->strings = malloc((s->string_count ? s->string_count : 1) * sizeof(SnapshotString)))) {
+        fail(report, "The snapshot is damaged");
+        return false;
+    }
+    for (uint64_t i = 0; i < s->string_count && !strings.failed; i++) {
+        uint64_t length = get_varint(&strings);
+        Reader text = get_part(&strings, length);
+        s->strings[i].text = text.p;
+        s->strings[i].length = (uint32_t)length;
+    }
+    if (strings.failed) {
+        fail(report, "The snapshot is damaged");
+        return false;
+    }
+    return true;
+}
+
+static void snapshot_close(SnapshotReader *s) {
+    free(s->strings);
+    free(s->inflated);
+    if (s->file.data) unmap_file(&s->file);
+}
+
+// Open a table with at least the given columns; a missing optional section
+// reads as empty
+static bool table_open(TableReader *t, const SnapshotReader *s, SnapshotSection tag, int columns) {
+    memset(t, 0, sizeof(*t));
+    t->snapshot = s;
+    if (!s->present[tag]) return true;
+
+    Reader section = s->sections[tag];
+    t->rows = (uint32_t)get_fixed(&section, 4);
+    uint32_t stored = (uint32_t)get_fixed(&section, 4);
+    if (stored < (uint32_t)columns) return false;
+    for (uint32_t c = 0; c < stored; c++) {
+        Reader column = get_part(&section, get_fixed(&section, 8));
+        if (c < SNAPSHOT_MAX_COLUMNS) t->columns[c] = column;
+    }
+    return !section.failed;
+}
+
+static int64_t table_int(TableReader *t, int c) {
+    uint64_t value = get_varint(&t->columns[c]);
+    t->previous[c] += (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+    t->failed |= t->columns[c].failed;
+    return t->previous[c];
+}
+
+// A position in [0, count), or -1 (and the table fails)
+static int table_ref(TableReader *t, int c, int count) {
+    int64_t value = table_int(t, c);
+    if (value < 0 || value >= count) {
+        t->failed = true;
+        return -1;
+    }
+    return (int)value;
+}
+
+static const SnapshotString* table_text(TableReader *t, int c) {
+    uint64_t index = get_varint(&t->columns[c]);
+    t->failed |= t->columns[c].failed;
+    if (index == 0) return NULL;
+    if (index > t->snapshot->string_count) {
+        t->failed = true;
+        return NULL;
+    }
+    return &t->snapshot->strings[index - 1];
+}
+
+static void bind_text(sqlite3_stmt *stmt, int param, const SnapshotString *text) {
+    if (text) {
+        sqlite3_bind_text(stmt, param, (const char *)text->text, (int)text->length, SQLITE_STATIC);
+    } else {
+        sqlite3_bind_null(stmt, param);
+    }
+}
+
+// A YYYY-MM-DD date, copied into date
+static bool text_date(const SnapshotString *text, char date[11]) {
+    if (!text || text->length != 10) return false;
+    memcpy(date, text->text, 10);
+    date[10] = '\0';
+    return validate_date(date);
+}
+
+// Step a bound insert and reset it for the next row
+static bool step_insert(sqlite3_stmt *stmt) {
+    int rc = sqlite3_step(stmt);
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    return rc == SQLITE_DONE;
+}
+
+static bool import_class(TableReader *t, int teacher_id, SnapshotReport *report) {
+    const char *sql = "INSERT INTO classes (name, description, teacher_id, attendance_mode) "
+                     "VALUES (?, ?, ?, ?);";
+    sqlite3_stmt *stmt;
+
+    if (t->rows != 1 || sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) return false;
+    bind_text(stmt, 1, table_text(t, 0));
+    bind_text(stmt, 2, table_text(t, 1));
+    sqlite3_bind_int(stmt, 3, teacher_id);
+    int64_t mode = table_int(t, 2);
+    sqlite3_bind_int(stmt, 4, mode == ATTENDANCE_STORE_SPARSE ? ATTENDANCE_STORE_SPARSE : ATTENDANCE_STORE_FULL);
+    bool ok = !t->failed && step_insert(stmt);
+    sqlite3_finalize(stmt);
+    if (ok) report->class_id = (int)sqlite3_last_insert_rowid(g_db);
+    return ok;
+}
+
+static bool import_students(TableReader *t, int class_id, int *ids, SnapshotReport *report) {
+    const char *sql = "INSERT INTO students (name, email, roll_number, phone, class_id, created_at) "
+                     "VALUES (?, ?, ?, ?, ?, COALESCE(?, CURRENT_TIMESTAMP));";
+    sqlite3_stmt *stmt;
+
+    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) return false;
+    bool ok = true;
+    for (uint32_t row = 0; ok && row < t->rows; row++) {
+        const SnapshotString *email = table_text(t, 1);
+        const SnapshotString *roll = table_text(t, 2);
+        bind_text(stmt, 1, table_text(t, 0));
+        bind_text(stmt, 2, email);
+        bind_text(stmt, 3, roll);
+        bind_text(stmt, 4, table_text(t, 3));
+        sqlite3_bind_int(stmt, 5, class_id);
+        bind_text(stmt, 6, table_text(t, 4));
+        if (t->failed) break;
+
+        ok = step_insert(stmt);
+        if (!ok && sqlite3_extended_errcode(g_db) == SQLITE_CONSTRAINT_UNIQUE && email && roll) {
+            snprintf(report->failure, sizeof(report->failure),
+                     "A student with email %.*s or roll number %.*s is already registered",
+                     (int)(email->length < 60 ? email->length : 60), (const char *)email->text,
+                     (int)(roll->length < 40 ? roll->length : 40), (const char *)roll->text);
+        }
+        ids[row] = (int)sqlite3_last_insert_rowid(g_db);
+    }
+    sqlite3_finalize(stmt);
+    report->students = ok ? (int)t->rows : 0;
+    return ok && !t->failed;
+}
+
+static bool import_assignments(TableReader *t, int class_id, int teacher_id, int *ids,
+                               SnapshotReport *report) {
+    const char *sql = "INSERT INTO assignments (title, subject, description, due_date, created_by, "
+                     "class_id, created_at) VALUES (?, ?, ?, ?, ?, ?, COALESCE(?, CURRENT_TIMESTAMP));";
+    sqlite3_stmt *stmt;
+
+    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) return false;
+    bool ok = true;
+    for (uint32_t row = 0; ok && row < t->rows; row++) {
+        bind_text(stmt, 1, table_text(t, 0));
+        bind_text(stmt, 2, table_text(t, 1));
+        bind_text(stmt, 3, table_text(t, 2));
+        bind_text(stmt, 4, table_text(t, 3));
+        sqlite3_bind_int(stmt, 5, teacher_id);
+        sqlite3_bind_int(stmt, 6, class_id);
+        bind_text(stmt, 7, table_text(t, 4));
+        if (t->failed) break;
+        ok = step_insert(stmt);
+        ids[row] = (int)sqlite3_last_insert_rowid(g_db);
+    }
+    sqlite3_finalize(stmt);
+    report->assignments = ok ? (int)t->rows : 0;
+    return ok && !t->failed;
+}
+
+static bool import_submissions(TableReader *t, const int *students, int student_count,
+                               const int *assignments, int assignment_count, SnapshotReport *report) {
+    const char *sql = "INSERT INTO assignment_submissions (assignment_id, student_id, status, quality, "
+                     "submitted_at, notes) VALUES (?, ?, ?, ?, ?, ?);";
+    sqlite3_stmt *stmt;
+
+    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) return false;
+    bool ok = true;
+    for (uint32_t row = 0; ok && row < t->rows; row++) {
+        int assignment = table_ref(t, 0, assignment_count);
+        int student = table_ref(t, 1, student_count);
+        int64_t status = table_int(t, 2);
+        int64_t quality = table_int(t, 3);
+        const SnapshotString *submitted_at = table_text(t, 4);
+        const SnapshotString *notes = table_text(t, 5);
+        if (t->failed || status < SUBMISSION_NONE || status > SUBMISSION_LATE ||
+            quality < QUALITY_POOR || quality > QUALITY_HIGH) {
+            t->failed = true;
+            break;
+        }
+        sqlite3_bind_int(stmt, 1, assignments[assignment]);
+        sqlite3_bind_int(stmt, 2, students[student]);
+        sqlite3_bind_int(stmt, 3, (int)status);
+        sqlite3_bind_int(stmt, 4, (int)quality);
+        bind_text(stmt, 5, submitted_at);
+        bind_text(stmt, 6, notes);
+        ok = step_insert(stmt);
+    }
+    sqlite3_finalize(stmt);
+    report->submissions = ok ? (int)t->rows : 0;
+    return ok && !t->failed;
+}
+
+// Also returns the first and last day, for the rollup refresh
+static bool import_sessions(TableReader *t, int class_id, char from[11], char to[11]) {
+    const char *sql = "INSERT INTO attendance_sessions (class_id, date, sparse) VALUES (?, ?, ?);";
+    sqlite3_stmt *stmt;
+
+    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) return false;
+    bool ok = true;
+    for (uint32_t row = 0; ok && row < t->rows; row++) {
+        char date[11];
+        bool valid = text_date(table_text(t, 0), date);
+        int64_t sparse = table_int(t, 1);
+        if (t->failed || !valid || (sparse != 0 && sparse != 1)) {
+            t->failed = true;
+            break;
+        }
+        if (!from[0] || strcmp(date, from) < 0) memcpy(from, date, 11);
+        if (!to[0] || strcmp(date, to) > 0) memcpy(to, date, 11);
+        sqlite3_bind_int(stmt, 1, class_id);
+        sqlite3_bind_text(stmt, 2, date, -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int(stmt, 3, (int)sparse);
+        ok = step_insert(stmt);
+    }
+    sqlite3_finalize(stmt);
+    return ok && !t->failed;
+}
+
+static bool import_attendance(TableReader *t, const int *students, int student_count,
+                              SnapshotReport *report) {
+    const char *sql = "INSERT INTO attendance (student_id, date, status, notes) VALUES (?, ?, ?, ?);";
+    sqlite3_stmt *stmt;
+
+    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) return false;
+    bool ok = true;
+    for (uint32_t row = 0; ok && row < t->rows; row++) {
+        int student = table_ref(t, 0, student_count);
+        char date[11];
+        bool valid = text_date(table_text(t, 1), date);
+        int64_t status = table_int(t, 2);
+        const SnapshotString *notes = table_text(t, 3);
+        if (t->failed || !valid || status < ATTENDANCE_ABSENT || status > ATTENDANCE_LATE) {
+            t->failed = true;
+            break;
+        }
+        sqlite3_bind_int(stmt, 1, students[student]);
+        sqlite3_bind_text(stmt, 2, date, -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int(stmt, 3, (int)status);
+        bind_text(stmt, 4, notes);
+        ok = step_insert(stmt);
+    }
+    sqlite3_finalize(stmt);
+    report->marks = ok ? (int)t->rows : 0;
+    return ok && !t->failed;
+}
+
+static bool import_holidays(TableReader *t, int class_id) {
+    const char *sql = "INSERT INTO class_holidays (class_id, date, name) VALUES (?, ?, ?);";
+    sqlite3_stmt *stmt;
+
+    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) != SQLITE_OK) return false;
+    bool ok = true;
+    for (uint32_t row = 0; ok && row < t->rows; row++) {
+        char date[11];
+        bool valid = text_date(table_text(t, 0), date);
+        const SnapshotString *name = table_text(t, 1);
+        if (t->failed || !valid) {
+            t->failed = true;
+            break;
+        }
+        sqlite3_bind_int(stmt, 1, class_id);
+        sqlite3_bind_text(stmt, 2, date, -1, SQLITE_TRANSIENT);
+        bind_text(stmt, 3, name);
+        ok = step_insert(stmt);
+    }
+    sqlite3_finalize(stmt);
+    return ok && !t->failed;
+}
+
+// Insert every section in order, each table read straight from the payload
+static bool import_tables(const SnapshotReader *s, int teacher_id, SnapshotReport *report) {
+    TableReader t;
+    char from[11] = "", to[11] = "";
+
+    if (!table_open(&t, s, SECTION_CLASS, 3) || !import_class(&t, teacher_id, report)) return false;
+    int class_id = report->class_id;
+
+    if (!table_open(&t, s, SECTION_STUDENTS, 5) || t.rows > INT32_MAX) return false;
+    int student_count = (int)t.rows;
+    int *students = malloc((size_t)(student_count ? student_count : 1) * sizeof(int));
+    if (!students) return false;
+    bool ok = import_students(&t, class_id, students, report);
+
+    int *assignments = NULL;
+    int assignment_count = 0;
+    if (ok && (ok = table_open(&t, s, SECTION_ASSIGNMENTS, 5) && t.rows <= INT32_MAX)) {
+        assignment_count = (int)t.rows;
+        assignments = malloc((size_t)(assignment_count ? assignment_count : 1) * sizeof(int));
+        ok = assignments && import_assignments(&t, class_id, teacher_id, assignments, report);
+    }
+    ok = ok && table_open(&t, s, SECTION_SUBMISSIONS, 6) &&
+         import_submissions(&t, students, student_count, assignments, assignment_count, report);
+    ok = ok && table_open(&t, s, SECTION_SESSIONS, 2) && import_sessions(&t, class_id, from, to);
+    ok = ok && table_open(&t, s, SECTION_ATTENDANCE, 4) &&
+         import_attendance(&t, students, student_count, report);
+    ok = ok && table_open(&t, s, SECTION_HOLIDAYS, 2) && import_holidays(&t, class_id);
+
+    // The rollups and the bitmap index, inside the same transaction
+    if (ok && from[0]) ok = db_bulk_refresh_range(class_id, from, to) >= 0;
+
+    free(students);
+    free(assignments);
+    return ok;
+}
+
+bool db_snapshot_import(const char *path, int teacher_id, SnapshotReport *report) {
+    if (!report) return false;
+    memset(report, 0, sizeof(*report));
+    if (!g_db || !path || teacher_id <= 0) {
+        fail(report, "No database is open");
+        return false;
+    }
+
+    SnapshotReader s;
+    memset(&s, 0, sizeof(s));
+    if (!map_file(&s.file, path)) {
+        fail(report, "Cannot read the file");
+        return false;
+    }
+
+    bool ok = read_payload(&s, report);
+    if (ok) {
+        ok = db_begin() && import_tables(&s, teacher_id, report) && db_commit();
+        if (!ok) {
+            db_rollback();
+            fail(report, "The snapshot is damaged or could not be written to the database");
+            report->class_id = 0;
+            report->students = report->assignments = report->submissions = report->marks = 0;
+        }
+    }
+
+    snapshot_close(&s);
+    return ok;
+}
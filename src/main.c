@@ -1,4 +1,3 @@
-#include "common.h"
 #include "database.h"
 #include "ui_login.h"
 #include <gtk/gtk.h>
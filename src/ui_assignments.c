@@ -1,6 +1,8 @@
 #include "ui_assignments.h"
 #include "database.h"
+#include "db_batch.h"
 #include "validation.h"
+#include "ui_result_model.h"
 
 typedef struct {
     GtkWidget *window;
@@ -8,7 +10,6 @@ typedef struct {
     
     // Assignment List Tab
     GtkWidget *tree_view;
-    GtkListStore *list_store;
     
     // Create Assignment Tab
     GtkWidget *title_entry;
@@ -20,7 +21,9 @@ typedef struct {
     // Track Submissions Tab
     GtkWidget *assignment_combo;
     GtkWidget *tracking_header;
-    GtkWidget *submissions_box;
+    GtkWidget *grading_grid;
+    SubmissionSheetRow **grade_rows;       // owned by the grid's model
+    int grade_count;
     GtkWidget *save_all_btn;
     int selected_assignment_id;
     int has_unsaved_changes;
@@ -34,28 +37,50 @@ enum {
     NUM_ASSIGN_COLS
 };
 
+// Columns of the grading grid, read from aw->grade_rows
+enum {
+    GRADE_COL_INDEX = 0,
+    GRADE_COL_NAME,
+    GRADE_COL_ROLL,
+    GRADE_COL_STATUS,
+    GRADE_COL_QUALITY,
+    GRADE_COL_NOTES,
+    NUM_GRADE_COLS
+};
+
+static const GType ASSIGNMENT_COLUMN_TYPES[NUM_ASSIGN_COLS] = {
+    G_TYPE_INT, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING
+};
+
+// Cells come straight from the Assignment array the model holds; only the
+// due date is formatted, and only for rows the view draws
+static void get_assignment_cell(gpointer rows, int row, int column, GValue *value) {
+    Assignment *assignment = ((Assignment **)rows)[row];
+    switch (column) {
+        case COL_ASSIGN_ID: g_value_set_int(value, assignment->id); break;
+        case COL_ASSIGN_TITLE: g_value_set_static_string(value, assignment->title); break;
+        case COL_ASSIGN_SUBJECT: g_value_set_static_string(value, assignment->subject); break;
+        case COL_ASSIGN_DUE_DATE: {
+            char due_date_str[50];
+            format_datetime(assignment->due_date, due_date_str, sizeof(due_date_str));
+            g_value_set_string(value, due_date_str);
+            break;
+        }
+    }
+}
+
+static void free_assignment_rows(gpointer rows, int count) {
+    db_free_assignments(rows, count);
+}
+
 static void refresh_assignments_list(AssignmentsWindow *aw) {
-    gtk_list_store_clear(aw->list_store);
-    
     int count;
     Assignment **assignments = db_get_assignments_by_class(g_session.current_class_id, &count);
     
-    if (assignments) {
-        for (int i = 0; i < count; i++) {
-            char due_date_str[50];
-            format_datetime(assignments[i]->due_date, due_date_str, sizeof(due_date_str));
-            
-            GtkTreeIter iter;
-            gtk_list_store_append(aw->list_store, &iter);
-            gtk_list_store_set(aw->list_store, &iter,
-                             COL_ASSIGN_ID, assignments[i]->id,
-                             COL_ASSIGN_TITLE, assignments[i]->title,
-                             COL_ASSIGN_SUBJECT, assignments[i]->subject,
-                             COL_ASSIGN_DUE_DATE, due_date_str,
-                             -1);
-        }
-        db_free_assignments(assignments, count);
-    }
+    ResultModel *model = result_model_new(NUM_ASSIGN_COLS, ASSIGNMENT_COLUMN_TYPES, assignments, count,
+                                          get_assignment_cell, free_assignment_rows);
+    result_model_attach(GTK_TREE_VIEW(aw->tree_view), model);
+    g_object_unref(model);
 }
 
 static void on_create_assignment_clicked(GtkButton *button, gpointer user_data) {
@@ -163,62 +188,112 @@ static void on_delete_assignment_clicked(GtkButton *button, gpointer user_data)
     g_free(title);
 }
 
-static void on_submission_status_changed(GtkComboBox *combo, gpointer user_data) {
-    (void)user_data;
-    int student_id = GPOINTER_TO_INT(g_object_get_data(G_OBJECT(combo), "student_id"));
-    int assignment_id = GPOINTER_TO_INT(g_object_get_data(G_OBJECT(combo), "assignment_id"));
-    GtkWidget *quality_combo = GTK_WIDGET(g_object_get_data(G_OBJECT(combo), "quality_combo"));
-    GtkWidget *notes_entry = GTK_WIDGET(g_object_get_data(G_OBJECT(combo), "notes_entry"));
-    
-    int status = gtk_combo_box_get_active(GTK_COMBO_BOX(combo));
-    int quality = gtk_combo_box_get_active(GTK_COMBO_BOX(quality_combo));
-    const char *notes = gtk_entry_get_text(GTK_ENTRY(notes_entry));
-    
-    db_create_or_update_submission(assignment_id, student_id, 
-                                   (SubmissionStatus)status, 
-                                   (QualityAssessment)quality, 
-                                   notes);
+static const GType GRADE_COLUMN_TYPES[NUM_GRADE_COLS] = {
+    G_TYPE_INT, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING
+};
+
+// Combo choices, indexed by SubmissionStatus and QualityAssessment
+static const char *GRADE_STATUS_TEXT[] = {"No Submission", "Timely Submission", "Late Submission"};
+static const char *GRADE_QUALITY_TEXT[] = {"Poor", "Below Average", "Above Average", "High"};
+
+static void get_grade_cell(gpointer rows, int row, int column, GValue *value) {
+    SubmissionSheetRow *r = ((SubmissionSheetRow **)rows)[row];
+    switch (column) {
+        case GRADE_COL_INDEX: g_value_set_int(value, row); break;
+        case GRADE_COL_NAME: g_value_set_static_string(value, r->name); break;
+        case GRADE_COL_ROLL: g_value_set_static_string(value, r->roll_number); break;
+        case GRADE_COL_STATUS: g_value_set_static_string(value, GRADE_STATUS_TEXT[r->status]); break;
+        case GRADE_COL_QUALITY: g_value_set_static_string(value, GRADE_QUALITY_TEXT[r->quality]); break;
+        case GRADE_COL_NOTES: g_value_set_static_string(value, r->notes); break;
+    }
+}
+
+static void free_grade_rows(gpointer rows, int count) {
+    db_free_submission_sheet(rows, count);
+}
+
+static void mark_unsaved_changes(AssignmentsWindow *aw) {
+    aw->has_unsaved_changes = 1;
+    if (aw->save_all_btn) {
+        gtk_widget_set_sensitive(aw->save_all_btn, TRUE);
+    }
+}
+
+// Apply one cell edit to its row, redraw it and auto-save it
+typedef enum { GRADE_EDIT_STATUS, GRADE_EDIT_QUALITY, GRADE_EDIT_NOTES } GradeEdit;
+
+static void apply_grade_edit(AssignmentsWindow *aw, const gchar *path, const gchar *text, GradeEdit edit) {
+    GtkTreeModel *model = gtk_tree_view_get_model(GTK_TREE_VIEW(aw->grading_grid));
+    GtkTreeIter iter;
+    int index = -1;
+    if (gtk_tree_model_get_iter_from_string(model, &iter, path)) {
+        gtk_tree_model_get(model, &iter, GRADE_COL_INDEX, &index, -1);
+    }
+    if (index < 0 || index >= aw->grade_count) return;
+    
+    SubmissionSheetRow *row = aw->grade_rows[index];
+    switch (edit) {
+        case GRADE_EDIT_STATUS:
+            for (int i = 0; i < 3; i++) {
+                if (strcmp(text, GRADE_STATUS_TEXT[i]) == 0) row->status = (SubmissionStatus)i;
+            }
+            break;
+        case GRADE_EDIT_QUALITY:
+            for (int i = 0; i < 4; i++) {
+                if (strcmp(text, GRADE_QUALITY_TEXT[i]) == 0) row->quality = (QualityAssessment)i;
+            }
+            break;
+        case GRADE_EDIT_NOTES:
+            g_strlcpy(row->notes, text, sizeof(row->notes));
+            break;
+    }
+    
+    GtkTreePath *tree_path = gtk_tree_path_new_from_string(path);
+    gtk_tree_model_row_changed(model, tree_path, &iter);
+    gtk_tree_path_free(tree_path);
+    
+    db_create_or_update_submission(aw->selected_assignment_id, row->student_id,
+                                   row->status, row->quality, row->notes);
+    mark_unsaved_changes(aw);
+}
+
+static void on_grade_status_edited(GtkCellRendererText *renderer, gchar *path,
+                                   gchar *new_text, gpointer user_data) {
+    (void)renderer;
+    apply_grade_edit((AssignmentsWindow *)user_data, path, new_text, GRADE_EDIT_STATUS);
 }
 
-static void on_submission_quality_changed(GtkComboBox *combo, gpointer user_data) {
-    (void)combo;
-    GtkWidget *status_combo = GTK_WIDGET(user_data);
-    on_submission_status_changed(GTK_COMBO_BOX(status_combo), NULL);
+static void on_grade_quality_edited(GtkCellRendererText *renderer, gchar *path,
+                                    gchar *new_text, gpointer user_data) {
+    (void)renderer;
+    apply_grade_edit((AssignmentsWindow *)user_data, path, new_text, GRADE_EDIT_QUALITY);
 }
 
-static void on_submission_notes_changed(GtkEntry *entry, gpointer user_data) {
-    (void)entry;
-    GtkWidget *status_combo = GTK_WIDGET(user_data);
-    on_submission_status_changed(GTK_COMBO_BOX(status_combo), NULL);
+static void on_grade_notes_edited(GtkCellRendererText *renderer, gchar *path,
+                                  gchar *new_text, gpointer user_data) {
+    (void)renderer;
+    apply_grade_edit((AssignmentsWindow *)user_data, path, new_text, GRADE_EDIT_NOTES);
 }
 
 static void on_save_all_submissions_clicked(GtkButton *button, gpointer user_data) {
     (void)button;
     AssignmentsWindow *aw = (AssignmentsWindow *)user_data;
     
-    // Trigger save for all entries
-    GList *children = gtk_container_get_children(GTK_CONTAINER(aw->submissions_box));
-    int saved_count = 0;
-    
-    for (GList *iter = children; iter != NULL; iter = g_list_next(iter)) {
-        GtkWidget *frame = GTK_WIDGET(iter->data);
-        GList *frame_children = gtk_container_get_children(GTK_CONTAINER(frame));
-        if (frame_children) {
-            GtkWidget *hbox = GTK_WIDGET(frame_children->data);
-            GList *hbox_children = gtk_container_get_children(GTK_CONTAINER(hbox));
-            
-            // Find the status combo (second widget after label)
-            if (hbox_children && hbox_children->next) {
-                GtkWidget *status_combo = GTK_WIDGET(hbox_children->next->data);
-                on_submission_status_changed(GTK_COMBO_BOX(status_combo), NULL);
-                saved_count++;
-            }
-            
-            g_list_free(hbox_children);
-            g_list_free(frame_children);
-        }
+    // Write the whole grid in one batch
+    SubmissionEntry *entries = g_new(SubmissionEntry, aw->grade_count > 0 ? aw->grade_count : 1);
+    for (int i = 0; i < aw->grade_count; i++) {
+        entries[i].student_id = aw->grade_rows[i]->student_id;
+        entries[i].status = aw->grade_rows[i]->status;
+        entries[i].quality = aw->grade_rows[i]->quality;
+        entries[i].notes = aw->grade_rows[i]->notes;
+    }
+    int saved_count = db_save_submissions_batch(aw->selected_assignment_id, entries, aw->grade_count);
+    g_free(entries);
+    
+    if (saved_count < 0) {
+        show_error_dialog(GTK_WINDOW(aw->window), "Failed to save submissions.");
+        return;
     }
-    g_list_free(children);
     
     char message[100];
     snprintf(message, sizeof(message), "Saved %d student submission records!", saved_count);
@@ -228,142 +303,90 @@ static void on_save_all_submissions_clicked(GtkButton *button, gpointer user_dat
     gtk_widget_set_sensitive(aw->save_all_btn, FALSE);
 }
 
-static void mark_unsaved_changes(GtkWidget *widget, gpointer user_data) {
-    (void)widget;
-    AssignmentsWindow *aw = (AssignmentsWindow *)user_data;
-    aw->has_unsaved_changes = 1;
-    if (aw->save_all_btn) {
-        gtk_widget_set_sensitive(aw->save_all_btn, TRUE);
-    }
-}
-
 static void load_submissions_for_assignment(AssignmentsWindow *aw, int assignment_id) {
-    // Clear existing widgets
-    GList *children = gtk_container_get_children(GTK_CONTAINER(aw->submissions_box));
-    for (GList *iter = children; iter != NULL; iter = g_list_next(iter)) {
-        gtk_widget_destroy(GTK_WIDGET(iter->data));
-    }
-    g_list_free(children);
-    
     // Update header with assignment details
     Assignment *assignment = db_get_assignment_by_id(assignment_id);
+    char header_text[600] = "";
     if (assignment) {
         char due_date_str[50];
         format_datetime(assignment->due_date, due_date_str, sizeof(due_date_str));
         
-        char header_text[500];
         snprintf(header_text, sizeof(header_text), 
                 "<span font='14' weight='bold'>Tracking: %s</span>\n"
                 "<span font='11'>Subject: %s | Due: %s</span>",
                 assignment->title, assignment->subject, due_date_str);
-        
-        gtk_label_set_markup(GTK_LABEL(aw->tracking_header), header_text);
         free(assignment);
     }
     
-    // Get students from current class
-    int student_count;
-    Student **students = db_get_students_by_class(g_session.current_class_id, &student_count);
-    
-    if (!students || student_count == 0) {
-        GtkWidget *label = gtk_label_new("No students found. Please add students first.");
-        gtk_box_pack_start(GTK_BOX(aw->submissions_box), label, FALSE, FALSE, 10);
-        gtk_widget_show_all(aw->submissions_box);
-        gtk_widget_set_sensitive(aw->save_all_btn, FALSE);
-        return;
-    }
-    
-    // Create submission widgets for each student
-    for (int i = 0; i < student_count; i++) {
-        GtkWidget *frame = gtk_frame_new(NULL);
-        GtkStyleContext *student_frame_ctx = gtk_widget_get_style_context(frame);
-        gtk_style_context_add_class(student_frame_ctx, "student-frame");
-        
-        GtkWidget *vbox = gtk_box_new(GTK_ORIENTATION_VERTICAL, 8);
-        gtk_container_set_border_width(GTK_CONTAINER(vbox), 8);
-        
-        // Student name header
-        GtkWidget *name_label = gtk_label_new(NULL);
-        char name_markup[256];
-        snprintf(name_markup, sizeof(name_markup), "<b>%s</b> <small>(%s)</small>", 
-                students[i]->name, students[i]->roll_number);
-        gtk_label_set_markup(GTK_LABEL(name_label), name_markup);
-        gtk_widget_set_halign(name_label, GTK_ALIGN_START);
-        gtk_box_pack_start(GTK_BOX(vbox), name_label, FALSE, FALSE, 0);
-        
-        GtkWidget *hbox = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 12);
-        gtk_container_set_border_width(GTK_CONTAINER(hbox), 5);
-        
-        // Status combo
-        GtkWidget *status_label = gtk_label_new("Status:");
-        GtkWidget *status_combo = gtk_combo_box_text_new();
-        gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(status_combo), "No Submission");
-        gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(status_combo), "Timely Submission");
-        gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(status_combo), "Late Submission");
-        
-        // Quality combo
-        GtkWidget *quality_label = gtk_label_new("Quality:");
-        GtkWidget *quality_combo = gtk_combo_box_text_new();
-        gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(quality_combo), "Poor");
-        gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(quality_combo), "Below Average");
-        gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(quality_combo), "Above Average");
-        gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(quality_combo), "High");
-        
-        // Notes entry
-        GtkWidget *notes_label = gtk_label_new("Notes:");
-        GtkWidget *notes_entry = gtk_entry_new();
-        gtk_entry_set_placeholder_text(GTK_ENTRY(notes_entry), "Optional notes");
-        gtk_widget_set_size_request(notes_entry, 200, -1);
-        
-        // Load existing submission if any
-        AssignmentSubmission *sub = db_get_submission(assignment_id, students[i]->id);
-        if (sub) {
-            gtk_combo_box_set_active(GTK_COMBO_BOX(status_combo), sub->status);
-            gtk_combo_box_set_active(GTK_COMBO_BOX(quality_combo), sub->quality);
-            gtk_entry_set_text(GTK_ENTRY(notes_entry), sub->notes);
-            free(sub);
-        } else {
-            gtk_combo_box_set_active(GTK_COMBO_BOX(status_combo), 0);
-            gtk_combo_box_set_active(GTK_COMBO_BOX(quality_combo), 0);
-        }
-        
-        // Store student ID in widgets
-        g_object_set_data(G_OBJECT(status_combo), "student_id", GINT_TO_POINTER(students[i]->id));
-        g_object_set_data(G_OBJECT(status_combo), "quality_combo", quality_combo);
-        g_object_set_data(G_OBJECT(status_combo), "notes_entry", notes_entry);
-        g_object_set_data(G_OBJECT(status_combo), "assignment_id", GINT_TO_POINTER(assignment_id));
-        
-        // Connect signals for tracking changes
-        g_signal_connect(status_combo, "changed", G_CALLBACK(on_submission_status_changed), NULL);
-        g_signal_connect(status_combo, "changed", G_CALLBACK(mark_unsaved_changes), aw);
-        
-        g_signal_connect(quality_combo, "changed", G_CALLBACK(on_submission_quality_changed), status_combo);
-        g_signal_connect(quality_combo, "changed", G_CALLBACK(mark_unsaved_changes), aw);
-        
-        // Use "changed" signal for notes to auto-save as user types
-        g_signal_connect(notes_entry, "changed", G_CALLBACK(on_submission_notes_changed), status_combo);
-        g_signal_connect(notes_entry, "changed", G_CALLBACK(mark_unsaved_changes), aw);
-        
-        gtk_box_pack_start(GTK_BOX(hbox), status_label, FALSE, FALSE, 0);
-        gtk_box_pack_start(GTK_BOX(hbox), status_combo, FALSE, FALSE, 0);
-        gtk_box_pack_start(GTK_BOX(hbox), quality_label, FALSE, FALSE, 0);
-        gtk_box_pack_start(GTK_BOX(hbox), quality_combo, FALSE, FALSE, 0);
-        gtk_box_pack_start(GTK_BOX(hbox), notes_label, FALSE, FALSE, 0);
-        gtk_box_pack_start(GTK_BOX(hbox), notes_entry, TRUE, TRUE, 0);
-        
-        gtk_box_pack_start(GTK_BOX(vbox), hbox, FALSE, FALSE, 0);
-        gtk_container_add(GTK_CONTAINER(frame), vbox);
-        gtk_box_pack_start(GTK_BOX(aw->submissions_box), frame, FALSE, FALSE, 6);
+    // One query for the whole class; the grid draws only the rows in sight
+    int count;
+    SubmissionSheetRow **rows = db_get_submission_sheet(g_session.current_class_id, assignment_id, &count);
+    if (!rows) {
+        count = 0;
+        g_strlcat(header_text, "\nNo students found. Please add students first.", sizeof(header_text));
     }
+    gtk_label_set_markup(GTK_LABEL(aw->tracking_header), header_text);
     
-    db_free_students(students, student_count);
-    gtk_widget_show_all(aw->submissions_box);
+    ResultModel *model = result_model_new(NUM_GRADE_COLS, GRADE_COLUMN_TYPES, rows, count,
+                                          get_grade_cell, free_grade_rows);
+    aw->grade_rows = rows;
+    aw->grade_count = count;
+    result_model_attach(GTK_TREE_VIEW(aw->grading_grid), model);
+    g_object_unref(model);
     
     // Reset unsaved changes flag
     aw->has_unsaved_changes = 0;
     gtk_widget_set_sensitive(aw->save_all_btn, FALSE);
 }
 
+// Editable combo renderer offering the given choices
+static GtkCellRenderer* grade_combo_renderer(const char **choices, int count) {
+    GtkListStore *store = gtk_list_store_new(1, G_TYPE_STRING);
+    for (int i = 0; i < count; i++) {
+        gtk_list_store_insert_with_values(store, NULL, -1, 0, choices[i], -1);
+    }
+    GtkCellRenderer *renderer = gtk_cell_renderer_combo_new();
+    g_object_set(renderer, "model", store, "text-column", 0, "has-entry", FALSE,
+                 "editable", TRUE, NULL);
+    g_object_unref(store);
+    return renderer;
+}
+
+static void append_grade_column(AssignmentsWindow *aw, const char *title, GtkCellRenderer *renderer,
+                                int column_id, int width, GCallback edited) {
+    if (edited) g_signal_connect(renderer, "edited", edited, aw);
+    GtkTreeViewColumn *column = gtk_tree_view_column_new_with_attributes(
+        title, renderer, "text", column_id, NULL);
+    gtk_tree_view_column_set_sizing(column, GTK_TREE_VIEW_COLUMN_FIXED);
+    gtk_tree_view_column_set_fixed_width(column, width);
+    gtk_tree_view_column_set_resizable(column, TRUE);
+    gtk_tree_view_append_column(GTK_TREE_VIEW(aw->grading_grid), column);
+}
+
+// Grading grid: one fixed-height row per student, graded through cell
+// renderers that write into aw->grade_rows
+static void create_grading_grid(AssignmentsWindow *aw) {
+    aw->grading_grid = gtk_tree_view_new();
+    gtk_tree_view_set_grid_lines(GTK_TREE_VIEW(aw->grading_grid), GTK_TREE_VIEW_GRID_LINES_BOTH);
+    
+    GtkCellRenderer *name = gtk_cell_renderer_text_new();
+    g_object_set(name, "ellipsize", PANGO_ELLIPSIZE_END, "weight", PANGO_WEIGHT_BOLD, NULL);
+    append_grade_column(aw, "Student", name, GRADE_COL_NAME, 200, NULL);
+    append_grade_column(aw, "Roll No.", gtk_cell_renderer_text_new(), GRADE_COL_ROLL, 100, NULL);
+    append_grade_column(aw, "Status", grade_combo_renderer(GRADE_STATUS_TEXT, 3),
+                        GRADE_COL_STATUS, 160, G_CALLBACK(on_grade_status_edited));
+    append_grade_column(aw, "Quality", grade_combo_renderer(GRADE_QUALITY_TEXT, 4),
+                        GRADE_COL_QUALITY, 140, G_CALLBACK(on_grade_quality_edited));
+    
+    GtkCellRenderer *notes = gtk_cell_renderer_text_new();
+    g_object_set(notes, "editable", TRUE, "placeholder-text", "Optional notes",
+                 "ellipsize", PANGO_ELLIPSIZE_END, NULL);
+    append_grade_column(aw, "Notes", notes, GRADE_COL_NOTES, 240, G_CALLBACK(on_grade_notes_edited));
+    gtk_tree_view_column_set_expand(gtk_tree_view_get_column(GTK_TREE_VIEW(aw->grading_grid), 4), TRUE);
+    
+    gtk_tree_view_set_fixed_height_mode(GTK_TREE_VIEW(aw->grading_grid), TRUE);
+}
+
 static void on_assignment_selected_for_tracking(GtkComboBox *combo, gpointer user_data) {
     AssignmentsWindow *aw = (AssignmentsWindow *)user_data;
     
@@ -479,13 +502,6 @@ void show_assignments_window(GtkWindow *parent) {
         "  background: linear-gradient(135deg, #dc3545 0%, #c82333 100%);"
         "  color: white;"
         "}"
-        ".student-frame {"
-        "  border: 1px solid #dee2e6;"
-        "  border-radius: 6px;"
-        "  margin: 5px;"
-        "  padding: 12px;"
-        "  background: #ffffff;"
-        "}"
         ".tracking-header {"
         "  background: linear-gradient(135deg, #667eea 0%, #764ba2 100%);"
         "  color: white;"
@@ -545,9 +561,8 @@ void show_assignments_window(GtkWindow *parent) {
     gtk_box_pack_start(GTK_BOX(list_card), toolbar, FALSE, FALSE, 0);
     
     // Tree view
-    aw->list_store = gtk_list_store_new(NUM_ASSIGN_COLS, G_TYPE_INT, G_TYPE_STRING, 
-                                        G_TYPE_STRING, G_TYPE_STRING);
-    aw->tree_view = gtk_tree_view_new_with_model(GTK_TREE_MODEL(aw->list_store));
+    // Filled with a result model by refresh_assignments_list
+    aw->tree_view = gtk_tree_view_new();
     
     GtkCellRenderer *renderer = gtk_cell_renderer_text_new();
     gtk_tree_view_append_column(GTK_TREE_VIEW(aw->tree_view),
@@ -704,8 +719,8 @@ void show_assignments_window(GtkWindow *parent) {
                                    GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
     gtk_widget_set_size_request(track_scroll, -1, 300);
     
-    aw->submissions_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 8);
-    gtk_container_add(GTK_CONTAINER(track_scroll), aw->submissions_box);
+    create_grading_grid(aw);
+    gtk_container_add(GTK_CONTAINER(track_scroll), aw->grading_grid);
     gtk_box_pack_start(GTK_BOX(track_tab), track_scroll, TRUE, TRUE, 0);
     
     gtk_notebook_append_page(GTK_NOTEBOOK(aw->notebook), track_tab, gtk_label_new("Track Submissions"));
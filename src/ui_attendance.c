@@ -7,33 +7,96 @@
 #include <time.h>
 #include <string.h>
 #include "database.h"
-#include "common.h"
+#include "db_batch.h"
+#include "db_bulk.h"
+#include "db_import.h"
+#include "db_rollup.h"
+#include "ui_common.h"
+#include "ui_result_model.h"
 #include "validation.h"
 
+// Dates on each side of the shown one whose sheets are loaded while idle
+#define SHEET_PREFETCH_SPAN 2
+
+// One student on the Mark tab; the roster view edits these in place. The
+// saved_ fields hold what is stored for the date, so a save can skip rows
+// that have not changed.
+typedef struct {
+    int student_id;
+    char name[MAX_NAME_LENGTH];
+    char roll_number[50];
+    int status;                            // AttendanceStatus
+    char notes[MAX_DESCRIPTION_LENGTH];
+    int saved_status;                      // -1 when not marked yet
+    char saved_notes[MAX_DESCRIPTION_LENGTH];
+} MarkRow;
+
 typedef struct {
     GtkWidget *window;
     GtkWidget *date_listbox;
-    GtkWidget *attendance_grid;
+    GtkWidget *attendance_sheet;
     GtkWidget *search_entry;
+    guint search_timeout;                  // pending debounced search, 0 if none
+    guint prefetch_idle;                   // idle source loading prefetch_dates
+    char prefetch_dates[SHEET_PREFETCH_SPAN * 2][20];
+    int prefetch_count;
+    int prefetch_next;
     GtkWidget *stats_label;
+    GtkWidget *bulk_from_entry;
+    GtkWidget *bulk_to_entry;
+    GtkWidget *bulk_status_combo;
+    GtkWidget *bulk_weekdays_check;
+    GtkWidget *undo_button;
     GtkWidget *mark_date_entry;
-    GtkWidget *mark_attendance_grid;
+    GtkWidget *mark_roster;
+    MarkRow *mark_rows;                    // owned by the roster's model
+    int mark_count;
     GtkWidget *mark_stats_label;
     GtkWidget *notebook;
+    GtkWidget *sparse_check;
+    GtkWidget *heatmap;
+    GtkWidget *heatmap_year_label;
+    int heatmap_year;
+    int heatmap_loaded_year;               // year, class and data version
+    int heatmap_loaded_class;              // heatmap_days were read for
+    unsigned long heatmap_version;
+    AttendanceRollup heatmap_days[366];    // by day of year; zero when not recorded
+    bool heatmap_holidays[366];
     char selected_date[20];
 } AttendanceWindow;
 
 // Forward declarations
 static void load_attendance_dates(AttendanceWindow *aw);
 static void show_attendance_for_date(AttendanceWindow *aw, const char *date);
+static void clear_attendance_sheet(AttendanceWindow *aw);
 static void on_date_row_activated(GtkListBox *listbox, GtkListBoxRow *row, gpointer user_data);
 static void on_search_changed(GtkWidget *widget, gpointer user_data);
 static void on_clear_search(GtkWidget *widget, gpointer user_data);
 static void on_delete_attendance_clicked(GtkButton *button, gpointer user_data);
 static void on_mark_attendance_clicked(GtkButton *button, gpointer user_data);
 static void refresh_mark_attendance_list(AttendanceWindow *aw);
+static void on_sparse_toggled(GtkToggleButton *button, gpointer user_data);
 static const char* get_day_of_week(const char *date);
 
+// Columns of the Mark tab roster, read from aw->mark_rows
+enum {
+    MARK_COL_INDEX = 0,
+    MARK_COL_NAME,
+    MARK_COL_ROLL,
+    MARK_COL_STATUS,
+    MARK_COL_NOTES,
+    NUM_MARK_COLS
+};
+
+// Columns of the view sheet, read from the AttendanceSheetRow array
+enum {
+    SHEET_COL_NAME = 0,
+    SHEET_COL_ROLL,
+    SHEET_COL_STATUS,
+    SHEET_COL_NOTES,
+    NUM_SHEET_COLS
+};
+
 // CSS Styling for modern UI
 static void apply_attendance_css(void) {
     GtkCssProvider *provider = gtk_css_provider_new();
@@ -127,95 +190,108 @@ static const char* get_day_of_week(const char *date) {
     return "Unknown";
 }
 
-// Load all attendance dates from database
+// Build one entry of the date list
+static GtkWidget* create_date_row(const char *date) {
+    // Create date row with day of week
+    const char *day = get_day_of_week(date);
+    char label_text[150];
+    snprintf(label_text, sizeof(label_text), "%s\n<small>%s</small>", 
+             date, day);
+    
+    GtkWidget *label = gtk_label_new(NULL);
+    gtk_label_set_markup(GTK_LABEL(label), label_text);
+    gtk_widget_set_halign(label, GTK_ALIGN_START);
+    
+    GtkWidget *row = gtk_list_box_row_new();
+    gtk_container_add(GTK_CONTAINER(row), label);
+    
+    // Store date in row data
+    g_object_set_data_full(G_OBJECT(row), "date", 
+                           g_strdup(date), g_free);
+    
+    // Apply CSS class
+    GtkStyleContext *context = gtk_widget_get_style_context(row);
+    gtk_style_context_add_class(context, "date-item");
+    
+    gtk_widget_show_all(row);
+    return row;
+}
+
+// Turn the search text into bounds for db_search_attendance_dates: a prefix
+// such as "2024-03" matches itself, "2024-01..2024-03" is a range and either
+// side of ".." may be left empty
+static void parse_date_search(const char *text, char *from, char *to, size_t size) {
+    const char *sep = strstr(text, "..");
+    if (sep) {
+        g_strlcpy(from, text, MIN(size, (size_t)(sep - text) + 1));
+        g_strlcpy(to, sep + 2, size);
+    } else {
+        g_strlcpy(from, text, size);
+        g_strlcpy(to, text, size);
+    }
+    g_strstrip(from);
+    g_strstrip(to);
+}
+
+// Load the class's attendance dates matching the search. The filter runs in
+// SQL, and the list is updated in place rather than rebuilt.
 static void load_attendance_dates(AttendanceWindow *aw) {
-    // Clear existing items
-    GList *children = gtk_container_get_children(GTK_CONTAINER(aw->date_listbox));
-    for (GList *iter = children; iter != NULL; iter = g_list_next(iter)) {
-        gtk_widget_destroy(GTK_WIDGET(iter->data));
+    // A direct load supersedes a debounced one still waiting
+    if (aw->search_timeout) {
+        g_source_remove(aw->search_timeout);
+        aw->search_timeout = 0;
     }
-    g_list_free(children);
     
     // Get search filter
     const char *search_text = gtk_entry_get_text(GTK_ENTRY(aw->search_entry));
+    char from[32];
+    char to[32];
+    parse_date_search(search_text ? search_text : "", from, to, sizeof(from));
     
-    // Query unique dates from attendance table filtered by current class
-    extern sqlite3 *g_db;
-    if (!g_db) return;
-    
-    const char *sql = 
-        "SELECT DISTINCT a.date FROM attendance a "
-        "INNER JOIN students s ON a.student_id = s.id "
-        "WHERE s.class_id = ? "
-        "ORDER BY a.date DESC";
-    sqlite3_stmt *stmt;
-    int count = 0;
-    GtkWidget *first_row = NULL;
-    
-    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) == SQLITE_OK) {
-        sqlite3_bind_int(stmt, 1, g_session.current_class_id);
+    int date_count;
+    char **dates = db_search_attendance_dates(g_session.current_class_id, from, to, &date_count);
+    int count = dates ? date_count : 0;
+    
+    // The list and the result are both newest first, so one merge pass drops
+    // rows that no longer match and inserts new ones in place; rows in both
+    // are left as they are
+    GList *children = gtk_container_get_children(GTK_CONTAINER(aw->date_listbox));
+    GList *child = children;
+    int position = 0;
+    int i = 0;
+    while (i < count || child) {
+        const char *child_date = child ? g_object_get_data(G_OBJECT(child->data), "date") : NULL;
+        int cmp = !child ? -1 : i == count ? 1 : strcmp(child_date, dates[i]);
         
-        while (sqlite3_step(stmt) == SQLITE_ROW) {
-            const char *date = (const char *)sqlite3_column_text(stmt, 0);
-            if (!date) continue;
-            
-            // Apply search filter
-            if (search_text && strlen(search_text) > 0) {
-                if (strstr(date, search_text) == NULL) {
-                    continue;
-                }
-            }
-            
-            // Create date row with day of week
-            const char *day = get_day_of_week(date);
-            char label_text[150];
-            snprintf(label_text, sizeof(label_text), "%s\n<small>%s</small>", 
-                     date, day);
-            
-            GtkWidget *label = gtk_label_new(NULL);
-            gtk_label_set_markup(GTK_LABEL(label), label_text);
-            gtk_widget_set_halign(label, GTK_ALIGN_START);
-            
-            GtkWidget *row = gtk_list_box_row_new();
-            gtk_container_add(GTK_CONTAINER(row), label);
-            
-            // Store date in row data
-            g_object_set_data_full(G_OBJECT(row), "date", 
-                                   g_strdup(date), g_free);
-            
-            // Apply CSS class
-            GtkStyleContext *context = gtk_widget_get_style_context(row);
-            gtk_style_context_add_class(context, "date-item");
-            
-            gtk_container_add(GTK_CONTAINER(aw->date_listbox), row);
-            
-            // Store first row for auto-selection
-            if (count == 0) {
-                first_row = row;
-            }
-            count++;
+        if (cmp > 0) {
+            gtk_widget_destroy(GTK_WIDGET(child->data));
+            child = g_list_next(child);
+        } else if (cmp == 0) {
+            child = g_list_next(child);
+            i++;
+            position++;
+        } else {
+            gtk_list_box_insert(GTK_LIST_BOX(aw->date_listbox), create_date_row(dates[i]), position);
+            i++;
+            position++;
         }
-        sqlite3_finalize(stmt);
     }
+    g_list_free(children);
+    db_free_attendance_dates(dates, date_count);
     
-    gtk_widget_show_all(aw->date_listbox);
+    GtkListBoxRow *first_row = gtk_list_box_get_row_at_index(GTK_LIST_BOX(aw->date_listbox), 0);
     
     // Handle search results
     if (search_text && strlen(search_text) > 0) {
         if (count == 0) {
             // No results found for search
             gtk_label_set_text(GTK_LABEL(aw->stats_label), 
-                "No attendance records found for the searched date");
+                "No attendance records found for the searched dates");
             
-            // Clear attendance grid
-            GList *grid_children = gtk_container_get_children(GTK_CONTAINER(aw->attendance_grid));
-            for (GList *iter = grid_children; iter != NULL; iter = g_list_next(iter)) {
-                gtk_widget_destroy(GTK_WIDGET(iter->data));
-            }
-            g_list_free(grid_children);
+            clear_attendance_sheet(aw);
         } else if (count == 1 && first_row) {
             // Auto-select the single matching result
-            gtk_list_box_select_row(GTK_LIST_BOX(aw->date_listbox), GTK_LIST_BOX_ROW(first_row));
+            gtk_list_box_select_row(GTK_LIST_BOX(aw->date_listbox), first_row);
             const char *date = g_object_get_data(G_OBJECT(first_row), "date");
             if (date) {
                 show_attendance_for_date(aw, date);
@@ -223,7 +299,7 @@ static void load_attendance_dates(AttendanceWindow *aw) {
         }
     } else if (count > 0 && first_row) {
         // No search, auto-select first (latest) date
-        gtk_list_box_select_row(GTK_LIST_BOX(aw->date_listbox), GTK_LIST_BOX_ROW(first_row));
+        gtk_list_box_select_row(GTK_LIST_BOX(aw->date_listbox), first_row);
         const char *date = g_object_get_data(G_OBJECT(first_row), "date");
         if (date) {
             show_attendance_for_date(aw, date);
@@ -236,126 +312,216 @@ static void load_attendance_dates(AttendanceWindow *aw) {
 }
 
 // Show attendance sheet for selected date
-static void show_attendance_for_date(AttendanceWindow *aw, const char *date) {
-    // Store selected date
-    strncpy(aw->selected_date, date, sizeof(aw->selected_date) - 1);
-    
-    // Clear existing attendance grid
-    GList *children = gtk_container_get_children(GTK_CONTAINER(aw->attendance_grid));
-    for (GList *iter = children; iter != NULL; iter = g_list_next(iter)) {
-        gtk_widget_destroy(GTK_WIDGET(iter->data));
+static const GType SHEET_COLUMN_TYPES[NUM_SHEET_COLS] = {
+    G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING
+};
+
+// Status names, indexed by AttendanceStatus
+static const char *MARK_STATUS_TEXT[] = {"Absent", "Present", "Late"};
+
+static const char* status_markup(int status) {
+    switch (status) {
+        case ATTENDANCE_PRESENT: return "<span foreground='green'>Present</span>";
+        case ATTENDANCE_ABSENT: return "<span foreground='red'>Absent</span>";
+        case ATTENDANCE_LATE: return "<span foreground='orange'>Late</span>";
+        default: return "<span foreground='gray'>Not Marked</span>";
     }
-    g_list_free(children);
+}
+
+// Decoded attendance sheets (rows plus their counts), so going back to a
+// date, or on to a neighbour prefetched while idle, needs no query. A sheet
+// is shared by the cache and the models showing it. The cache is emptied
+// when db_data_version() moves on; otherwise the least recently used sheets
+// go once there are SHEET_CACHE_SIZE of them or they hold SHEET_CACHE_BYTES.
+#define SHEET_CACHE_SIZE 64
+#define SHEET_CACHE_BYTES (8 * 1024 * 1024)
+
+typedef struct {
+    int refs;
+    int class_id;
+    char date[20];
+    AttendanceSheetRow **rows;
+    int count;
+    int present;
+    int absent;
+    int late;
+    size_t bytes;
+    guint64 used;             // last use, for eviction
+} AttendanceSheet;
+
+static AttendanceSheet *g_sheet_cache[SHEET_CACHE_SIZE];
+static size_t g_sheet_cache_bytes = 0;
+static guint64 g_sheet_cache_clock = 0;
+static unsigned long g_sheet_cache_version = 0;
+
+static void sheet_unref(AttendanceSheet *sheet) {
+    if (sheet && --sheet->refs == 0) {
+        db_free_attendance_sheet(sheet->rows, sheet->count);
+        g_free(sheet);
+    }
+}
+
+static AttendanceSheet* load_sheet(int class_id, const char *date) {
+    AttendanceSheet *sheet = g_new0(AttendanceSheet, 1);
+    sheet->refs = 1;
+    sheet->class_id = class_id;
+    g_strlcpy(sheet->date, date, sizeof(sheet->date));
     
-    // Add headers
-    GtkWidget *header_name = gtk_label_new(NULL);
-    gtk_label_set_markup(GTK_LABEL(header_name), "<b>Student Name</b>");
-    gtk_widget_set_halign(header_name, GTK_ALIGN_START);
-    gtk_grid_attach(GTK_GRID(aw->attendance_grid), header_name, 0, 0, 1, 1);
-    
-    GtkWidget *header_roll = gtk_label_new(NULL);
-    gtk_label_set_markup(GTK_LABEL(header_roll), "<b>Roll No</b>");
-    gtk_widget_set_halign(header_roll, GTK_ALIGN_START);
-    gtk_grid_attach(GTK_GRID(aw->attendance_grid), header_roll, 1, 0, 1, 1);
-    
-    GtkWidget *header_status = gtk_label_new(NULL);
-    gtk_label_set_markup(GTK_LABEL(header_status), "<b>Status</b>");
-    gtk_widget_set_halign(header_status, GTK_ALIGN_START);
-    gtk_grid_attach(GTK_GRID(aw->attendance_grid), header_status, 2, 0, 1, 1);
-    
-    GtkWidget *header_notes = gtk_label_new(NULL);
-    gtk_label_set_markup(GTK_LABEL(header_notes), "<b>Notes</b>");
-    gtk_widget_set_halign(header_notes, GTK_ALIGN_START);
-    gtk_grid_attach(GTK_GRID(aw->attendance_grid), header_notes, 3, 0, 1, 1);
-    
-    // Get attendance data for this date filtered by current class
-    extern sqlite3 *g_db;
-    if (!g_db) return;
-    
-    const char *sql = "SELECT s.name, s.roll_number, a.status, a.notes "
-                     "FROM students s "
-                     "LEFT JOIN attendance a ON s.id = a.student_id AND a.date = ? "
-                     "WHERE s.class_id = ? "
-                     "ORDER BY s.roll_number";
-    
-    sqlite3_stmt *stmt;
-    int row = 1;
-    int present_count = 0;
-    int absent_count = 0;
-    int late_count = 0;
-    int total_count = 0;
-    
-    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) == SQLITE_OK) {
-        sqlite3_bind_text(stmt, 1, date, -1, SQLITE_STATIC);
-        sqlite3_bind_int(stmt, 2, g_session.current_class_id);
+    int count;
+    sheet->rows = db_get_attendance_sheet(class_id, date, &count);
+    sheet->count = sheet->rows ? count : 0;
+    for (int i = 0; i < sheet->count; i++) {
+        if (sheet->rows[i]->status == ATTENDANCE_PRESENT) sheet->present++;
+        else if (sheet->rows[i]->status == ATTENDANCE_ABSENT) sheet->absent++;
+        else if (sheet->rows[i]->status == ATTENDANCE_LATE) sheet->late++;
+    }
+    sheet->bytes = sizeof(*sheet) +
+                   (size_t)sheet->count * (sizeof(AttendanceSheetRow) + sizeof(AttendanceSheetRow *));
+    return sheet;
+}
+
+static void sheet_cache_drop(int slot) {
+    g_sheet_cache_bytes -= g_sheet_cache[slot]->bytes;
+    sheet_unref(g_sheet_cache[slot]);
+    g_sheet_cache[slot] = NULL;
+}
+
+// Keep a reference to sheet, evicting until it fits
+static void sheet_cache_store(AttendanceSheet *sheet) {
+    for (;;) {
+        int free_slot = -1;
+        int oldest = -1;
+        for (int i = 0; i < SHEET_CACHE_SIZE; i++) {
+            if (!g_sheet_cache[i]) {
+                if (free_slot < 0) free_slot = i;
+            } else if (oldest < 0 || g_sheet_cache[i]->used < g_sheet_cache[oldest]->used) {
+                oldest = i;
+            }
+        }
         
-        while (sqlite3_step(stmt) == SQLITE_ROW) {
-            const char *name = (const char *)sqlite3_column_text(stmt, 0);
-            const char *roll = (const char *)sqlite3_column_text(stmt, 1);
-            int status = sqlite3_column_type(stmt, 2) != SQLITE_NULL ? 
-                         sqlite3_column_int(stmt, 2) : -1;
-            const char *notes = (const char *)sqlite3_column_text(stmt, 3);
-            
-            // Create row widgets
-            GtkWidget *name_label = gtk_label_new(name);
-            gtk_widget_set_halign(name_label, GTK_ALIGN_START);
-            gtk_widget_set_margin_start(name_label, 10);
-            
-            GtkWidget *roll_label = gtk_label_new(roll);
-            gtk_widget_set_halign(roll_label, GTK_ALIGN_START);
-            
-            GtkWidget *status_label = gtk_label_new(NULL);
-            gtk_widget_set_halign(status_label, GTK_ALIGN_START);
-            
-            if (status == ATTENDANCE_PRESENT) {
-                gtk_label_set_markup(GTK_LABEL(status_label), 
-                    "<span foreground='green'>Present</span>");
-                present_count++;
-            } else if (status == ATTENDANCE_ABSENT) {
-                gtk_label_set_markup(GTK_LABEL(status_label), 
-                    "<span foreground='red'>Absent</span>");
-                absent_count++;
-            } else if (status == 2) {
-                gtk_label_set_markup(GTK_LABEL(status_label), 
-                    "<span foreground='orange'>Late</span>");
-                late_count++;
-            } else {
-                gtk_label_set_markup(GTK_LABEL(status_label), 
-                    "<span foreground='gray'>Not Marked</span>");
+        if (free_slot >= 0 && g_sheet_cache_bytes + sheet->bytes <= SHEET_CACHE_BYTES) {
+            sheet->refs++;
+            sheet->used = ++g_sheet_cache_clock;
+            g_sheet_cache[free_slot] = sheet;
+            g_sheet_cache_bytes += sheet->bytes;
+            return;
+        }
+        if (oldest < 0) return;   // larger than the whole cache
+        sheet_cache_drop(oldest);
+    }
+}
+
+// The sheet for a class and date, from the cache when it has it; the caller
+// owns the returned reference
+static AttendanceSheet* sheet_cache_get(int class_id, const char *date) {
+    unsigned long version = db_data_version();
+    if (version != g_sheet_cache_version) {
+        for (int i = 0; i < SHEET_CACHE_SIZE; i++) {
+            if (g_sheet_cache[i]) sheet_cache_drop(i);
+        }
+        g_sheet_cache_version = version;
+    }
+    
+    for (int i = 0; i < SHEET_CACHE_SIZE; i++) {
+        AttendanceSheet *sheet = g_sheet_cache[i];
+        if (sheet && sheet->class_id == class_id && strcmp(sheet->date, date) == 0) {
+            sheet->used = ++g_sheet_cache_clock;
+            sheet->refs++;
+            return sheet;
+        }
+    }
+    
+    AttendanceSheet *sheet = load_sheet(class_id, date);
+    sheet_cache_store(sheet);
+    return sheet;
+}
+
+static void get_sheet_cell(gpointer rows, int row, int column, GValue *value) {
+    AttendanceSheetRow *r = ((AttendanceSheet *)rows)->rows[row];
+    switch (column) {
+        case SHEET_COL_NAME: g_value_set_static_string(value, r->name); break;
+        case SHEET_COL_ROLL: g_value_set_static_string(value, r->roll_number); break;
+        case SHEET_COL_STATUS: g_value_set_static_string(value, status_markup(r->status)); break;
+        case SHEET_COL_NOTES: g_value_set_static_string(value, r->notes[0] ? r->notes : "-"); break;
+    }
+}
+
+static void free_sheet_rows(gpointer rows, int count) {
+    (void)count;
+    sheet_unref(rows);
+}
+
+static void clear_attendance_sheet(AttendanceWindow *aw) {
+    ResultModel *model = result_model_new(NUM_SHEET_COLS, SHEET_COLUMN_TYPES, NULL, 0, NULL, NULL);
+    result_model_attach(GTK_TREE_VIEW(aw->attendance_sheet), model);
+    g_object_unref(model);
+}
+
+// Load the queued neighbour sheets into the cache, one per idle call
+static gboolean on_prefetch_idle(gpointer user_data) {
+    AttendanceWindow *aw = (AttendanceWindow *)user_data;
+    if (aw->prefetch_next < aw->prefetch_count) {
+        sheet_unref(sheet_cache_get(g_session.current_class_id,
+                                    aw->prefetch_dates[aw->prefetch_next++]));
+    }
+    if (aw->prefetch_next < aw->prefetch_count) {
+        return G_SOURCE_CONTINUE;
+    }
+    aw->prefetch_idle = 0;
+    return G_SOURCE_REMOVE;
+}
+
+// Queue the dates next to the selected one in the list, nearest first
+static void prefetch_neighbours(AttendanceWindow *aw, const char *date) {
+    aw->prefetch_count = 0;
+    aw->prefetch_next = 0;
+    
+    GtkListBox *listbox = GTK_LIST_BOX(aw->date_listbox);
+    GtkListBoxRow *selected = gtk_list_box_get_selected_row(listbox);
+    const char *selected_date = selected ? g_object_get_data(G_OBJECT(selected), "date") : NULL;
+    if (!selected_date || strcmp(selected_date, date) != 0) return;
+    
+    int index = gtk_list_box_row_get_index(selected);
+    for (int distance = 1; distance <= SHEET_PREFETCH_SPAN; distance++) {
+        int neighbours[2] = {index + distance, index - distance};
+        for (int i = 0; i < 2; i++) {
+            GtkListBoxRow *row = neighbours[i] >= 0 ?
+                                 gtk_list_box_get_row_at_index(listbox, neighbours[i]) : NULL;
+            const char *row_date = row ? g_object_get_data(G_OBJECT(row), "date") : NULL;
+            if (row_date) {
+                g_strlcpy(aw->prefetch_dates[aw->prefetch_count++], row_date,
+                          sizeof(aw->prefetch_dates[0]));
             }
-            
-            // Add to grid
-            gtk_grid_attach(GTK_GRID(aw->attendance_grid), name_label, 0, row, 1, 1);
-            gtk_grid_attach(GTK_GRID(aw->attendance_grid), roll_label, 1, row, 1, 1);
-            gtk_grid_attach(GTK_GRID(aw->attendance_grid), status_label, 2, row, 1, 1);
-            
-            // Notes label
-            GtkWidget *notes_label = gtk_label_new(notes && strlen(notes) > 0 ? notes : "-");
-            gtk_widget_set_halign(notes_label, GTK_ALIGN_START);
-            gtk_label_set_line_wrap(GTK_LABEL(notes_label), TRUE);
-            gtk_label_set_max_width_chars(GTK_LABEL(notes_label), 40);
-            gtk_grid_attach(GTK_GRID(aw->attendance_grid), notes_label, 3, row, 1, 1);
-            
-            // Apply student-row style
-            GtkStyleContext *ctx;
-            ctx = gtk_widget_get_style_context(name_label);
-            gtk_style_context_add_class(ctx, "student-row");
-            
-            row++;
-            total_count++;
         }
-        sqlite3_finalize(stmt);
     }
     
+    if (aw->prefetch_count > 0 && !aw->prefetch_idle) {
+        aw->prefetch_idle = g_idle_add(on_prefetch_idle, aw);
+    }
+}
+
+// Show one date's sheet. The tree view only draws the rows in sight, and
+// sheets come from the cache when the date was seen or prefetched before.
+static void show_attendance_for_date(AttendanceWindow *aw, const char *date) {
+    // Store selected date
+    g_strlcpy(aw->selected_date, date, sizeof(aw->selected_date));
+    
+    // The model shares the cached sheet and drops its reference when replaced
+    AttendanceSheet *sheet = sheet_cache_get(g_session.current_class_id, date);
+    ResultModel *model = result_model_new(NUM_SHEET_COLS, SHEET_COLUMN_TYPES, sheet, sheet->count,
+                                          get_sheet_cell, free_sheet_rows);
+    result_model_attach(GTK_TREE_VIEW(aw->attendance_sheet), model);
+    g_object_unref(model);
+    
     // Update statistics
     char stats[250];
     snprintf(stats, sizeof(stats), 
              "Attendance Statistics for %s (%s)\n"
              "Total: %d | Present: %d | Absent: %d | Late: %d",
-             date, get_day_of_week(date), total_count, present_count, absent_count, late_count);
+             date, get_day_of_week(date), sheet->count, sheet->present, sheet->absent, sheet->late);
     gtk_label_set_text(GTK_LABEL(aw->stats_label), stats);
     
-    gtk_widget_show_all(aw->attendance_grid);
+    prefetch_neighbours(aw, date);
 }
 
 // Date row activated callback
@@ -385,12 +551,31 @@ static void on_date_row_activated(GtkListBox *listbox, GtkListBoxRow *row,
     }
 }
 
-// Search changed callback
+// Typing waits for a pause before searching, so a burst of keystrokes costs
+// one query
+#define SEARCH_DEBOUNCE_MS 250
+
+static gboolean on_search_timeout(gpointer user_data) {
+    AttendanceWindow *aw = (AttendanceWindow *)user_data;
+    aw->search_timeout = 0;
+    load_attendance_dates(aw);
+    return G_SOURCE_REMOVE;
+}
+
+static void on_search_text_changed(GtkEditable *editable, gpointer user_data) {
+    (void)editable;
+    AttendanceWindow *aw = (AttendanceWindow *)user_data;
+    if (aw->search_timeout) {
+        g_source_remove(aw->search_timeout);
+    }
+    aw->search_timeout = g_timeout_add(SEARCH_DEBOUNCE_MS, on_search_timeout, aw);
+}
+
+// Search button / Enter: search right away
 static void on_search_changed(GtkWidget *widget, gpointer user_data) {
     (void)widget;
     AttendanceWindow *aw = (AttendanceWindow *)user_data;
     if (aw && aw->date_listbox) {
-        printf("Search triggered, loading dates...\n");
         load_attendance_dates(aw);
     }
 }
@@ -403,7 +588,30 @@ static void on_clear_search(GtkWidget *widget, gpointer user_data) {
     load_attendance_dates(aw);
 }
 
-// Delete attendance for selected date
+// Name the bulk operation Undo would revert, or disable it
+static void refresh_undo_button(AttendanceWindow *aw) {
+    char label[64];
+    bool can_undo = db_bulk_can_undo(g_session.current_class_id, label, sizeof(label));
+    char tooltip[100];
+    snprintf(tooltip, sizeof(tooltip), "Undo %s", can_undo ? label : "(nothing to undo)");
+    gtk_widget_set_tooltip_text(aw->undo_button, tooltip);
+    gtk_widget_set_sensitive(aw->undo_button, can_undo);
+}
+
+// Show the class's dates and the selected sheet as a bulk operation left them
+static void after_bulk_change(AttendanceWindow *aw) {
+    load_attendance_dates(aw);
+    if (strlen(aw->selected_date) > 0) {
+        char date[20];
+        g_strlcpy(date, aw->selected_date, sizeof(date));
+        show_attendance_for_date(aw, date);
+    } else {
+        clear_attendance_sheet(aw);
+    }
+    refresh_undo_button(aw);
+}
+
+// Delete the class's attendance for the selected date
 static void on_delete_attendance_clicked(GtkButton *button, gpointer user_data) {
     (void)button;
     AttendanceWindow *aw = (AttendanceWindow *)user_data;
@@ -424,136 +632,314 @@ static void on_delete_attendance_clicked(GtkButton *button, gpointer user_data)
     );
     gtk_message_dialog_format_secondary_text(
         GTK_MESSAGE_DIALOG(dialog),
-        "This will permanently delete attendance for all students on this date. This action cannot be undone."
+        "This will delete attendance for all students of this class on this date. "
+        "Undo restores it while this session lasts."
     );
     
     int response = gtk_dialog_run(GTK_DIALOG(dialog));
     gtk_widget_destroy(dialog);
     
     if (response == GTK_RESPONSE_YES) {
-        // Delete from database
-        extern sqlite3 *g_db;
-        const char *sql = "DELETE FROM attendance WHERE date = ?";
-        sqlite3_stmt *stmt;
-        
-        if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) == SQLITE_OK) {
-            sqlite3_bind_text(stmt, 1, aw->selected_date, -1, SQLITE_STATIC);
+        char deleted_date[20];
+        g_strlcpy(deleted_date, aw->selected_date, sizeof(deleted_date));
+        int days = db_bulk_delete_date(g_session.current_class_id, deleted_date);
+        if (days == 0) {
+            char msg[150];
+            snprintf(msg, sizeof(msg), "Nothing recorded on %s to delete", deleted_date);
+            show_info_dialog(GTK_WINDOW(aw->window), msg);
+        } else if (days > 0) {
+            // Clear selected date
+            aw->selected_date[0] = '\0';
+            after_bulk_change(aw);
             
-            if (sqlite3_step(stmt) == SQLITE_DONE) {
-                int deleted = sqlite3_changes(g_db);
-                printf("Deleted %d attendance records for %s\n", deleted, aw->selected_date);
-                
-                char msg[150];
-                snprintf(msg, sizeof(msg), "Successfully deleted attendance for %d students on %s", 
-                         deleted, aw->selected_date);
-                show_info_dialog(GTK_WINDOW(aw->window), msg);
-                
-                // Clear selected date
-                aw->selected_date[0] = '\0';
-                
-                // Refresh the list
-                load_attendance_dates(aw);
-                
-                // Clear the attendance grid
-                GList *children = gtk_container_get_children(GTK_CONTAINER(aw->attendance_grid));
-                for (GList *iter = children; iter != NULL; iter = g_list_next(iter)) {
-                    gtk_widget_destroy(GTK_WIDGET(iter->data));
-                }
-                g_list_free(children);
-                
-                gtk_label_set_text(GTK_LABEL(aw->stats_label), 
-                    "Attendance deleted. Select a date to view.");
-            } else {
-                show_error_dialog(GTK_WINDOW(aw->window), "Failed to delete attendance");
-            }
-            sqlite3_finalize(stmt);
+            gtk_label_set_text(GTK_LABEL(aw->stats_label), 
+                "Attendance deleted. Select a date to view.");
+            
+            char msg[150];
+            snprintf(msg, sizeof(msg), "Successfully deleted attendance on %s", deleted_date);
+            show_info_dialog(GTK_WINDOW(aw->window), msg);
         } else {
-            show_error_dialog(GTK_WINDOW(aw->window), "Database error");
+            show_error_dialog(GTK_WINDOW(aw->window), "Failed to delete attendance");
         }
     }
 }
 
-// Refresh mark attendance student list
-static void refresh_mark_attendance_list(AttendanceWindow *aw) {
-    // Clear existing grid
-    GList *children = gtk_container_get_children(GTK_CONTAINER(aw->mark_attendance_grid));
-    for (GList *iter = children; iter != NULL; iter = g_list_next(iter)) {
-        gtk_widget_destroy(GTK_WIDGET(iter->data));
+// Read the bulk range entries; an empty "To" means the "From" day alone
+static bool get_bulk_range(AttendanceWindow *aw, char *from, char *to, size_t size) {
+    g_strlcpy(from, gtk_entry_get_text(GTK_ENTRY(aw->bulk_from_entry)), size);
+    g_strlcpy(to, gtk_entry_get_text(GTK_ENTRY(aw->bulk_to_entry)), size);
+    g_strstrip(from);
+    g_strstrip(to);
+    if (to[0] == '\0') {
+        g_strlcpy(to, from, size);
     }
-    g_list_free(children);
     
-    // Add headers
-    GtkWidget *h1 = gtk_label_new(NULL);
-    gtk_label_set_markup(GTK_LABEL(h1), "<b>Student</b>");
-    gtk_widget_set_halign(h1, GTK_ALIGN_START);
-    gtk_grid_attach(GTK_GRID(aw->mark_attendance_grid), h1, 0, 0, 1, 1);
+    if (!validate_date(from) || !validate_date(to)) {
+        show_error_dialog(GTK_WINDOW(aw->window), "Please enter dates as YYYY-MM-DD");
+        return false;
+    }
+    if (strcmp(from, to) > 0) {
+        show_error_dialog(GTK_WINDOW(aw->window), "The \"From\" date must not be after the \"To\" date");
+        return false;
+    }
+    return true;
+}
+
+// Fill the range with one status for the whole class
+static void on_bulk_fill_clicked(GtkButton *button, gpointer user_data) {
+    (void)button;
+    AttendanceWindow *aw = (AttendanceWindow *)user_data;
+    char from[20], to[20];
+    if (!get_bulk_range(aw, from, to, sizeof(from))) return;
+    
+    int status = gtk_combo_box_get_active(GTK_COMBO_BOX(aw->bulk_status_combo));
+    bool weekdays = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(aw->bulk_weekdays_check));
+    int days = db_bulk_fill_range(g_session.current_class_id, from, to, (AttendanceStatus)status, weekdays);
+    if (days < 0) {
+        char msg[150];
+        snprintf(msg, sizeof(msg), "Failed to fill attendance (ranges are limited to %d days)", BULK_MAX_DAYS);
+        show_error_dialog(GTK_WINDOW(aw->window), msg);
+        return;
+    }
+    
+    after_bulk_change(aw);
+    char msg[200];
+    snprintf(msg, sizeof(msg), "Marked everyone %s on %d day(s) from %s to %s.\n"
+             "Days already recorded and holidays were left as they were.",
+             MARK_STATUS_TEXT[status], days, from, to);
+    show_info_dialog(GTK_WINDOW(aw->window), msg);
+}
+
+// Copy the selected date's sheet onto the "From" date
+static void on_bulk_copy_clicked(GtkButton *button, gpointer user_data) {
+    (void)button;
+    AttendanceWindow *aw = (AttendanceWindow *)user_data;
+    
+    if (strlen(aw->selected_date) == 0) {
+        show_error_dialog(GTK_WINDOW(aw->window), "Please select a date to copy first");
+        return;
+    }
+    char target[20];
+    g_strlcpy(target, gtk_entry_get_text(GTK_ENTRY(aw->bulk_from_entry)), sizeof(target));
+    g_strstrip(target);
+    if (!validate_date(target) || strcmp(target, aw->selected_date) == 0) {
+        show_error_dialog(GTK_WINDOW(aw->window), "Enter the date to copy to in \"From\" (YYYY-MM-DD)");
+        return;
+    }
     
-    GtkWidget *h2 = gtk_label_new(NULL);
-    gtk_label_set_markup(GTK_LABEL(h2), "<b>Roll Number</b>");
-    gtk_widget_set_halign(h2, GTK_ALIGN_START);
-    gtk_grid_attach(GTK_GRID(aw->mark_attendance_grid), h2, 1, 0, 1, 1);
+    char msg[200];
+    snprintf(msg, sizeof(msg), "Replace the attendance on %s with a copy of %s?", target, aw->selected_date);
+    if (!show_confirm_dialog(GTK_WINDOW(aw->window), msg)) return;
     
-    GtkWidget *h3 = gtk_label_new(NULL);
-    gtk_label_set_markup(GTK_LABEL(h3), "<b>Status</b>");
-    gtk_widget_set_halign(h3, GTK_ALIGN_START);
-    gtk_grid_attach(GTK_GRID(aw->mark_attendance_grid), h3, 2, 0, 1, 1);
+    char source[20];
+    g_strlcpy(source, aw->selected_date, sizeof(source));
+    int days = db_bulk_copy_date(g_session.current_class_id, source, target);
+    if (days < 0) {
+        show_error_dialog(GTK_WINDOW(aw->window), "Failed to copy attendance");
+        return;
+    }
     
-    GtkWidget *h4 = gtk_label_new(NULL);
-    gtk_label_set_markup(GTK_LABEL(h4), "<b>Notes (Optional)</b>");
-    gtk_widget_set_halign(h4, GTK_ALIGN_START);
-    gtk_grid_attach(GTK_GRID(aw->mark_attendance_grid), h4, 3, 0, 1, 1);
+    after_bulk_change(aw);
+    snprintf(msg, sizeof(msg), days > 0 ? "Copied attendance of %s to %s" : "Nothing recorded on %s to copy",
+             source, target);
+    show_info_dialog(GTK_WINDOW(aw->window), msg);
+}
+
+// Make the range holidays, replacing whatever was recorded on those days
+static void on_bulk_holiday_clicked(GtkButton *button, gpointer user_data) {
+    (void)button;
+    AttendanceWindow *aw = (AttendanceWindow *)user_data;
+    char from[20], to[20];
+    if (!get_bulk_range(aw, from, to, sizeof(from))) return;
+    
+    char msg[200];
+    snprintf(msg, sizeof(msg), "Mark %s to %s as holidays? Attendance recorded on these days is removed.",
+             from, to);
+    if (!show_confirm_dialog(GTK_WINDOW(aw->window), msg)) return;
+    
+    int days = db_bulk_mark_holiday(g_session.current_class_id, from, to, "Holiday");
+    if (days < 0) {
+        snprintf(msg, sizeof(msg), "Failed to mark holidays (ranges are limited to %d days)", BULK_MAX_DAYS);
+        show_error_dialog(GTK_WINDOW(aw->window), msg);
+        return;
+    }
     
-    // Get all students for current class
-    int count;
-    Student **students = db_get_students_by_class(g_session.current_class_id, &count);
-    
-    if (students) {
-        for (int i = 0; i < count; i++) {
-            // Student name
-            GtkWidget *name_label = gtk_label_new(students[i]->name);
-            gtk_widget_set_halign(name_label, GTK_ALIGN_START);
-            gtk_widget_set_margin_start(name_label, 10);
-            gtk_grid_attach(GTK_GRID(aw->mark_attendance_grid), name_label, 0, i + 1, 1, 1);
-            
-            // Roll number
-            GtkWidget *roll_label = gtk_label_new(students[i]->roll_number);
-            gtk_widget_set_halign(roll_label, GTK_ALIGN_START);
-            gtk_grid_attach(GTK_GRID(aw->mark_attendance_grid), roll_label, 1, i + 1, 1, 1);
-            
-            // Status combo box
-            GtkWidget *status_combo = gtk_combo_box_text_new();
-            gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(status_combo), "Present");
-            gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(status_combo), "Absent");
-            gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(status_combo), "Late");
-            gtk_combo_box_set_active(GTK_COMBO_BOX(status_combo), 0);
-            
-            // Store student ID in combo box
-            g_object_set_data(G_OBJECT(status_combo), "student_id", 
-                             GINT_TO_POINTER(students[i]->id));
-            
-            gtk_grid_attach(GTK_GRID(aw->mark_attendance_grid), status_combo, 2, i + 1, 1, 1);
-            
-            // Notes entry
-            GtkWidget *notes_entry = gtk_entry_new();
-            gtk_entry_set_placeholder_text(GTK_ENTRY(notes_entry), "Add note...");
-            gtk_widget_set_size_request(notes_entry, 200, -1);
-            
-            // Store student ID in notes entry too
-            g_object_set_data(G_OBJECT(notes_entry), "student_id", 
-                             GINT_TO_POINTER(students[i]->id));
-            
-            gtk_grid_attach(GTK_GRID(aw->mark_attendance_grid), notes_entry, 3, i + 1, 1, 1);
-        }
-        db_free_students(students, count);
+    after_bulk_change(aw);
+    snprintf(msg, sizeof(msg), "Marked %d day(s) as holidays", days);
+    show_info_dialog(GTK_WINDOW(aw->window), msg);
+}
+
+static void on_bulk_undo_clicked(GtkButton *button, gpointer user_data) {
+    (void)button;
+    AttendanceWindow *aw = (AttendanceWindow *)user_data;
+    char label[64];
+    
+    if (!db_bulk_undo(g_session.current_class_id, label, sizeof(label))) {
+        show_error_dialog(GTK_WINDOW(aw->window), "Failed to undo");
+        refresh_undo_button(aw);
+        return;
+    }
+    
+    after_bulk_change(aw);
+    char msg[100];
+    snprintf(msg, sizeof(msg), "Undid %s", label);
+    show_info_dialog(GTK_WINDOW(aw->window), msg);
+}
+
+// Past attendance from a spreadsheet; see db_import_attendance_csv
+static void on_import_attendance_clicked(GtkButton *button, gpointer user_data) {
+    (void)button;
+    AttendanceWindow *aw = (AttendanceWindow *)user_data;
+    
+    char *path = choose_csv_file(GTK_WINDOW(aw->window), "Import Attendance");
+    if (!path) return;
+    
+    ImportReport report;
+    bool ok = db_import_attendance_csv(path, g_session.current_class_id, &report);
+    g_free(path);
+    
+    if (!ok && report.imported == 0) {
+        show_error_dialog(GTK_WINDOW(aw->window), report.failure);
+        db_free_import_report(&report);
+        return;
+    }
+    
+    // One line per rejected row or cell
+    GString *details = g_string_new(NULL);
+    for (int i = 0; i < report.error_count; i++) {
+        g_string_append_printf(details, "Line %d: %s\n", report.errors[i].line, report.errors[i].message);
+    }
+    
+    char message[300];
+    snprintf(message, sizeof(message), "Imported %d attendance marks from %d rows.%s%s%s",
+             report.imported, report.rows,
+             ok ? "" : "\nThe import stopped early: ", ok ? "" : report.failure,
+             report.rejected > 0 ? "\nThese entries were skipped:" : "");
+    show_details_dialog(GTK_WINDOW(aw->window), message, details->str);
+    
+    g_string_free(details, TRUE);
+    db_free_import_report(&report);
+    after_bulk_change(aw);
+}
+
+static const GType MARK_COLUMN_TYPES[NUM_MARK_COLS] = {
+    G_TYPE_INT, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING
+};
+
+static void get_mark_cell(gpointer rows, int row, int column, GValue *value) {
+    MarkRow *r = &((MarkRow *)rows)[row];
+    switch (column) {
+        case MARK_COL_INDEX: g_value_set_int(value, row); break;
+        case MARK_COL_NAME: g_value_set_static_string(value, r->name); break;
+        case MARK_COL_ROLL: g_value_set_static_string(value, r->roll_number); break;
+        case MARK_COL_STATUS: g_value_set_static_string(value, MARK_STATUS_TEXT[r->status]); break;
+        case MARK_COL_NOTES: g_value_set_static_string(value, r->notes); break;
+    }
+}
+
+static void free_mark_rows(gpointer rows, int count) {
+    (void)count;
+    g_free(rows);
+}
+
+// The roster row behind a path, and the iter to redraw it with
+static MarkRow* mark_row_at(AttendanceWindow *aw, const gchar *path, GtkTreeIter *iter) {
+    GtkTreeModel *model = gtk_tree_view_get_model(GTK_TREE_VIEW(aw->mark_roster));
+    int index = -1;
+    if (gtk_tree_model_get_iter_from_string(model, iter, path)) {
+        gtk_tree_model_get(model, iter, MARK_COL_INDEX, &index, -1);
     }
+    return index >= 0 && index < aw->mark_count ? &aw->mark_rows[index] : NULL;
+}
+
+static void on_mark_status_edited(GtkCellRendererText *renderer, gchar *path,
+                                  gchar *new_text, gpointer user_data) {
+    (void)renderer;
+    AttendanceWindow *aw = (AttendanceWindow *)user_data;
+    GtkTreeIter iter;
+    MarkRow *row = mark_row_at(aw, path, &iter);
+    if (!row) return;
+    
+    for (int status = 0; status < 3; status++) {
+        if (strcmp(new_text, MARK_STATUS_TEXT[status]) == 0) row->status = status;
+    }
+    GtkTreeModel *model = gtk_tree_view_get_model(GTK_TREE_VIEW(aw->mark_roster));
+    GtkTreePath *tree_path = gtk_tree_path_new_from_string(path);
+    gtk_tree_model_row_changed(model, tree_path, &iter);
+    gtk_tree_path_free(tree_path);
+}
+
+static void on_mark_notes_edited(GtkCellRendererText *renderer, gchar *path,
+                                 gchar *new_text, gpointer user_data) {
+    (void)renderer;
+    AttendanceWindow *aw = (AttendanceWindow *)user_data;
+    GtkTreeIter iter;
+    MarkRow *row = mark_row_at(aw, path, &iter);
+    if (!row) return;
+    
+    g_strlcpy(row->notes, new_text, sizeof(row->notes));
+    GtkTreeModel *model = gtk_tree_view_get_model(GTK_TREE_VIEW(aw->mark_roster));
+    GtkTreePath *tree_path = gtk_tree_path_new_from_string(path);
+    gtk_tree_model_row_changed(model, tree_path, &iter);
+    gtk_tree_path_free(tree_path);
+}
+
+static bool mark_row_changed(const MarkRow *row) {
+    return row->status != row->saved_status || strcmp(row->notes, row->saved_notes) != 0;
+}
+
+// Refresh mark attendance student list: one MarkRow per student, loaded
+// with what is already stored for the chosen date in a single query.
+// Students not marked yet start as present.
+static void refresh_mark_attendance_list(AttendanceWindow *aw) {
+    const char *date_text = gtk_entry_get_text(GTK_ENTRY(aw->mark_date_entry));
+    int sheet_count;
+    AttendanceSheetRow **sheet = db_get_attendance_sheet(g_session.current_class_id,
+                                                         validate_date(date_text) ? date_text : "",
+                                                         &sheet_count);
+    int count = sheet ? sheet_count : 0;
+    int marked = 0;
+    
+    MarkRow *rows = g_new(MarkRow, count > 0 ? count : 1);
+    for (int i = 0; i < count; i++) {
+        MarkRow *row = &rows[i];
+        row->student_id = sheet[i]->student_id;
+        g_strlcpy(row->name, sheet[i]->name, sizeof(row->name));
+        g_strlcpy(row->roll_number, sheet[i]->roll_number, sizeof(row->roll_number));
+        row->saved_status = sheet[i]->status;
+        g_strlcpy(row->saved_notes, sheet[i]->notes, sizeof(row->saved_notes));
+        row->status = row->saved_status >= 0 ? row->saved_status : ATTENDANCE_PRESENT;
+        g_strlcpy(row->notes, row->saved_notes, sizeof(row->notes));
+        if (row->saved_status >= 0) marked++;
+    }
+    db_free_attendance_sheet(sheet, sheet_count);
+    
+    ResultModel *model = result_model_new(NUM_MARK_COLS, MARK_COLUMN_TYPES, rows, count,
+                                          get_mark_cell, free_mark_rows);
+    aw->mark_rows = rows;
+    aw->mark_count = count;
+    result_model_attach(GTK_TREE_VIEW(aw->mark_roster), model);
+    g_object_unref(model);
     
     // Update stats label
     char stats_text[200];
-    snprintf(stats_text, sizeof(stats_text), 
-             "Total Students: %d | Ready to mark attendance", count);
+    if (marked > 0) {
+        snprintf(stats_text, sizeof(stats_text), 
+                 "Total Students: %d | %d already marked on %s", count, marked, date_text);
+    } else {
+        snprintf(stats_text, sizeof(stats_text), 
+                 "Total Students: %d | Ready to mark attendance", count);
+    }
     gtk_label_set_text(GTK_LABEL(aw->mark_stats_label), stats_text);
-    
-    gtk_widget_show_all(aw->mark_attendance_grid);
+}
+
+// Reload the roster once the date entry holds a complete date
+static void on_mark_date_changed(GtkEditable *editable, gpointer user_data) {
+    (void)editable;
+    AttendanceWindow *aw = (AttendanceWindow *)user_data;
+    if (validate_date(gtk_entry_get_text(GTK_ENTRY(aw->mark_date_entry)))) {
+        refresh_mark_attendance_list(aw);
+    }
 }
 
 // Mark attendance button callback
@@ -588,84 +974,46 @@ static void on_mark_attendance_clicked(GtkButton *button, gpointer user_data) {
     tm.tm_isdst = -1;  // Let mktime determine DST
     time_t date = mktime(&tm);
     
-    printf("Date string: %s -> timestamp: %lld\n", date_text, (long long)date);
-    
-    // Get all combo boxes and save attendance
-    GList *children = gtk_container_get_children(GTK_CONTAINER(aw->mark_attendance_grid));
-    int saved = 0;
-    
-    // Create a map to store notes by student_id
-    GHashTable *notes_map = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
-    
-    // First pass: collect all notes
-    for (GList *iter = children; iter != NULL; iter = g_list_next(iter)) {
-        GtkWidget *widget = GTK_WIDGET(iter->data);
-        
-        if (GTK_IS_ENTRY(widget)) {
-            int student_id = GPOINTER_TO_INT(g_object_get_data(G_OBJECT(widget), "student_id"));
-            const char *note_text = gtk_entry_get_text(GTK_ENTRY(widget));
-            if (student_id > 0 && note_text && strlen(note_text) > 0) {
-                g_hash_table_insert(notes_map, GINT_TO_POINTER(student_id), g_strdup(note_text));
-            }
-        }
+    // Write only the rows whose status or notes differ from what is stored
+    AttendanceEntry *entries = g_new(AttendanceEntry, aw->mark_count > 0 ? aw->mark_count : 1);
+    int changed = 0;
+    for (int i = 0; i < aw->mark_count; i++) {
+        const MarkRow *row = &aw->mark_rows[i];
+        if (!mark_row_changed(row)) continue;
+        entries[changed].student_id = row->student_id;
+        entries[changed].status = (AttendanceStatus)row->status;
+        entries[changed].notes = row->notes[0] ? row->notes : NULL;
+        changed++;
     }
+    int unchanged = aw->mark_count - changed;
     
-    // Second pass: save attendance with notes
-    for (GList *iter = children; iter != NULL; iter = g_list_next(iter)) {
-        GtkWidget *widget = GTK_WIDGET(iter->data);
-        
-        // Skip if not a combo box
-        if (!GTK_IS_COMBO_BOX(widget)) {
-            continue;
-        }
-        
-        int student_id = GPOINTER_TO_INT(g_object_get_data(G_OBJECT(widget), "student_id"));
-        if (student_id <= 0) {
-            continue;  // Skip widgets without student ID
-        }
-        
-        const char *status_text = gtk_combo_box_text_get_active_text(
-            GTK_COMBO_BOX_TEXT(widget));
-        
-        if (status_text) {
-                AttendanceStatus status;
-                if (strcmp(status_text, "Present") == 0) {
-                    status = ATTENDANCE_PRESENT;
-                } else if (strcmp(status_text, "Late") == 0) {
-                    status = ATTENDANCE_LATE;
-                } else {
-                    status = ATTENDANCE_ABSENT;
-                }
-                
-                // Get notes for this student
-                const char *notes = g_hash_table_lookup(notes_map, GINT_TO_POINTER(student_id));
-                
-                printf("Saving attendance: student_id=%d, date=%lld, status=%d, notes=%s\n", 
-                       student_id, (long long)date, (int)status, notes ? notes : "(none)");
-                if (db_mark_attendance(student_id, date, status, notes ? notes : "")) {
-                    saved++;
-                    printf("Successfully saved for student %d\n", student_id);
-                } else {
-                    printf("Failed to save for student %d\n", student_id);
-                }
-        }
+    if (changed == 0) {
+        g_free(entries);
+        char msg[150];
+        snprintf(msg, sizeof(msg), "No changes to save on %s (%d unchanged)", date_text, unchanged);
+        show_info_dialog(GTK_WINDOW(aw->window), msg);
+        return;
     }
-    g_list_free(children);
-    g_hash_table_destroy(notes_map);
     
-    if (saved > 0) {
-        char msg[100];
-        snprintf(msg, sizeof(msg), "Attendance saved for %d students on %s", 
-                 saved, date_text);
+    int result = db_save_attendance_day(g_session.current_class_id, date, entries, changed);
+    g_free(entries);
+    
+    if (result >= 0) {
+        char msg[150];
+        snprintf(msg, sizeof(msg), "Attendance saved on %s: %d changed, %d unchanged", 
+                 date_text, changed, unchanged);
         show_info_dialog(GTK_WINDOW(aw->window), msg);
         
         // Refresh the view tab to show new attendance
         load_attendance_dates(aw);
         
+        // Reload the roster so it compares against what was just stored
+        refresh_mark_attendance_list(aw);
+        
         // Update stats label in Mark tab
         char stats_text[200];
         snprintf(stats_text, sizeof(stats_text), 
-                 "Attendance successfully saved for %d students on %s", saved, date_text);
+                 "Attendance saved on %s: %d changed, %d unchanged", date_text, changed, unchanged);
         gtk_label_set_text(GTK_LABEL(aw->mark_stats_label), stats_text);
         
         // Switch to View tab to show the saved attendance
@@ -675,6 +1023,275 @@ static void on_mark_attendance_clicked(GtkButton *button, gpointer user_data) {
     }
 }
 
+static void on_sparse_toggled(GtkToggleButton *button, gpointer user_data) {
+    AttendanceWindow *aw = (AttendanceWindow *)user_data;
+    AttendanceStorageMode mode = gtk_toggle_button_get_active(button) ?
+                                 ATTENDANCE_STORE_SPARSE : ATTENDANCE_STORE_FULL;
+    
+    if (!db_set_attendance_mode(g_session.current_class_id, mode)) {
+        show_error_dialog(GTK_WINDOW(aw->window), "Failed to change attendance storage mode");
+    }
+}
+
+// Calendar tab: a year of days coloured by the share of the class that
+// attended, read from the class-day rollup in one query and drawn in one
+// pass. Weeks run down the columns, Monday first.
+#define HEATMAP_CELL 14
+#define HEATMAP_PITCH (HEATMAP_CELL + 3)
+#define HEATMAP_LEFT 36                    // room for weekday labels
+#define HEATMAP_TOP 22                     // room for month labels
+#define HEATMAP_WEEKS 54                   // a year touches at most 54 weeks
+
+static bool is_leap_year(int year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+static int heatmap_day_of_year(int year, int month, int day) {
+    static const int before[12] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
+    return before[month - 1] + day - 1 + (month > 2 && is_leap_year(year));
+}
+
+// "YYYY-MM-DD" of a day of the year
+static void heatmap_date(int year, int yday, char *out, size_t size) {
+    struct tm tm = {0};
+    tm.tm_year = year - 1900;
+    tm.tm_mday = yday + 1;
+    tm.tm_hour = 12;
+    tm.tm_isdst = -1;
+    mktime(&tm);
+    strftime(out, size, "%Y-%m-%d", &tm);
+}
+
+// Column offset of 1 January: 0 when it is a Monday
+static int heatmap_first_weekday(int year) {
+    struct tm tm = {0};
+    tm.tm_year = year - 1900;
+    tm.tm_mday = 1;
+    tm.tm_hour = 12;
+    tm.tm_isdst = -1;
+    mktime(&tm);
+    return (tm.tm_wday + 6) % 7;
+}
+
+// Red through amber to green as the share of present and late students rises
+static void heatmap_color(double rate, double *r, double *g, double *b) {
+    if (rate < 0.5) {
+        double t = rate / 0.5;
+        *r = 0.86;
+        *g = 0.30 + 0.45 * t;
+        *b = 0.30 - 0.10 * t;
+    } else {
+        double t = (rate - 0.5) / 0.5;
+        *r = 0.86 - 0.66 * t;
+        *g = 0.75 - 0.10 * t;
+        *b = 0.20 + 0.10 * t;
+    }
+}
+
+// Re-read the year's days when the year, the class or the data has changed
+static void refresh_heatmap(AttendanceWindow *aw) {
+    unsigned long version = db_data_version();
+    if (aw->heatmap_loaded_year == aw->heatmap_year &&
+        aw->heatmap_loaded_class == g_session.current_class_id &&
+        aw->heatmap_version == version) {
+        return;
+    }
+    
+    char from[20];
+    char to[20];
+    snprintf(from, sizeof(from), "%04d-01-01", aw->heatmap_year);
+    snprintf(to, sizeof(to), "%04d-12-31", aw->heatmap_year);
+    
+    memset(aw->heatmap_days, 0, sizeof(aw->heatmap_days));
+    int count;
+    AttendanceRollup **days = db_get_class_rollup_range(g_session.current_class_id, ROLLUP_CLASS_DAY,
+                                                        from, to, &count);
+    for (int i = 0; days && i < count; i++) {
+        int year, month, day;
+        if (sscanf(days[i]->period, "%d-%d-%d", &year, &month, &day) == 3 &&
+            month >= 1 && month <= 12) {
+            aw->heatmap_days[heatmap_day_of_year(year, month, day)] = *days[i];
+        }
+    }
+    db_free_rollups(days, count);
+    
+    memset(aw->heatmap_holidays, 0, sizeof(aw->heatmap_holidays));
+    char **holidays = db_get_class_holidays(g_session.current_class_id, from, to, &count);
+    for (int i = 0; holidays && i < count; i++) {
+        int year, month, day;
+        if (sscanf(holidays[i], "%d-%d-%d", &year, &month, &day) == 3 &&
+            month >= 1 && month <= 12) {
+            aw->heatmap_holidays[heatmap_day_of_year(year, month, day)] = true;
+        }
+    }
+    db_free_attendance_dates(holidays, count);
+    
+    aw->heatmap_loaded_year = aw->heatmap_year;
+    aw->heatmap_loaded_class = g_session.current_class_id;
+    aw->heatmap_version = version;
+    
+    char year_text[16];
+    snprintf(year_text, sizeof(year_text), "%d", aw->heatmap_year);
+    gtk_label_set_text(GTK_LABEL(aw->heatmap_year_label), year_text);
+    gtk_widget_queue_draw(aw->heatmap);
+}
+
+static gboolean on_heatmap_draw(GtkWidget *widget, cairo_t *cr, gpointer user_data) {
+    AttendanceWindow *aw = (AttendanceWindow *)user_data;
+    static const char *weekdays[7] = {"Mon", NULL, "Wed", NULL, "Fri", NULL, NULL};
+    static const char *months[12] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                     "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+    int year = aw->heatmap_year;
+    int first = heatmap_first_weekday(year);
+    int days = is_leap_year(year) ? 366 : 365;
+    
+    GdkRGBA fg;
+    GtkStyleContext *context = gtk_widget_get_style_context(widget);
+    gtk_style_context_get_color(context, gtk_widget_get_state_flags(widget), &fg);
+    
+    cairo_select_font_face(cr, "Sans", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
+    cairo_set_font_size(cr, 10);
+    gdk_cairo_set_source_rgba(cr, &fg);
+    for (int i = 0; i < 7; i++) {
+        if (!weekdays[i]) continue;
+        cairo_move_to(cr, 0, HEATMAP_TOP + i * HEATMAP_PITCH + HEATMAP_CELL - 3);
+        cairo_show_text(cr, weekdays[i]);
+    }
+    for (int m = 0; m < 12; m++) {
+        int week = (first + heatmap_day_of_year(year, m + 1, 1)) / 7;
+        cairo_move_to(cr, HEATMAP_LEFT + week * HEATMAP_PITCH, HEATMAP_TOP - 8);
+        cairo_show_text(cr, months[m]);
+    }
+    
+    for (int yday = 0; yday < days; yday++) {
+        const AttendanceRollup *day = &aw->heatmap_days[yday];
+        int total = day->present + day->absent + day->late;
+        if (total > 0) {
+            double r, g, b;
+            heatmap_color((double)(day->present + day->late) / total, &r, &g, &b);
+            cairo_set_source_rgb(cr, r, g, b);
+        } else if (aw->heatmap_holidays[yday]) {
+            cairo_set_source_rgb(cr, 0.45, 0.62, 0.86);
+        } else {
+            cairo_set_source_rgba(cr, fg.red, fg.green, fg.blue, 0.08);
+        }
+        int cell = first + yday;
+        cairo_rectangle(cr, HEATMAP_LEFT + (cell / 7) * HEATMAP_PITCH,
+                        HEATMAP_TOP + (cell % 7) * HEATMAP_PITCH, HEATMAP_CELL, HEATMAP_CELL);
+        cairo_fill(cr);
+    }
+    
+    // Legend: 0% to 100% in quarters
+    double y = HEATMAP_TOP + 7 * HEATMAP_PITCH + 10;
+    gdk_cairo_set_source_rgba(cr, &fg);
+    cairo_move_to(cr, HEATMAP_LEFT, y + HEATMAP_CELL - 3);
+    cairo_show_text(cr, "0%");
+    for (int i = 0; i <= 4; i++) {
+        double r, g, b;
+        heatmap_color(i / 4.0, &r, &g, &b);
+        cairo_set_source_rgb(cr, r, g, b);
+        cairo_rectangle(cr, HEATMAP_LEFT + 24 + i * HEATMAP_PITCH, y, HEATMAP_CELL, HEATMAP_CELL);
+        cairo_fill(cr);
+    }
+    gdk_cairo_set_source_rgba(cr, &fg);
+    cairo_move_to(cr, HEATMAP_LEFT + 28 + 5 * HEATMAP_PITCH, y + HEATMAP_CELL - 3);
+    cairo_show_text(cr, "100% attended");
+    return FALSE;
+}
+
+// Day of the year under a point of the heatmap, or -1
+static int heatmap_day_at(AttendanceWindow *aw, double x, double y) {
+    if (x < HEATMAP_LEFT || y < HEATMAP_TOP) return -1;
+    int week = (int)(x - HEATMAP_LEFT) / HEATMAP_PITCH;
+    int weekday = (int)(y - HEATMAP_TOP) / HEATMAP_PITCH;
+    if (week >= HEATMAP_WEEKS || weekday >= 7) return -1;
+    
+    int yday = week * 7 + weekday - heatmap_first_weekday(aw->heatmap_year);
+    int days = is_leap_year(aw->heatmap_year) ? 366 : 365;
+    return yday >= 0 && yday < days ? yday : -1;
+}
+
+static gboolean on_heatmap_query_tooltip(GtkWidget *widget, gint x, gint y, gboolean keyboard_mode,
+                                         GtkTooltip *tooltip, gpointer user_data) {
+    (void)widget;
+    (void)keyboard_mode;
+    AttendanceWindow *aw = (AttendanceWindow *)user_data;
+    int yday = heatmap_day_at(aw, x, y);
+    if (yday < 0) return FALSE;
+    
+    char date[20];
+    heatmap_date(aw->heatmap_year, yday, date, sizeof(date));
+    const AttendanceRollup *day = &aw->heatmap_days[yday];
+    int total = day->present + day->absent + day->late;
+    
+    char text[200];
+    if (total > 0) {
+        snprintf(text, sizeof(text), "%s (%s)\n%d%% attended: %d present, %d late, %d absent",
+                 date, get_day_of_week(date), (day->present + day->late) * 100 / total,
+                 day->present, day->late, day->absent);
+    } else if (aw->heatmap_holidays[yday]) {
+        snprintf(text, sizeof(text), "%s (%s)\nHoliday", date, get_day_of_week(date));
+    } else {
+        snprintf(text, sizeof(text), "%s (%s)\nNo attendance recorded", date, get_day_of_week(date));
+    }
+    gtk_tooltip_set_text(tooltip, text);
+    return TRUE;
+}
+
+// Clicking a recorded day opens its sheet on the View tab
+static gboolean on_heatmap_button_press(GtkWidget *widget, GdkEventButton *event, gpointer user_data) {
+    (void)widget;
+    AttendanceWindow *aw = (AttendanceWindow *)user_data;
+    int yday = heatmap_day_at(aw, event->x, event->y);
+    if (yday < 0) return FALSE;
+    
+    const AttendanceRollup *day = &aw->heatmap_days[yday];
+    if (day->present + day->absent + day->late == 0) return FALSE;
+    
+    char date[20];
+    heatmap_date(aw->heatmap_year, yday, date, sizeof(date));
+    
+    // Select the date in the list when the current search shows it
+    GtkListBox *listbox = GTK_LIST_BOX(aw->date_listbox);
+    GtkListBoxRow *row;
+    for (int i = 0; (row = gtk_list_box_get_row_at_index(listbox, i)) != NULL; i++) {
+        const char *row_date = g_object_get_data(G_OBJECT(row), "date");
+        if (row_date && strcmp(row_date, date) == 0) {
+            gtk_list_box_select_row(listbox, row);
+            break;
+        }
+    }
+    
+    show_attendance_for_date(aw, date);
+    gtk_notebook_set_current_page(GTK_NOTEBOOK(aw->notebook), 0);
+    return TRUE;
+}
+
+static void on_heatmap_prev_year(GtkButton *button, gpointer user_data) {
+    (void)button;
+    AttendanceWindow *aw = (AttendanceWindow *)user_data;
+    aw->heatmap_year--;
+    refresh_heatmap(aw);
+}
+
+static void on_heatmap_next_year(GtkButton *button, gpointer user_data) {
+    (void)button;
+    AttendanceWindow *aw = (AttendanceWindow *)user_data;
+    aw->heatmap_year++;
+    refresh_heatmap(aw);
+}
+
+// Re-read the heatmap when its tab is shown, as marks may have changed since
+static void on_notebook_switch_page(GtkNotebook *notebook, GtkWidget *page, guint page_num,
+                                    gpointer user_data) {
+    (void)notebook;
+    (void)page_num;
+    AttendanceWindow *aw = (AttendanceWindow *)user_data;
+    if (gtk_widget_is_ancestor(aw->heatmap, page)) {
+        refresh_heatmap(aw);
+    }
+}
+
 // Create View Attendance tab
 static GtkWidget* create_view_tab(AttendanceWindow *aw) {
     GtkWidget *main_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 0);
@@ -700,8 +1317,12 @@ static GtkWidget* create_view_tab(AttendanceWindow *aw) {
     gtk_box_pack_start(GTK_BOX(search_box), search_label, FALSE, FALSE, 0);
     
     aw->search_entry = gtk_entry_new();
-    gtk_entry_set_placeholder_text(GTK_ENTRY(aw->search_entry), "YYYY-MM-DD");
+    gtk_entry_set_placeholder_text(GTK_ENTRY(aw->search_entry), "YYYY, YYYY-MM or YYYY-MM-DD");
+    gtk_widget_set_tooltip_text(aw->search_entry,
+                                "Dates starting with the text, or a range such as 2024-01..2024-03");
     gtk_widget_set_size_request(aw->search_entry, 200, -1);
+    g_signal_connect(aw->search_entry, "changed", G_CALLBACK(on_search_text_changed), aw);
+    g_signal_connect(aw->search_entry, "activate", G_CALLBACK(on_search_changed), aw);
     GtkStyleContext *search_ctx = gtk_widget_get_style_context(aw->search_entry);
     gtk_style_context_add_class(search_ctx, "date-entry");
     gtk_box_pack_start(GTK_BOX(search_box), aw->search_entry, FALSE, FALSE, 0);
@@ -755,22 +1376,97 @@ static GtkWidget* create_view_tab(AttendanceWindow *aw) {
                      G_CALLBACK(on_delete_attendance_clicked), aw);
     gtk_box_pack_start(GTK_BOX(right_box), delete_btn, FALSE, FALSE, 5);
     
+    // Bulk changes to the class: a range of days, or a copy of the
+    // selected date onto "From"
+    GtkWidget *bulk_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
+    gtk_box_pack_start(GTK_BOX(bulk_box), gtk_label_new("From:"), FALSE, FALSE, 0);
+    aw->bulk_from_entry = gtk_entry_new();
+    gtk_entry_set_placeholder_text(GTK_ENTRY(aw->bulk_from_entry), "YYYY-MM-DD");
+    gtk_entry_set_width_chars(GTK_ENTRY(aw->bulk_from_entry), 11);
+    gtk_box_pack_start(GTK_BOX(bulk_box), aw->bulk_from_entry, FALSE, FALSE, 0);
+    
+    gtk_box_pack_start(GTK_BOX(bulk_box), gtk_label_new("To:"), FALSE, FALSE, 0);
+    aw->bulk_to_entry = gtk_entry_new();
+    gtk_entry_set_placeholder_text(GTK_ENTRY(aw->bulk_to_entry), "YYYY-MM-DD");
+    gtk_entry_set_width_chars(GTK_ENTRY(aw->bulk_to_entry), 11);
+    gtk_box_pack_start(GTK_BOX(bulk_box), aw->bulk_to_entry, FALSE, FALSE, 0);
+    
+    aw->bulk_status_combo = gtk_combo_box_text_new();
+    for (int status = ATTENDANCE_ABSENT; status <= ATTENDANCE_LATE; status++) {
+        gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(aw->bulk_status_combo), MARK_STATUS_TEXT[status]);
+    }
+    gtk_combo_box_set_active(GTK_COMBO_BOX(aw->bulk_status_combo), ATTENDANCE_PRESENT);
+    gtk_box_pack_start(GTK_BOX(bulk_box), aw->bulk_status_combo, FALSE, FALSE, 0);
+    
+    aw->bulk_weekdays_check = gtk_check_button_new_with_label("Weekdays only");
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(aw->bulk_weekdays_check), TRUE);
+    gtk_box_pack_start(GTK_BOX(bulk_box), aw->bulk_weekdays_check, FALSE, FALSE, 0);
+    
+    GtkWidget *fill_btn = gtk_button_new_with_label("Fill Range");
+    gtk_widget_set_tooltip_text(fill_btn, "Mark every student on the days of the range not recorded yet");
+    g_signal_connect(fill_btn, "clicked", G_CALLBACK(on_bulk_fill_clicked), aw);
+    gtk_box_pack_start(GTK_BOX(bulk_box), fill_btn, FALSE, FALSE, 0);
+    
+    GtkWidget *copy_btn = gtk_button_new_with_label("Copy Selected to From");
+    g_signal_connect(copy_btn, "clicked", G_CALLBACK(on_bulk_copy_clicked), aw);
+    gtk_box_pack_start(GTK_BOX(bulk_box), copy_btn, FALSE, FALSE, 0);
+    
+    GtkWidget *holiday_btn = gtk_button_new_with_label("Mark Holiday");
+    g_signal_connect(holiday_btn, "clicked", G_CALLBACK(on_bulk_holiday_clicked), aw);
+    gtk_box_pack_start(GTK_BOX(bulk_box), holiday_btn, FALSE, FALSE, 0);
+    
+    aw->undo_button = gtk_button_new_with_label("Undo");
+    g_signal_connect(aw->undo_button, "clicked", G_CALLBACK(on_bulk_undo_clicked), aw);
+    gtk_box_pack_start(GTK_BOX(bulk_box), aw->undo_button, FALSE, FALSE, 0);
+    refresh_undo_button(aw);
+    
+    GtkWidget *import_btn = gtk_button_new_with_label("Import CSV...");
+    gtk_widget_set_tooltip_text(import_btn, "Add past attendance from a spreadsheet, a row per mark "
+                                "(roll, date, status) or a column per day");
+    g_signal_connect(import_btn, "clicked", G_CALLBACK(on_import_attendance_clicked), aw);
+    gtk_box_pack_start(GTK_BOX(bulk_box), import_btn, FALSE, FALSE, 0);
+    
+    gtk_box_pack_start(GTK_BOX(right_box), bulk_box, FALSE, FALSE, 0);
+    
     GtkWidget *right_scroll = gtk_scrolled_window_new(NULL, NULL);
     gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(right_scroll),
                                    GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
     
-    aw->attendance_grid = gtk_grid_new();
-    gtk_grid_set_row_spacing(GTK_GRID(aw->attendance_grid), 8);
-    gtk_grid_set_column_spacing(GTK_GRID(aw->attendance_grid), 20);
-    gtk_widget_set_margin_start(aw->attendance_grid, 20);
-    gtk_widget_set_margin_end(aw->attendance_grid, 20);
-    gtk_widget_set_margin_top(aw->attendance_grid, 10);
-    gtk_widget_set_margin_bottom(aw->attendance_grid, 10);
+    // Sheet: fixed-height rows, so only the visible rows are ever measured;
+    // long notes are ellipsized and shown in full as a tooltip
+    aw->attendance_sheet = gtk_tree_view_new();
+    gtk_tree_view_set_grid_lines(GTK_TREE_VIEW(aw->attendance_sheet), GTK_TREE_VIEW_GRID_LINES_HORIZONTAL);
+    gtk_widget_set_margin_start(aw->attendance_sheet, 20);
+    gtk_widget_set_margin_end(aw->attendance_sheet, 20);
+    gtk_widget_set_margin_top(aw->attendance_sheet, 10);
+    gtk_widget_set_margin_bottom(aw->attendance_sheet, 10);
+    
+    const char *headers[] = {"Student Name", "Roll No", "Status", "Notes"};
+    const int widths[] = {220, 100, 110, 300};
+    for (int i = 0; i < NUM_SHEET_COLS; i++) {
+        GtkCellRenderer *renderer = gtk_cell_renderer_text_new();
+        g_object_set(renderer, "ellipsize", PANGO_ELLIPSIZE_END, NULL);
+        GtkTreeViewColumn *column = gtk_tree_view_column_new_with_attributes(
+            headers[i], renderer, i == SHEET_COL_STATUS ? "markup" : "text", i, NULL);
+        gtk_tree_view_column_set_sizing(column, GTK_TREE_VIEW_COLUMN_FIXED);
+        gtk_tree_view_column_set_fixed_width(column, widths[i]);
+        gtk_tree_view_column_set_resizable(column, TRUE);
+        if (i == SHEET_COL_NAME || i == SHEET_COL_ROLL) {
+            gtk_tree_view_column_set_sort_column_id(column, i);
+        }
+        if (i == SHEET_COL_NOTES) {
+            gtk_tree_view_column_set_expand(column, TRUE);
+        }
+        gtk_tree_view_append_column(GTK_TREE_VIEW(aw->attendance_sheet), column);
+    }
+    gtk_tree_view_set_fixed_height_mode(GTK_TREE_VIEW(aw->attendance_sheet), TRUE);
+    gtk_tree_view_set_tooltip_column(GTK_TREE_VIEW(aw->attendance_sheet), SHEET_COL_NOTES);
+    clear_attendance_sheet(aw);
     
-    GtkStyleContext *grid_ctx = gtk_widget_get_style_context(aw->attendance_grid);
-    gtk_style_context_add_class(grid_ctx, "attendance-section");
+    GtkStyleContext *sheet_ctx = gtk_widget_get_style_context(aw->attendance_sheet);
+    gtk_style_context_add_class(sheet_ctx, "attendance-section");
     
-    gtk_container_add(GTK_CONTAINER(right_scroll), aw->attendance_grid);
+    gtk_container_add(GTK_CONTAINER(right_scroll), aw->attendance_sheet);
     gtk_box_pack_start(GTK_BOX(right_box), right_scroll, TRUE, TRUE, 0);
     
     gtk_paned_pack2(GTK_PANED(paned), right_box, TRUE, FALSE);
@@ -815,27 +1511,81 @@ static GtkWidget* create_mark_tab(AttendanceWindow *aw) {
     char today[20];
     strftime(today, sizeof(today), "%Y-%m-%d", tm_info);
     gtk_entry_set_text(GTK_ENTRY(aw->mark_date_entry), today);
+    g_signal_connect(aw->mark_date_entry, "changed", G_CALLBACK(on_mark_date_changed), aw);
     
     gtk_box_pack_start(GTK_BOX(date_container), aw->mark_date_entry, FALSE, FALSE, 0);
     gtk_box_pack_start(GTK_BOX(main_box), date_container, FALSE, FALSE, 0);
     
+    // Storage mode: applies to days recorded from now on
+    aw->sparse_check = gtk_check_button_new_with_label("Record only absences and late arrivals");
+    gtk_widget_set_tooltip_text(aw->sparse_check,
+        "Students with no record on a day saved this way count as present");
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(aw->sparse_check),
+        db_get_attendance_mode(g_session.current_class_id) == ATTENDANCE_STORE_SPARSE);
+    g_signal_connect(aw->sparse_check, "toggled", G_CALLBACK(on_sparse_toggled), aw);
+    gtk_box_pack_start(GTK_BOX(main_box), aw->sparse_check, FALSE, FALSE, 0);
+    
     // Student list scroll
     GtkWidget *scroll = gtk_scrolled_window_new(NULL, NULL);
     gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(scroll),
                                    GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
     
-    aw->mark_attendance_grid = gtk_grid_new();
-    gtk_grid_set_row_spacing(GTK_GRID(aw->mark_attendance_grid), 10);
-    gtk_grid_set_column_spacing(GTK_GRID(aw->mark_attendance_grid), 20);
-    gtk_widget_set_margin_start(aw->mark_attendance_grid, 10);
-    gtk_widget_set_margin_end(aw->mark_attendance_grid, 10);
-    gtk_widget_set_margin_top(aw->mark_attendance_grid, 10);
-    gtk_widget_set_margin_bottom(aw->mark_attendance_grid, 10);
-    
-    GtkStyleContext *grid_ctx = gtk_widget_get_style_context(aw->mark_attendance_grid);
-    gtk_style_context_add_class(grid_ctx, "attendance-section");
-    
-    gtk_container_add(GTK_CONTAINER(scroll), aw->mark_attendance_grid);
+    // Roster: status and notes are edited in place through cell renderers
+    aw->mark_roster = gtk_tree_view_new();
+    gtk_tree_view_set_grid_lines(GTK_TREE_VIEW(aw->mark_roster), GTK_TREE_VIEW_GRID_LINES_HORIZONTAL);
+    gtk_widget_set_margin_start(aw->mark_roster, 10);
+    gtk_widget_set_margin_end(aw->mark_roster, 10);
+    gtk_widget_set_margin_top(aw->mark_roster, 10);
+    gtk_widget_set_margin_bottom(aw->mark_roster, 10);
+    
+    GtkCellRenderer *renderer;
+    GtkTreeViewColumn *column;
+    
+    renderer = gtk_cell_renderer_text_new();
+    g_object_set(renderer, "ellipsize", PANGO_ELLIPSIZE_END, NULL);
+    column = gtk_tree_view_column_new_with_attributes("Student", renderer, "text", MARK_COL_NAME, NULL);
+    gtk_tree_view_column_set_sizing(column, GTK_TREE_VIEW_COLUMN_FIXED);
+    gtk_tree_view_column_set_fixed_width(column, 220);
+    gtk_tree_view_column_set_resizable(column, TRUE);
+    gtk_tree_view_append_column(GTK_TREE_VIEW(aw->mark_roster), column);
+    
+    renderer = gtk_cell_renderer_text_new();
+    column = gtk_tree_view_column_new_with_attributes("Roll Number", renderer, "text", MARK_COL_ROLL, NULL);
+    gtk_tree_view_column_set_sizing(column, GTK_TREE_VIEW_COLUMN_FIXED);
+    gtk_tree_view_column_set_fixed_width(column, 120);
+    gtk_tree_view_append_column(GTK_TREE_VIEW(aw->mark_roster), column);
+    
+    const AttendanceStatus choices[] = {ATTENDANCE_PRESENT, ATTENDANCE_ABSENT, ATTENDANCE_LATE};
+    GtkListStore *statuses = gtk_list_store_new(1, G_TYPE_STRING);
+    for (int i = 0; i < 3; i++) {
+        gtk_list_store_insert_with_values(statuses, NULL, -1, 0, MARK_STATUS_TEXT[choices[i]], -1);
+    }
+    renderer = gtk_cell_renderer_combo_new();
+    g_object_set(renderer, "model", statuses, "text-column", 0, "has-entry", FALSE,
+                 "editable", TRUE, NULL);
+    g_object_unref(statuses);
+    g_signal_connect(renderer, "edited", G_CALLBACK(on_mark_status_edited), aw);
+    column = gtk_tree_view_column_new_with_attributes("Status", renderer, "text", MARK_COL_STATUS, NULL);
+    gtk_tree_view_column_set_sizing(column, GTK_TREE_VIEW_COLUMN_FIXED);
+    gtk_tree_view_column_set_fixed_width(column, 120);
+    gtk_tree_view_append_column(GTK_TREE_VIEW(aw->mark_roster), column);
+    
+    renderer = gtk_cell_renderer_text_new();
+    g_object_set(renderer, "editable", TRUE, "placeholder-text", "Add note...",
+                 "ellipsize", PANGO_ELLIPSIZE_END, NULL);
+    g_signal_connect(renderer, "edited", G_CALLBACK(on_mark_notes_edited), aw);
+    column = gtk_tree_view_column_new_with_attributes("Notes (Optional)", renderer, "text", MARK_COL_NOTES, NULL);
+    gtk_tree_view_column_set_sizing(column, GTK_TREE_VIEW_COLUMN_FIXED);
+    gtk_tree_view_column_set_fixed_width(column, 260);
+    gtk_tree_view_column_set_expand(column, TRUE);
+    gtk_tree_view_append_column(GTK_TREE_VIEW(aw->mark_roster), column);
+    
+    gtk_tree_view_set_fixed_height_mode(GTK_TREE_VIEW(aw->mark_roster), TRUE);
+    
+    GtkStyleContext *roster_ctx = gtk_widget_get_style_context(aw->mark_roster);
+    gtk_style_context_add_class(roster_ctx, "attendance-section");
+    
+    gtk_container_add(GTK_CONTAINER(scroll), aw->mark_roster);
     gtk_box_pack_start(GTK_BOX(main_box), scroll, TRUE, TRUE, 0);
     
     // Stats label for Mark tab
@@ -864,6 +1614,75 @@ static GtkWidget* create_mark_tab(AttendanceWindow *aw) {
     return main_box;
 }
 
+static void free_attendance_window(AttendanceWindow *aw) {
+    if (aw->search_timeout) {
+        g_source_remove(aw->search_timeout);
+    }
+    if (aw->prefetch_idle) {
+        g_source_remove(aw->prefetch_idle);
+    }
+    g_free(aw);
+}
+
+// Create Calendar tab: the heatmap with a year selector
+static GtkWidget* create_calendar_tab(AttendanceWindow *aw) {
+    GtkWidget *main_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 10);
+    gtk_widget_set_margin_start(main_box, 20);
+    gtk_widget_set_margin_end(main_box, 20);
+    gtk_widget_set_margin_top(main_box, 20);
+    gtk_widget_set_margin_bottom(main_box, 20);
+    
+    // Header
+    GtkWidget *header = gtk_label_new(NULL);
+    gtk_label_set_markup(GTK_LABEL(header), 
+        "<span size='large'>Attendance Calendar</span>");
+    GtkStyleContext *header_ctx = gtk_widget_get_style_context(header);
+    gtk_style_context_add_class(header_ctx, "attendance-header");
+    gtk_box_pack_start(GTK_BOX(main_box), header, FALSE, FALSE, 0);
+    
+    // Year navigation
+    GtkWidget *nav_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 10);
+    GtkStyleContext *nav_ctx = gtk_widget_get_style_context(nav_box);
+    gtk_style_context_add_class(nav_ctx, "date-search-box");
+    
+    GtkWidget *prev_btn = gtk_button_new_with_label("◀");
+    g_signal_connect(prev_btn, "clicked", G_CALLBACK(on_heatmap_prev_year), aw);
+    gtk_box_pack_start(GTK_BOX(nav_box), prev_btn, FALSE, FALSE, 0);
+    
+    time_t now = time(NULL);
+    aw->heatmap_year = localtime(&now)->tm_year + 1900;
+    aw->heatmap_year_label = gtk_label_new(NULL);
+    gtk_box_pack_start(GTK_BOX(nav_box), aw->heatmap_year_label, FALSE, FALSE, 0);
+    
+    GtkWidget *next_btn = gtk_button_new_with_label("▶");
+    g_signal_connect(next_btn, "clicked", G_CALLBACK(on_heatmap_next_year), aw);
+    gtk_box_pack_start(GTK_BOX(nav_box), next_btn, FALSE, FALSE, 0);
+    
+    GtkWidget *hint = gtk_label_new("Hover over a day for its counts; click it to open the sheet");
+    gtk_box_pack_start(GTK_BOX(nav_box), hint, FALSE, FALSE, 10);
+    gtk_box_pack_start(GTK_BOX(main_box), nav_box, FALSE, FALSE, 0);
+    
+    // Heatmap
+    aw->heatmap = gtk_drawing_area_new();
+    gtk_widget_set_size_request(aw->heatmap, HEATMAP_LEFT + HEATMAP_WEEKS * HEATMAP_PITCH,
+                                HEATMAP_TOP + 8 * HEATMAP_PITCH + 10);
+    gtk_widget_add_events(aw->heatmap, GDK_BUTTON_PRESS_MASK);
+    gtk_widget_set_has_tooltip(aw->heatmap, TRUE);
+    g_signal_connect(aw->heatmap, "draw", G_CALLBACK(on_heatmap_draw), aw);
+    g_signal_connect(aw->heatmap, "query-tooltip", G_CALLBACK(on_heatmap_query_tooltip), aw);
+    g_signal_connect(aw->heatmap, "button-press-event", G_CALLBACK(on_heatmap_button_press), aw);
+    
+    GtkWidget *scroll = gtk_scrolled_window_new(NULL, NULL);
+    gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(scroll),
+                                   GTK_POLICY_AUTOMATIC, GTK_POLICY_NEVER);
+    gtk_container_add(GTK_CONTAINER(scroll), aw->heatmap);
+    GtkStyleContext *section_ctx = gtk_widget_get_style_context(scroll);
+    gtk_style_context_add_class(section_ctx, "attendance-section");
+    gtk_box_pack_start(GTK_BOX(main_box), scroll, FALSE, FALSE, 0);
+    
+    return main_box;
+}
+
 // Main show attendance window function
 void show_attendance_window(GtkWidget *parent) {
     AttendanceWindow *aw = g_new0(AttendanceWindow, 1);
@@ -892,6 +1711,12 @@ void show_attendance_window(GtkWidget *parent) {
     gtk_notebook_append_page(GTK_NOTEBOOK(aw->notebook), mark_tab,
                             gtk_label_new("Mark Attendance"));
     
+    // Add Calendar tab
+    GtkWidget *calendar_tab = create_calendar_tab(aw);
+    gtk_notebook_append_page(GTK_NOTEBOOK(aw->notebook), calendar_tab,
+                            gtk_label_new("Calendar"));
+    g_signal_connect(aw->notebook, "switch-page", G_CALLBACK(on_notebook_switch_page), aw);
+    
     gtk_container_add(GTK_CONTAINER(aw->window), aw->notebook);
     
     // Load initial data
@@ -900,7 +1725,7 @@ void show_attendance_window(GtkWidget *parent) {
     
     // Cleanup on close
     g_signal_connect_swapped(aw->window, "destroy",
-                             G_CALLBACK(g_free), aw);
+                             G_CALLBACK(free_attendance_window), aw);
     
     gtk_widget_show_all(aw->window);
 }
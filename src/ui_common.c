@@ -0,0 +1,120 @@
+#include "ui_common.h"
+
+void show_error_dialog(GtkWindow *parent, const char *message) {
+    GtkWidget *dialog;
+    dialog = gtk_message_dialog_new(parent,
+                                   GTK_DIALOG_MODAL | GTK_DIALOG_DESTROY_WITH_PARENT,
+                                   GTK_MESSAGE_ERROR,
+                                   GTK_BUTTONS_OK,
+                                   "%s", message);
+    gtk_window_set_title(GTK_WINDOW(dialog), "Error");
+    gtk_dialog_run(GTK_DIALOG(dialog));
+    gtk_widget_destroy(dialog);
+}
+
+void show_info_dialog(GtkWindow *parent, const char *message) {
+    GtkWidget *dialog;
+    dialog = gtk_message_dialog_new(parent,
+                                   GTK_DIALOG_MODAL | GTK_DIALOG_DESTROY_WITH_PARENT,
+                                   GTK_MESSAGE_INFO,
+                                   GTK_BUTTONS_OK,
+                                   "%s", message);
+    gtk_window_set_title(GTK_WINDOW(dialog), "Information");
+    gtk_dialog_run(GTK_DIALOG(dialog));
+    gtk_widget_destroy(dialog);
+}
+
+bool show_confirm_dialog(GtkWindow *parent, const char *message) {
+    GtkWidget *dialog;
+    gint result;
+    
+    dialog = gtk_message_dialog_new(parent,
+                                   GTK_DIALOG_MODAL | GTK_DIALOG_DESTROY_WITH_PARENT,
+                                   GTK_MESSAGE_QUESTION,
+                                   GTK_BUTTONS_YES_NO,
+                                   "%s", message);
+    gtk_window_set_title(GTK_WINDOW(dialog), "Confirm");
+    result = gtk_dialog_run(GTK_DIALOG(dialog));
+    gtk_widget_destroy(dialog);
+    
+    return (result == GTK_RESPONSE_YES);
+}
+
+void show_details_dialog(GtkWindow *parent, const char *message, const char *details) {
+    GtkWidget *dialog;
+    dialog = gtk_message_dialog_new(parent,
+                                   GTK_DIALOG_MODAL | GTK_DIALOG_DESTROY_WITH_PARENT,
+                                   GTK_MESSAGE_INFO,
+                                   GTK_BUTTONS_OK,
+                                   "%s", message);
+    gtk_window_set_title(GTK_WINDOW(dialog), "Information");
+    
+    if (details && details[0]) {
+        GtkWidget *scrolled = gtk_scrolled_window_new(NULL, NULL);
+        gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(scrolled),
+                                       GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
+        gtk_widget_set_size_request(scrolled, 460, 220);
+        
+        GtkWidget *text_view = gtk_text_view_new();
+        gtk_text_view_set_editable(GTK_TEXT_VIEW(text_view), FALSE);
+        gtk_text_view_set_monospace(GTK_TEXT_VIEW(text_view), TRUE);
+        gtk_text_buffer_set_text(gtk_text_view_get_buffer(GTK_TEXT_VIEW(text_view)), details, -1);
+        gtk_container_add(GTK_CONTAINER(scrolled), text_view);
+        
+        GtkWidget *area = gtk_message_dialog_get_message_area(GTK_MESSAGE_DIALOG(dialog));
+        gtk_box_pack_start(GTK_BOX(area), scrolled, TRUE, TRUE, 0);
+        gtk_widget_show_all(scrolled);
+    }
+    
+    gtk_dialog_run(GTK_DIALOG(dialog));
+    gtk_widget_destroy(dialog);
+}
+
+static char* choose_open_file(GtkWindow *parent, const char *title, GtkFileFilter *filter) {
+    GtkWidget *dialog = gtk_file_chooser_dialog_new(title, parent,
+                                                    GTK_FILE_CHOOSER_ACTION_OPEN,
+                                                    "_Cancel", GTK_RESPONSE_CANCEL,
+                                                    "_Open", GTK_RESPONSE_ACCEPT,
+                                                    NULL);
+    gtk_file_chooser_add_filter(GTK_FILE_CHOOSER(dialog), filter);
+    
+    char *path = NULL;
+    if (gtk_dialog_run(GTK_DIALOG(dialog)) == GTK_RESPONSE_ACCEPT) {
+        path = gtk_file_chooser_get_filename(GTK_FILE_CHOOSER(dialog));
+    }
+    gtk_widget_destroy(dialog);
+    return path;
+}
+
+char* choose_csv_file(GtkWindow *parent, const char *title) {
+    GtkFileFilter *filter = gtk_file_filter_new();
+    gtk_file_filter_set_name(filter, "CSV and TSV files");
+    gtk_file_filter_add_pattern(filter, "*.csv");
+    gtk_file_filter_add_pattern(filter, "*.tsv");
+    gtk_file_filter_add_pattern(filter, "*.txt");
+    return choose_open_file(parent, title, filter);
+}
+
+char* choose_snapshot_file(GtkWindow *parent, const char *title) {
+    GtkFileFilter *filter = gtk_file_filter_new();
+    gtk_file_filter_set_name(filter, "Class snapshots");
+    gtk_file_filter_add_pattern(filter, "*.akclass");
+    return choose_open_file(parent, title, filter);
+}
+
+char* choose_save_file(GtkWindow *parent, const char *title, const char *suggested_name) {
+    GtkWidget *dialog = gtk_file_chooser_dialog_new(title, parent,
+                                                    GTK_FILE_CHOOSER_ACTION_SAVE,
+                                                    "_Cancel", GTK_RESPONSE_CANCEL,
+                                                    "_Save", GTK_RESPONSE_ACCEPT,
+                                                    NULL);
+    gtk_file_chooser_set_do_overwrite_confirmation(GTK_FILE_CHOOSER(dialog), TRUE);
+    gtk_file_chooser_set_current_name(GTK_FILE_CHOOSER(dialog), suggested_name);
+    
+    char *path = NULL;
+    if (gtk_dialog_run(GTK_DIALOG(dialog)) == GTK_RESPONSE_ACCEPT) {
+        path = gtk_file_chooser_get_filename(GTK_FILE_CHOOSER(dialog));
+    }
+    gtk_widget_destroy(dialog);
+    return path;
+}
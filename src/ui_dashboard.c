@@ -5,6 +5,7 @@
 #include "ui_reports.h"
 #include "ui_classes.h"
 #include "database.h"
+#include "db_snapshot.h"
 
 typedef struct {
     GtkWidget *window;
@@ -201,6 +202,72 @@ static void on_delete_class_clicked(GtkButton *button, gpointer user_data) {
     free(class_info);
 }
 
+// Save the selected class, with everything recorded for it, as a snapshot
+// file another installation can import
+static void on_export_class_clicked(GtkButton *button, gpointer user_data) {
+    (void)button;
+    DashboardWindow *dw = (DashboardWindow *)user_data;
+    
+    if (g_session.current_class_id == 0) {
+        show_error_dialog(GTK_WINDOW(dw->window), "Please select a class to export.");
+        return;
+    }
+    
+    Class *class_info = db_get_class_by_id(g_session.current_class_id);
+    if (!class_info) {
+        show_error_dialog(GTK_WINDOW(dw->window), "Failed to get class information.");
+        return;
+    }
+    
+    char *suggested = g_strdup_printf("%s.akclass", class_info->name);
+    g_strdelimit(suggested, "/\\:", '_');
+    char *path = choose_save_file(GTK_WINDOW(dw->window), "Export Class", suggested);
+    g_free(suggested);
+    
+    if (path) {
+        long size = db_snapshot_export(path, g_session.current_class_id, db_snapshot_has_zstd());
+        if (size >= 0) {
+            char message[600];
+            snprintf(message, sizeof(message), "Exported '%s' to %s (%ld KB).",
+                     class_info->name, path, (size + 1023) / 1024);
+            show_info_dialog(GTK_WINDOW(dw->window), message);
+        } else {
+            show_error_dialog(GTK_WINDOW(dw->window), "Failed to export class.");
+        }
+        g_free(path);
+    }
+    
+    free(class_info);
+}
+
+// Add a class from a snapshot file as a new class of the current teacher
+static void on_import_class_clicked(GtkButton *button, gpointer user_data) {
+    (void)button;
+    DashboardWindow *dw = (DashboardWindow *)user_data;
+    
+    char *path = choose_snapshot_file(GTK_WINDOW(dw->window), "Import Class");
+    if (!path) return;
+    
+    SnapshotReport report;
+    if (db_snapshot_import(path, g_session.user_id, &report)) {
+        char message[300];
+        snprintf(message, sizeof(message),
+                 "Class imported successfully!\n\n"
+                 "• %d student%s\n"
+                 "• %d assignment%s\n"
+                 "• %d attendance record%s",
+                 report.students, report.students == 1 ? "" : "s",
+                 report.assignments, report.assignments == 1 ? "" : "s",
+                 report.marks, report.marks == 1 ? "" : "s");
+        show_info_dialog(GTK_WINDOW(dw->window), message);
+        refresh_class_dropdown(dw);
+        update_button_states(dw);
+    } else {
+        show_error_dialog(GTK_WINDOW(dw->window), report.failure);
+    }
+    g_free(path);
+}
+
 static void check_class_selected(GtkButton *button, gpointer user_data) {
     (void)button;
     (void)user_data;
@@ -396,6 +463,15 @@ void show_dashboard_window(void) {
     g_signal_connect(delete_class_btn, "clicked", G_CALLBACK(on_delete_class_clicked), dw);
     gtk_box_pack_start(GTK_BOX(class_selector_box), delete_class_btn, FALSE, FALSE, 0);
     
+    // Move a class between installations
+    GtkWidget *export_class_btn = gtk_button_new_with_label("Export Class...");
+    g_signal_connect(export_class_btn, "clicked", G_CALLBACK(on_export_class_clicked), dw);
+    gtk_box_pack_start(GTK_BOX(class_selector_box), export_class_btn, FALSE, FALSE, 0);
+    
+    GtkWidget *import_class_btn = gtk_button_new_with_label("Import Class...");
+    g_signal_connect(import_class_btn, "clicked", G_CALLBACK(on_import_class_clicked), dw);
+    gtk_box_pack_start(GTK_BOX(class_selector_box), import_class_btn, FALSE, FALSE, 0);
+    
     gtk_box_pack_start(GTK_BOX(main_box), class_selector_box, FALSE, FALSE, 0);
     
     // Grid for module buttons
@@ -7,23 +7,83 @@
 #include <time.h>
 #include <string.h>
 #include "database.h"
-#include "common.h"
+#include "db_analytics.h"
+#include "db_bitmap.h"
+#include "db_export.h"
+#include "db_rollup.h"
+#include "ui_common.h"
+#include "ui_result_model.h"
+
+// Reports a background job can compute; the bits select which
+typedef enum {
+    REPORT_ATTENDANCE = 1 << 0,
+    REPORT_ASSIGNMENTS = 1 << 1,
+    REPORT_MONTHLY = 1 << 2,
+    REPORT_SUBJECTS = 1 << 3,
+    REPORT_TRENDS = 1 << 4,
+    REPORT_ALL = (1 << 5) - 1
+} ReportKind;
+
+#define REPORT_CHUNK_ROWS 200
+#define REPORT_KINDS 5
+#define REPORT_CACHE_SIZE 32
+
+// What the Export button writes
+typedef enum {
+    EXPORT_ATTENDANCE_REPORT,
+    EXPORT_ASSIGNMENT_REPORT,
+    EXPORT_STUDENT_REPORT,
+    EXPORT_ATTENDANCE_HISTORY,
+    EXPORT_SUBMISSION_HISTORY,
+    EXPORT_KINDS
+} ExportKind;
+
+static const char *EXPORT_LABELS[EXPORT_KINDS] = {
+    "Attendance Summary", "Assignment Statistics", "Student Report",
+    "Attendance History", "Submission History"
+};
+
+static const char *EXPORT_FILE_NAMES[EXPORT_KINDS] = {
+    "attendance_summary.csv", "assignment_statistics.csv", "student_report.csv",
+    "attendance_history.csv", "submission_history.csv"
+};
+
+struct ReportJob;
+struct ExportJob;
 
 typedef struct {
     GtkWidget *window;
     GtkWidget *notebook;
+    GtkWidget *progress;
+    struct ReportJob *job;    // running job, if any
+    GtkWidget *export_combo;
+    GtkWidget *export_button;
+    struct ExportJob *export_job;   // running export, if any
     GtkWidget *attendance_tree;
+    GtkWidget *from_entry;
+    GtkWidget *to_entry;
+    GtkWidget *streak_spin;
     GtkWidget *assignment_tree;
     GtkWidget *student_combo;
     GtkWidget *student_report_box;
+    GtkWidget *monthly_tree;
+    GtkWidget *subject_tree;
+    GtkWidget *trend_combo;
+    GtkWidget *trend_tree;
 } ReportsWindow;
 
 // Forward declarations
 static void create_attendance_report_tab(ReportsWindow *rw);
 static void create_assignment_report_tab(ReportsWindow *rw);
 static void create_student_report_tab(ReportsWindow *rw);
+static void create_monthly_report_tab(ReportsWindow *rw);
+static void create_subject_report_tab(ReportsWindow *rw);
+static void create_trends_tab(ReportsWindow *rw);
 static void refresh_attendance_report(ReportsWindow *rw);
 static void refresh_assignment_report(ReportsWindow *rw);
+static void refresh_monthly_report(ReportsWindow *rw);
+static void refresh_subject_report(ReportsWindow *rw);
+static void refresh_trends(ReportsWindow *rw);
 static void on_student_selected(GtkComboBox *combo, gpointer user_data);
 
 // CSS Styling
@@ -95,23 +155,45 @@ static void create_attendance_report_tab(ReportsWindow *rw) {
                              G_CALLBACK(refresh_attendance_report), rw);
     gtk_box_pack_start(GTK_BOX(main_box), refresh_btn, FALSE, FALSE, 0);
     
+    // Filters: date range and minimum run of consecutive absences
+    GtkWidget *filter_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 10);
+    gtk_box_pack_start(GTK_BOX(filter_box), gtk_label_new("From:"), FALSE, FALSE, 0);
+    rw->from_entry = gtk_entry_new();
+    gtk_entry_set_placeholder_text(GTK_ENTRY(rw->from_entry), "YYYY-MM-DD");
+    gtk_box_pack_start(GTK_BOX(filter_box), rw->from_entry, FALSE, FALSE, 0);
+    gtk_box_pack_start(GTK_BOX(filter_box), gtk_label_new("To:"), FALSE, FALSE, 0);
+    rw->to_entry = gtk_entry_new();
+    gtk_entry_set_placeholder_text(GTK_ENTRY(rw->to_entry), "YYYY-MM-DD");
+    gtk_box_pack_start(GTK_BOX(filter_box), rw->to_entry, FALSE, FALSE, 0);
+    gtk_box_pack_start(GTK_BOX(filter_box), gtk_label_new("Absent in a row at least:"), FALSE, FALSE, 0);
+    rw->streak_spin = gtk_spin_button_new_with_range(0, 365, 1);
+    gtk_box_pack_start(GTK_BOX(filter_box), rw->streak_spin, FALSE, FALSE, 0);
+    g_signal_connect_swapped(rw->from_entry, "activate",
+                             G_CALLBACK(refresh_attendance_report), rw);
+    g_signal_connect_swapped(rw->to_entry, "activate",
+                             G_CALLBACK(refresh_attendance_report), rw);
+    g_signal_connect_swapped(rw->streak_spin, "value-changed",
+                             G_CALLBACK(refresh_attendance_report), rw);
+    gtk_box_pack_start(GTK_BOX(main_box), filter_box, FALSE, FALSE, 0);
+    
     // Tree view with scrolled window
     GtkWidget *scroll = gtk_scrolled_window_new(NULL, NULL);
     gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(scroll),
                                    GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
     
-    // Create list store: Student Name, Roll No, Total Days, Present, Absent, Late, Attendance %
-    GtkListStore *store = gtk_list_store_new(7, 
-        G_TYPE_STRING, G_TYPE_STRING, G_TYPE_INT, 
-        G_TYPE_INT, G_TYPE_INT, G_TYPE_INT, G_TYPE_STRING);
+    // Create list store: Student Name, Roll No, Total Days, Present, Absent, Late, Attendance %,
+    // Longest Absence Run
+    const GType types[] = {G_TYPE_STRING, G_TYPE_STRING, G_TYPE_INT, G_TYPE_INT,
+                           G_TYPE_INT, G_TYPE_INT, G_TYPE_STRING, G_TYPE_INT};
+    ResultModel *store = result_model_new_values(8, types, NULL);
     
     rw->attendance_tree = gtk_tree_view_new_with_model(GTK_TREE_MODEL(store));
     g_object_unref(store);
     
     // Add columns
     const char *headers[] = {"Student Name", "Roll Number", "Total Days", 
-                            "Present", "Absent", "Late", "Attendance %"};
-    for (int i = 0; i < 7; i++) {
+                            "Present", "Absent", "Late", "Attendance %", "Longest Absence"};
+    for (int i = 0; i < 8; i++) {
         GtkCellRenderer *renderer = gtk_cell_renderer_text_new();
         GtkTreeViewColumn *column = gtk_tree_view_column_new_with_attributes(
             headers[i], renderer, "text", i, NULL);
@@ -158,9 +240,9 @@ static void create_assignment_report_tab(ReportsWindow *rw) {
                                    GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
     
     // Store: Assignment Title, Subject, Total Students, Completed, Pending, Completion %
-    GtkListStore *store = gtk_list_store_new(6, 
-        G_TYPE_STRING, G_TYPE_STRING, G_TYPE_INT, 
-        G_TYPE_INT, G_TYPE_INT, G_TYPE_STRING);
+    const GType types[] = {G_TYPE_STRING, G_TYPE_STRING, G_TYPE_INT,
+                           G_TYPE_INT, G_TYPE_INT, G_TYPE_STRING};
+    ResultModel *store = result_model_new_values(6, types, NULL);
     
     rw->assignment_tree = gtk_tree_view_new_with_model(GTK_TREE_MODEL(store));
     g_object_unref(store);
@@ -247,123 +329,829 @@ static void create_student_report_tab(ReportsWindow *rw) {
                             gtk_label_new("Student Report"));
 }
 
-// Refresh Attendance Report
-static void refresh_attendance_report(ReportsWindow *rw) {
-    GtkTreeModel *model = gtk_tree_view_get_model(GTK_TREE_VIEW(rw->attendance_tree));
-    gtk_list_store_clear(GTK_LIST_STORE(model));
-    
-    extern sqlite3 *g_db;
-    if (!g_db) return;
-    
-    // Get all students with their attendance statistics
-    const char *sql = 
-        "SELECT s.name, s.roll_number, "
-        "COUNT(DISTINCT a.date) as total_days, "
-        "SUM(CASE WHEN a.status = 1 THEN 1 ELSE 0 END) as present, "
-        "SUM(CASE WHEN a.status = 0 THEN 1 ELSE 0 END) as absent, "
-        "SUM(CASE WHEN a.status = 2 THEN 1 ELSE 0 END) as late "
-        "FROM students s "
-        "LEFT JOIN attendance a ON s.id = a.student_id "
-        "WHERE s.class_id = ? "
-        "GROUP BY s.id, s.name, s.roll_number "
-        "ORDER BY s.roll_number";
-    
-    sqlite3_stmt *stmt;
-    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) == SQLITE_OK) {
-        sqlite3_bind_int(stmt, 1, g_session.current_class_id);
-        while (sqlite3_step(stmt) == SQLITE_ROW) {
-            const char *name = (const char *)sqlite3_column_text(stmt, 0);
-            const char *roll = (const char *)sqlite3_column_text(stmt, 1);
-            int total = sqlite3_column_int(stmt, 2);
-            int present = sqlite3_column_int(stmt, 3);
-            int absent = sqlite3_column_int(stmt, 4);
-            int late = sqlite3_column_int(stmt, 5);
-            
-            char percentage[20];
-            if (total > 0) {
-                float pct = (float)(present + late) / total * 100;
-                snprintf(percentage, sizeof(percentage), "%.1f%%", pct);
-            } else {
-                strcpy(percentage, "N/A");
+// Create a report tab holding a header, a refresh button and a list view.
+// Returns the tree view.
+static GtkWidget* create_list_report_tab(ReportsWindow *rw, const char *title, const char *tab_label,
+                                         const char **headers, const GType *types, int columns,
+                                         void (*refresh)(ReportsWindow *)) {
+    GtkWidget *main_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 10);
+    gtk_widget_set_margin_start(main_box, 15);
+    gtk_widget_set_margin_end(main_box, 15);
+    gtk_widget_set_margin_top(main_box, 15);
+    gtk_widget_set_margin_bottom(main_box, 15);
+    
+    // Header
+    char markup[200];
+    snprintf(markup, sizeof(markup), "<span size='large'>%s</span>", title);
+    GtkWidget *header = gtk_label_new(NULL);
+    gtk_label_set_markup(GTK_LABEL(header), markup);
+    GtkStyleContext *header_ctx = gtk_widget_get_style_context(header);
+    gtk_style_context_add_class(header_ctx, "report-header");
+    gtk_box_pack_start(GTK_BOX(main_box), header, FALSE, FALSE, 0);
+    
+    // Refresh button
+    GtkWidget *refresh_btn = gtk_button_new_with_label("Refresh Report");
+    gtk_widget_set_size_request(refresh_btn, 150, -1);
+    GtkStyleContext *btn_ctx = gtk_widget_get_style_context(refresh_btn);
+    gtk_style_context_add_class(btn_ctx, "refresh-button");
+    g_signal_connect_swapped(refresh_btn, "clicked", G_CALLBACK(refresh), rw);
+    gtk_box_pack_start(GTK_BOX(main_box), refresh_btn, FALSE, FALSE, 0);
+    
+    // Tree view
+    GtkWidget *scroll = gtk_scrolled_window_new(NULL, NULL);
+    gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(scroll),
+                                   GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
+    
+    ResultModel *store = result_model_new_values(columns, types, NULL);
+    GtkWidget *tree = gtk_tree_view_new_with_model(GTK_TREE_MODEL(store));
+    g_object_unref(store);
+    
+    for (int i = 0; i < columns; i++) {
+        GtkCellRenderer *renderer = gtk_cell_renderer_text_new();
+        GtkTreeViewColumn *column = gtk_tree_view_column_new_with_attributes(
+            headers[i], renderer, "text", i, NULL);
+        gtk_tree_view_column_set_resizable(column, TRUE);
+        gtk_tree_view_column_set_sort_column_id(column, i);
+        gtk_tree_view_append_column(GTK_TREE_VIEW(tree), column);
+    }
+    
+    gtk_container_add(GTK_CONTAINER(scroll), tree);
+    gtk_box_pack_start(GTK_BOX(main_box), scroll, TRUE, TRUE, 0);
+    
+    gtk_notebook_append_page(GTK_NOTEBOOK(rw->notebook), main_box,
+                            gtk_label_new(tab_label));
+    return tree;
+}
+
+// Create Monthly Attendance Report Tab (all of the teacher's classes)
+static void create_monthly_report_tab(ReportsWindow *rw) {
+    const char *headers[] = {"Class", "Month", "Records", "Present", "Absent", "Late", "Attendance %"};
+    const GType types[] = {G_TYPE_STRING, G_TYPE_STRING, G_TYPE_INT, G_TYPE_INT,
+                           G_TYPE_INT, G_TYPE_INT, G_TYPE_STRING};
+    rw->monthly_tree = create_list_report_tab(rw, "Monthly Attendance by Class", "Monthly Attendance",
+                                              headers, types, 7, refresh_monthly_report);
+}
+
+// Create Subject Quality Report Tab (all of the teacher's classes)
+static void create_subject_report_tab(ReportsWindow *rw) {
+    const char *headers[] = {"Class", "Subject", "Assigned", "Submitted", "Late",
+                             "Poor", "Below Average", "Above Average", "High", "Submission %"};
+    const GType types[] = {G_TYPE_STRING, G_TYPE_STRING, G_TYPE_INT, G_TYPE_INT, G_TYPE_INT,
+                           G_TYPE_INT, G_TYPE_INT, G_TYPE_INT, G_TYPE_INT, G_TYPE_STRING};
+    rw->subject_tree = create_list_report_tab(rw, "Work Quality by Subject", "Subject Quality",
+                                              headers, types, 10, refresh_subject_report);
+}
+
+// Create Attendance Trends Tab (current class, read from the rollups)
+static void create_trends_tab(ReportsWindow *rw) {
+    GtkWidget *main_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 10);
+    gtk_widget_set_margin_start(main_box, 15);
+    gtk_widget_set_margin_end(main_box, 15);
+    gtk_widget_set_margin_top(main_box, 15);
+    gtk_widget_set_margin_bottom(main_box, 15);
+    
+    // Header
+    GtkWidget *header = gtk_label_new(NULL);
+    gtk_label_set_markup(GTK_LABEL(header), 
+        "<span size='large'>Attendance Trends</span>");
+    GtkStyleContext *header_ctx = gtk_widget_get_style_context(header);
+    gtk_style_context_add_class(header_ctx, "report-header");
+    gtk_box_pack_start(GTK_BOX(main_box), header, FALSE, FALSE, 0);
+    
+    // Period selection; the combo ids match RollupTable
+    GtkWidget *select_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 10);
+    gtk_box_pack_start(GTK_BOX(select_box), gtk_label_new("Group by:"), FALSE, FALSE, 0);
+    rw->trend_combo = gtk_combo_box_text_new();
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(rw->trend_combo), "Day");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(rw->trend_combo), "Week");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(rw->trend_combo), "Month");
+    gtk_combo_box_set_active(GTK_COMBO_BOX(rw->trend_combo), ROLLUP_CLASS_WEEK);
+    g_signal_connect_swapped(rw->trend_combo, "changed",
+                             G_CALLBACK(refresh_trends), rw);
+    gtk_box_pack_start(GTK_BOX(select_box), rw->trend_combo, FALSE, FALSE, 0);
+    gtk_box_pack_start(GTK_BOX(main_box), select_box, FALSE, FALSE, 0);
+    
+    // Tree view
+    GtkWidget *scroll = gtk_scrolled_window_new(NULL, NULL);
+    gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(scroll),
+                                   GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
+    
+    // Store: Period, Records, Present, Absent, Late, Attendance % (drawn as a bar)
+    const GType types[] = {G_TYPE_STRING, G_TYPE_INT, G_TYPE_INT,
+                           G_TYPE_INT, G_TYPE_INT, G_TYPE_INT};
+    ResultModel *store = result_model_new_values(6, types, NULL);
+    
+    rw->trend_tree = gtk_tree_view_new_with_model(GTK_TREE_MODEL(store));
+    g_object_unref(store);
+    
+    const char *headers[] = {"Period", "Records", "Present", "Absent", "Late"};
+    for (int i = 0; i < 5; i++) {
+        GtkCellRenderer *renderer = gtk_cell_renderer_text_new();
+        GtkTreeViewColumn *column = gtk_tree_view_column_new_with_attributes(
+            headers[i], renderer, "text", i, NULL);
+        gtk_tree_view_column_set_resizable(column, TRUE);
+        gtk_tree_view_append_column(GTK_TREE_VIEW(rw->trend_tree), column);
+    }
+    GtkCellRenderer *bar = gtk_cell_renderer_progress_new();
+    GtkTreeViewColumn *bar_column = gtk_tree_view_column_new_with_attributes(
+        "Attendance %", bar, "value", 5, NULL);
+    gtk_tree_view_column_set_expand(bar_column, TRUE);
+    gtk_tree_view_append_column(GTK_TREE_VIEW(rw->trend_tree), bar_column);
+    
+    gtk_container_add(GTK_CONTAINER(scroll), rw->trend_tree);
+    gtk_box_pack_start(GTK_BOX(main_box), scroll, TRUE, TRUE, 0);
+    
+    gtk_notebook_append_page(GTK_NOTEBOOK(rw->notebook), main_box,
+                            gtk_label_new("Trends"));
+}
+
+// Background report computation. A job runs on a worker thread with its own
+// database connection and hands finished rows to the main loop in chunks;
+// only the main thread touches widgets. Closing the window cancels the job,
+// and the job itself is freed by its last idle callback. Rows are kept as
+// GValue arrays that the views read through a ResultModel and the cache
+// shares, so nothing is copied once a row has arrived.
+
+typedef struct ReportJob {
+    ReportsWindow *rw;        // NULL once the window is gone
+    GCancellable *cancel;
+    char *db_path;
+    int reports;              // ReportKind bits to compute
+    int done;                 // bits whose rows are all in the stores
+    int class_id;
+    int teacher_id;
+    char from[20];
+    char to[20];
+    int min_streak;
+    int trend_table;
+    unsigned long version;    // db_data_version() when the job started
+    int stale;                // bits whose stores show stale cached rows
+    GArray *results[REPORT_KINDS];  // rows received so far, per kind
+} ReportJob;
+
+typedef struct {
+    ReportJob *job;
+    ReportKind kind;
+    int columns;
+    int rows;
+    GValue *values;           // rows * columns
+    bool last;                // final chunk of its report
+} ReportChunk;
+
+// Worker-side builder for the chunks of one report
+typedef struct {
+    ReportJob *job;
+    ReportKind kind;
+    int columns;
+    ReportChunk *chunk;
+} ChunkWriter;
+
+// Finished reports, kept across window opens. An entry is keyed by the class
+// (the teacher for the cross-class reports), the report and its filters, and
+// is current while its version matches db_data_version(). Opening a report
+// shows its entry straight away; a stale one stays on screen while the job
+// recomputes it.
+typedef struct {
+    ReportKind kind;          // 0 for an unused slot
+    int scope_id;
+    char params[64];
+    unsigned long version;
+    GArray *values;           // GValues, row by row; shared with the views
+    guint64 used;             // last use, for eviction
+} CachedReport;
+
+static CachedReport g_report_cache[REPORT_CACHE_SIZE];
+static guint64 g_report_cache_clock = 0;
+
+static int report_slot(ReportKind kind) {
+    return __builtin_ctz(kind);
+}
+
+static void report_cache_key(const ReportJob *job, ReportKind kind, int *scope_id,
+                             char *params, size_t size) {
+    *scope_id = job->class_id;
+    params[0] = '\0';
+    switch (kind) {
+        case REPORT_ATTENDANCE:
+            snprintf(params, size, "%s|%s|%d", job->from, job->to, job->min_streak);
+            break;
+        case REPORT_MONTHLY:
+        case REPORT_SUBJECTS:
+            *scope_id = job->teacher_id;
+            break;
+        case REPORT_TRENDS:
+            snprintf(params, size, "%d", job->trend_table);
+            break;
+        default:
+            break;
+    }
+}
+
+static CachedReport* report_cache_find(const ReportJob *job, ReportKind kind) {
+    int scope_id;
+    char params[64];
+    report_cache_key(job, kind, &scope_id, params, sizeof(params));
+    
+    for (int i = 0; i < REPORT_CACHE_SIZE; i++) {
+        CachedReport *entry = &g_report_cache[i];
+        if (entry->kind == kind && entry->scope_id == scope_id &&
+            strcmp(entry->params, params) == 0) {
+            entry->used = ++g_report_cache_clock;
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+// Replace the entry for a finished report
+static void report_cache_store(const ReportJob *job, ReportKind kind, GArray *values) {
+    CachedReport *entry = report_cache_find(job, kind);
+    if (!entry) {
+        entry = &g_report_cache[0];
+        for (int i = 1; i < REPORT_CACHE_SIZE && entry->kind; i++) {
+            if (!g_report_cache[i].kind || g_report_cache[i].used < entry->used) {
+                entry = &g_report_cache[i];
+            }
+        }
+    }
+    
+    if (entry->values) g_array_unref(entry->values);
+    entry->kind = kind;
+    report_cache_key(job, kind, &entry->scope_id, entry->params, sizeof(entry->params));
+    entry->version = job->version;
+    entry->values = g_array_ref(values);
+    entry->used = ++g_report_cache_clock;
+}
+
+static GtkWidget* report_tree(ReportsWindow *rw, ReportKind kind) {
+    switch (kind) {
+        case REPORT_ATTENDANCE: return rw->attendance_tree;
+        case REPORT_ASSIGNMENTS: return rw->assignment_tree;
+        case REPORT_MONTHLY: return rw->monthly_tree;
+        case REPORT_SUBJECTS: return rw->subject_tree;
+        case REPORT_TRENDS: return rw->trend_tree;
+        default: return NULL;
+    }
+}
+
+// Show rows in a report's view, with the column types it was created with
+static void show_report_rows(GtkWidget *tree, GArray *values) {
+    GtkTreeModel *current = gtk_tree_view_get_model(GTK_TREE_VIEW(tree));
+    int columns = gtk_tree_model_get_n_columns(current);
+    GType types[16];
+    for (int i = 0; i < columns; i++) {
+        types[i] = gtk_tree_model_get_column_type(current, i);
+    }
+    
+    ResultModel *model = result_model_new_values(columns, types, values);
+    result_model_attach(GTK_TREE_VIEW(tree), model);
+    g_object_unref(model);
+}
+
+static void free_report_chunk(ReportChunk *chunk) {
+    for (int i = 0; i < chunk->rows * chunk->columns; i++) {
+        g_value_unset(&chunk->values[i]);
+    }
+    g_free(chunk->values);
+    g_free(chunk);
+}
+
+// Main thread: append one chunk of rows
+static gboolean apply_report_chunk(gpointer data) {
+    ReportChunk *chunk = data;
+    ReportJob *job = chunk->job;
+    
+    if (job->rw && !g_cancellable_is_cancelled(job->cancel)) {
+        GtkWidget *tree = report_tree(job->rw, chunk->kind);
+        GArray *results = job->results[report_slot(chunk->kind)];
+        g_array_append_vals(results, chunk->values, chunk->rows * chunk->columns);
+        chunk->rows = 0;    // the values now belong to the results
+        
+        // Cached rows stay on screen until their replacement is complete
+        if (!(job->stale & chunk->kind)) {
+            ResultModel *model = RESULT_MODEL(gtk_tree_view_get_model(GTK_TREE_VIEW(tree)));
+            result_model_rows_added(model, results->len / chunk->columns);
+        }
+        
+        if (chunk->last) {
+            report_cache_store(job, chunk->kind, results);
+            if (job->stale & chunk->kind) {
+                show_report_rows(tree, results);
             }
             
-            GtkTreeIter iter;
-            gtk_list_store_append(GTK_LIST_STORE(model), &iter);
-            gtk_list_store_set(GTK_LIST_STORE(model), &iter,
-                             0, name,
-                             1, roll,
-                             2, total,
-                             3, present,
-                             4, absent,
-                             5, late,
-                             6, percentage,
-                             -1);
+            job->done |= chunk->kind;
+            int total = __builtin_popcount(job->reports);
+            int finished = __builtin_popcount(job->done);
+            char text[64];
+            snprintf(text, sizeof(text), "Loading reports... %d of %d", finished, total);
+            gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(job->rw->progress),
+                                          total > 0 ? (double)finished / total : 1.0);
+            gtk_progress_bar_set_text(GTK_PROGRESS_BAR(job->rw->progress), text);
+        } else {
+            gtk_progress_bar_pulse(GTK_PROGRESS_BAR(job->rw->progress));
         }
-        sqlite3_finalize(stmt);
     }
+    
+    free_report_chunk(chunk);
+    return G_SOURCE_REMOVE;
 }
 
-// Refresh Assignment Report
-static void refresh_assignment_report(ReportsWindow *rw) {
-    GtkTreeModel *model = gtk_tree_view_get_model(GTK_TREE_VIEW(rw->assignment_tree));
-    gtk_list_store_clear(GTK_LIST_STORE(model));
+// Main thread: queued after every chunk, so it runs last
+static gboolean finish_report_job(gpointer data) {
+    ReportJob *job = data;
     
-    extern sqlite3 *g_db;
-    if (!g_db) return;
+    if (job->rw && job->rw->job == job) {
+        gtk_widget_hide(job->rw->progress);
+        job->rw->job = NULL;
+    }
     
-    // Get total students count
-    const char *count_sql = "SELECT COUNT(*) FROM students WHERE class_id = ?";
-    sqlite3_stmt *count_stmt;
-    int total_students = 0;
-    
-    if (sqlite3_prepare_v2(g_db, count_sql, -1, &count_stmt, NULL) == SQLITE_OK) {
-        sqlite3_bind_int(count_stmt, 1, g_session.current_class_id);
-        if (sqlite3_step(count_stmt) == SQLITE_ROW) {
-            total_students = sqlite3_column_int(count_stmt, 0);
+    for (int i = 0; i < REPORT_KINDS; i++) {
+        if (job->results[i]) g_array_unref(job->results[i]);
+    }
+    g_object_unref(job->cancel);
+    g_free(job->db_path);
+    g_free(job);
+    return G_SOURCE_REMOVE;
+}
+
+static void chunk_flush(ChunkWriter *w, bool last) {
+    if (!w->chunk && !last) return;
+    if (!w->chunk) {
+        w->chunk = g_new0(ReportChunk, 1);
+        w->chunk->job = w->job;
+        w->chunk->kind = w->kind;
+        w->chunk->columns = w->columns;
+    }
+    w->chunk->last = last;
+    g_idle_add(apply_report_chunk, w->chunk);
+    w->chunk = NULL;
+}
+
+// Next row's cells, initialised by the caller with g_value_init/set
+static GValue* chunk_row(ChunkWriter *w) {
+    if (!w->chunk) {
+        w->chunk = g_new0(ReportChunk, 1);
+        w->chunk->job = w->job;
+        w->chunk->kind = w->kind;
+        w->chunk->columns = w->columns;
+        w->chunk->values = g_new0(GValue, REPORT_CHUNK_ROWS * w->columns);
+    }
+    return &w->chunk->values[w->chunk->rows++ * w->columns];
+}
+
+static void chunk_row_done(ChunkWriter *w) {
+    if (w->chunk->rows == REPORT_CHUNK_ROWS) {
+        chunk_flush(w, false);
+    }
+}
+
+static void set_string(GValue *value, const char *text) {
+    g_value_init(value, G_TYPE_STRING);
+    g_value_set_string(value, text);
+}
+
+static void set_int(GValue *value, int number) {
+    g_value_init(value, G_TYPE_INT);
+    g_value_set_int(value, number);
+}
+
+static bool job_cancelled(ReportJob *job) {
+    return g_cancellable_is_cancelled(job->cancel);
+}
+
+// Attendance Summary rows
+static void compute_attendance_report(ReportJob *job) {
+    ChunkWriter w = {job, REPORT_ATTENDANCE, 8, NULL};
+    
+    // Get all students with their attendance statistics in the range
+    int count;
+    AttendanceSummary **rows = db_get_attendance_summary_range(job->class_id,
+                                                               job->from, job->to, &count);
+    for (int i = 0; rows && i < count && !job_cancelled(job); i++) {
+        AttendanceSummary *r = rows[i];
+        if (r->longest_absent_streak < job->min_streak) continue;
+        
+        char percentage[20];
+        if (r->total_days > 0) {
+            float pct = (float)(r->present + r->late) / r->total_days * 100;
+            snprintf(percentage, sizeof(percentage), "%.1f%%", pct);
+        } else {
+            strcpy(percentage, "N/A");
         }
-        sqlite3_finalize(count_stmt);
+        
+        GValue *v = chunk_row(&w);
+        set_string(&v[0], r->name);
+        set_string(&v[1], r->roll_number);
+        set_int(&v[2], r->total_days);
+        set_int(&v[3], r->present);
+        set_int(&v[4], r->absent);
+        set_int(&v[5], r->late);
+        set_string(&v[6], percentage);
+        set_int(&v[7], r->longest_absent_streak);
+        chunk_row_done(&w);
     }
+    db_free_attendance_summary(rows, count);
+    chunk_flush(&w, true);
+}
+
+// Assignment Statistics rows
+static void compute_assignment_report(ReportJob *job) {
+    ChunkWriter w = {job, REPORT_ASSIGNMENTS, 6, NULL};
+    
+    // Get total students count
+    int total_students = db_count_students_by_class(job->class_id);
     
     // Get assignment statistics
-    const char *sql = 
-        "SELECT a.title, a.subject, "
-        "COUNT(CASE WHEN s.status IN (1, 2) THEN 1 END) as completed "
-        "FROM assignments a "
-        "LEFT JOIN assignment_submissions s ON a.id = s.assignment_id "
-        "WHERE a.class_id = ? "
-        "GROUP BY a.id, a.title, a.subject "
-        "ORDER BY a.title";
-    
-    sqlite3_stmt *stmt;
-    if (sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL) == SQLITE_OK) {
-        sqlite3_bind_int(stmt, 1, g_session.current_class_id);
-        while (sqlite3_step(stmt) == SQLITE_ROW) {
-            const char *title = (const char *)sqlite3_column_text(stmt, 0);
-            const char *subject = (const char *)sqlite3_column_text(stmt, 1);
-            int completed = sqlite3_column_int(stmt, 2);
-            int pending = total_students - completed;
+    int count;
+    AssignmentSummary **rows = db_get_assignment_summary(job->class_id, &count);
+    for (int i = 0; rows && i < count && !job_cancelled(job); i++) {
+        int completed = rows[i]->completed;
+        int pending = total_students - completed;
+        
+        char percentage[20];
+        if (total_students > 0) {
+            float pct = (float)completed / total_students * 100;
+            snprintf(percentage, sizeof(percentage), "%.1f%%", pct);
+        } else {
+            strcpy(percentage, "N/A");
+        }
+        
+        GValue *v = chunk_row(&w);
+        set_string(&v[0], rows[i]->title);
+        set_string(&v[1], rows[i]->subject);
+        set_int(&v[2], total_students);
+        set_int(&v[3], completed);
+        set_int(&v[4], pending);
+        set_string(&v[5], percentage);
+        chunk_row_done(&w);
+    }
+    db_free_assignment_summary(rows, count);
+    chunk_flush(&w, true);
+}
+
+static const char* analytics_class_name(const AnalyticsStore *store, int class_id) {
+    for (int i = 0; i < store->class_count; i++) {
+        if (store->class_ids[i] == class_id) return store->class_names[i];
+    }
+    return "";
+}
+
+// Monthly Attendance and Subject Quality rows, from one columnar load
+static void compute_analytics_reports(ReportJob *job) {
+    ChunkWriter monthly = {job, REPORT_MONTHLY, 7, NULL};
+    ChunkWriter subjects = {job, REPORT_SUBJECTS, 10, NULL};
+    
+    AnalyticsStore store;
+    bool loaded = analytics_load(&store, job->teacher_id);
+    int count;
+    
+    if (loaded && (job->reports & REPORT_MONTHLY)) {
+        AnalyticsMonthRow *rows = analytics_monthly_attendance(&store, NULL, NULL, &count);
+        for (int i = 0; rows && i < count && !job_cancelled(job); i++) {
+            AnalyticsMonthRow *r = &rows[i];
+            int total = r->present + r->absent + r->late;
             
+            char month[16];
+            snprintf(month, sizeof(month), "%04d-%02d", r->year, r->month);
             char percentage[20];
-            if (total_students > 0) {
-                float pct = (float)completed / total_students * 100;
-                snprintf(percentage, sizeof(percentage), "%.1f%%", pct);
-            } else {
-                strcpy(percentage, "N/A");
-            }
+            snprintf(percentage, sizeof(percentage), "%.1f%%",
+                     (float)(r->present + r->late) / total * 100);
+            
+            GValue *v = chunk_row(&monthly);
+            set_string(&v[0], analytics_class_name(&store, r->class_id));
+            set_string(&v[1], month);
+            set_int(&v[2], total);
+            set_int(&v[3], r->present);
+            set_int(&v[4], r->absent);
+            set_int(&v[5], r->late);
+            set_string(&v[6], percentage);
+            chunk_row_done(&monthly);
+        }
+        free(rows);
+    }
+    
+    if (loaded && (job->reports & REPORT_SUBJECTS)) {
+        AnalyticsSubjectRow *rows = analytics_subject_quality(&store, NULL, NULL, &count);
+        for (int i = 0; rows && i < count && !job_cancelled(job); i++) {
+            AnalyticsSubjectRow *r = &rows[i];
+            
+            char percentage[20];
+            snprintf(percentage, sizeof(percentage), "%.1f%%",
+                     (float)r->submitted / r->assigned * 100);
             
-            GtkTreeIter iter;
-            gtk_list_store_append(GTK_LIST_STORE(model), &iter);
-            gtk_list_store_set(GTK_LIST_STORE(model), &iter,
-                             0, title,
-                             1, subject,
-                             2, total_students,
-                             3, completed,
-                             4, pending,
-                             5, percentage,
-                             -1);
+            GValue *v = chunk_row(&subjects);
+            set_string(&v[0], analytics_class_name(&store, r->class_id));
+            set_string(&v[1], r->subject);
+            set_int(&v[2], r->assigned);
+            set_int(&v[3], r->submitted);
+            set_int(&v[4], r->late);
+            set_int(&v[5], r->quality[QUALITY_POOR]);
+            set_int(&v[6], r->quality[QUALITY_BELOW_AVERAGE]);
+            set_int(&v[7], r->quality[QUALITY_ABOVE_AVERAGE]);
+            set_int(&v[8], r->quality[QUALITY_HIGH]);
+            set_string(&v[9], percentage);
+            chunk_row_done(&subjects);
+        }
+        free(rows);
+    }
+    
+    if (loaded) analytics_free(&store);
+    if (job->reports & REPORT_MONTHLY) chunk_flush(&monthly, true);
+    if (job->reports & REPORT_SUBJECTS) chunk_flush(&subjects, true);
+}
+
+// Attendance Trends rows, from the rollups
+static void compute_trends(ReportJob *job) {
+    ChunkWriter w = {job, REPORT_TRENDS, 6, NULL};
+    
+    int count;
+    AttendanceRollup **rows = db_get_class_rollup(job->class_id, (RollupTable)job->trend_table, &count);
+    for (int i = 0; rows && i < count && !job_cancelled(job); i++) {
+        AttendanceRollup *r = rows[i];
+        int total = r->present + r->absent + r->late;
+        
+        GValue *v = chunk_row(&w);
+        set_string(&v[0], r->period);
+        set_int(&v[1], total);
+        set_int(&v[2], r->present);
+        set_int(&v[3], r->absent);
+        set_int(&v[4], r->late);
+        set_int(&v[5], (r->present + r->late) * 100 / total);
+        chunk_row_done(&w);
+    }
+    db_free_rollups(rows, count);
+    chunk_flush(&w, true);
+}
+
+// SQLite progress handler: abandon the running query once cancelled
+static int report_query_cancelled(void *cancel) {
+    return g_cancellable_is_cancelled(cancel) ? 1 : 0;
+}
+
+static gpointer report_worker(gpointer data) {
+    ReportJob *job = data;
+    
+    if (db_init_thread(job->db_path)) {
+        sqlite3_progress_handler(g_db, 1000, report_query_cancelled, job->cancel);
+        
+        if ((job->reports & REPORT_ATTENDANCE) && !job_cancelled(job)) {
+            compute_attendance_report(job);
+        }
+        if ((job->reports & REPORT_ASSIGNMENTS) && !job_cancelled(job)) {
+            compute_assignment_report(job);
+        }
+        if ((job->reports & REPORT_TRENDS) && !job_cancelled(job)) {
+            compute_trends(job);
+        }
+        if ((job->reports & (REPORT_MONTHLY | REPORT_SUBJECTS)) && !job_cancelled(job)) {
+            compute_analytics_reports(job);
+        }
+        
+        db_cleanup();
+    }
+    
+    g_idle_add(finish_report_job, job);
+    return NULL;
+}
+
+static void cancel_reports(ReportsWindow *rw) {
+    if (rw->job) {
+        g_cancellable_cancel(rw->job->cancel);
+        rw->job->rw = NULL;
+        rw->job = NULL;
+    }
+}
+
+// Start computing the given reports, restarting any that a running job had
+// not finished yet
+static void start_reports(ReportsWindow *rw, int reports) {
+    if (rw->job) {
+        reports |= rw->job->reports & ~rw->job->done;
+        cancel_reports(rw);
+    }
+    
+    ReportJob *job = g_new0(ReportJob, 1);
+    job->rw = rw;
+    job->cancel = g_cancellable_new();
+    job->db_path = g_strdup(sqlite3_db_filename(g_db, "main"));
+    job->class_id = g_session.current_class_id;
+    job->teacher_id = g_session.user_id;
+    
+    if (reports & REPORT_ATTENDANCE) {
+        const char *from = gtk_entry_get_text(GTK_ENTRY(rw->from_entry));
+        const char *to = gtk_entry_get_text(GTK_ENTRY(rw->to_entry));
+        if ((from[0] && bitmap_day_from_date(from, NULL) < 0) ||
+            (to[0] && bitmap_day_from_date(to, NULL) < 0)) {
+            show_error_dialog(GTK_WINDOW(rw->window), "Dates must be in YYYY-MM-DD format");
+            reports &= ~REPORT_ATTENDANCE;
         }
-        sqlite3_finalize(stmt);
+        g_strlcpy(job->from, from, sizeof(job->from));
+        g_strlcpy(job->to, to, sizeof(job->to));
+        job->min_streak = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(rw->streak_spin));
     }
+    job->trend_table = gtk_combo_box_get_active(GTK_COMBO_BOX(rw->trend_combo));
+    if (job->trend_table < ROLLUP_CLASS_DAY || job->trend_table > ROLLUP_CLASS_MONTH) {
+        reports &= ~REPORT_TRENDS;
+    }
+    
+    // Show what the cache has; only reports without a current entry are
+    // computed
+    job->version = db_data_version();
+    for (int kind = 1; kind <= REPORT_ALL; kind <<= 1) {
+        if (!(reports & kind)) continue;
+        
+        GtkWidget *tree = report_tree(rw, (ReportKind)kind);
+        CachedReport *cached = report_cache_find(job, (ReportKind)kind);
+        if (cached) {
+            show_report_rows(tree, cached->values);
+            if (cached->version == job->version) {
+                reports &= ~kind;
+                continue;
+            }
+            job->stale |= kind;
+        }
+        
+        GArray *results = g_array_new(FALSE, TRUE, sizeof(GValue));
+        g_array_set_clear_func(results, (GDestroyNotify)g_value_unset);
+        job->results[report_slot((ReportKind)kind)] = results;
+        if (!cached) show_report_rows(tree, results);
+    }
+    job->reports = reports;
+    
+    if (reports == 0) {
+        finish_report_job(job);
+        return;
+    }
+    
+    gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(rw->progress), 0.0);
+    gtk_progress_bar_set_text(GTK_PROGRESS_BAR(rw->progress), "Loading reports...");
+    gtk_widget_show(rw->progress);
+    
+    rw->job = job;
+    g_thread_unref(g_thread_new("reports", report_worker, job));
+}
+
+// Refresh Attendance Report
+static void refresh_attendance_report(ReportsWindow *rw) {
+    start_reports(rw, REPORT_ATTENDANCE);
+}
+
+// Refresh Assignment Report
+static void refresh_assignment_report(ReportsWindow *rw) {
+    start_reports(rw, REPORT_ASSIGNMENTS);
+}
+
+// Refresh Monthly Attendance Report
+static void refresh_monthly_report(ReportsWindow *rw) {
+    start_reports(rw, REPORT_MONTHLY);
+}
+
+// Refresh Subject Quality Report
+static void refresh_subject_report(ReportsWindow *rw) {
+    start_reports(rw, REPORT_SUBJECTS);
+}
+
+// Refresh Attendance Trends
+static void refresh_trends(ReportsWindow *rw) {
+    start_reports(rw, REPORT_TRENDS);
+}
+
+// An export writing a file on its own thread and connection; rw is cleared
+// if the window closes first
+typedef struct ExportJob {
+    ReportsWindow *rw;
+    char *db_path;
+    char *path;
+    ExportKind kind;
+    int class_id;
+    int student_id;
+    char from[20];
+    char to[20];
+    int min_streak;
+    long rows;
+} ExportJob;
+
+// Main thread: report how the export went
+static gboolean finish_export_job(gpointer data) {
+    ExportJob *job = data;
+    
+    if (job->rw) {
+        ReportsWindow *rw = job->rw;
+        rw->export_job = NULL;
+        gtk_widget_set_sensitive(rw->export_button, TRUE);
+        if (!rw->job) gtk_widget_hide(rw->progress);
+        
+        char message[600];
+        if (job->rows < 0) {
+            snprintf(message, sizeof(message), "Could not export to %s", job->path);
+            show_error_dialog(GTK_WINDOW(rw->window), message);
+        } else {
+            snprintf(message, sizeof(message), "Exported %ld rows to %s", job->rows, job->path);
+            show_info_dialog(GTK_WINDOW(rw->window), message);
+        }
+    }
+    
+    g_free(job->db_path);
+    g_free(job->path);
+    g_free(job);
+    return G_SOURCE_REMOVE;
+}
+
+static gpointer export_worker(gpointer data) {
+    ExportJob *job = data;
+    ExportFormat format = db_export_format_for_path(job->path);
+    
+    job->rows = -1;
+    if (db_init_thread(job->db_path)) {
+        switch (job->kind) {
+            case EXPORT_ATTENDANCE_REPORT:
+                job->rows = db_export_attendance_report(job->path, format, job->class_id,
+                                                        job->from, job->to, job->min_streak);
+                break;
+            case EXPORT_ASSIGNMENT_REPORT:
+                job->rows = db_export_assignment_report(job->path, format, job->class_id);
+                break;
+            case EXPORT_STUDENT_REPORT:
+                job->rows = db_export_student_report(job->path, format, job->student_id);
+                break;
+            case EXPORT_ATTENDANCE_HISTORY:
+                job->rows = db_export_attendance_history(job->path, format, job->class_id);
+                break;
+            case EXPORT_SUBMISSION_HISTORY:
+                job->rows = db_export_submission_history(job->path, format, job->class_id);
+                break;
+            default:
+                break;
+        }
+        db_cleanup();
+    }
+    
+    g_idle_add(finish_export_job, job);
+    return NULL;
+}
+
+// Export the chosen report or history to a file picked by the user; a
+// ".json" name writes JSON, anything else CSV
+static void on_export_clicked(ReportsWindow *rw) {
+    if (rw->export_job) return;
+    
+    int kind = gtk_combo_box_get_active(GTK_COMBO_BOX(rw->export_combo));
+    if (kind < 0 || kind >= EXPORT_KINDS) return;
+    
+    ExportJob *job = g_new0(ExportJob, 1);
+    job->kind = (ExportKind)kind;
+    job->class_id = g_session.current_class_id;
+    
+    if (job->kind == EXPORT_STUDENT_REPORT) {
+        int index = gtk_combo_box_get_active(GTK_COMBO_BOX(rw->student_combo));
+        char key[50];
+        snprintf(key, sizeof(key), "student_id_%d", index);
+        job->student_id = index < 0 ? 0 :
+            GPOINTER_TO_INT(g_object_get_data(G_OBJECT(rw->student_combo), key));
+        if (job->student_id <= 0) {
+            show_error_dialog(GTK_WINDOW(rw->window),
+                              "Select a student on the Student Report tab first");
+            g_free(job);
+            return;
+        }
+    }
+    if (job->kind == EXPORT_ATTENDANCE_REPORT) {
+        const char *from = gtk_entry_get_text(GTK_ENTRY(rw->from_entry));
+        const char *to = gtk_entry_get_text(GTK_ENTRY(rw->to_entry));
+        if ((from[0] && bitmap_day_from_date(from, NULL) < 0) ||
+            (to[0] && bitmap_day_from_date(to, NULL) < 0)) {
+            show_error_dialog(GTK_WINDOW(rw->window), "Dates must be in YYYY-MM-DD format");
+            g_free(job);
+            return;
+        }
+        g_strlcpy(job->from, from, sizeof(job->from));
+        g_strlcpy(job->to, to, sizeof(job->to));
+        job->min_streak = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(rw->streak_spin));
+    }
+    
+    job->path = choose_save_file(GTK_WINDOW(rw->window), "Export Report",
+                                 EXPORT_FILE_NAMES[kind]);
+    if (!job->path) {
+        g_free(job);
+        return;
+    }
+    
+    job->rw = rw;
+    job->db_path = g_strdup(sqlite3_db_filename(g_db, "main"));
+    rw->export_job = job;
+    gtk_widget_set_sensitive(rw->export_button, FALSE);
+    if (!rw->job) {
+        gtk_progress_bar_set_text(GTK_PROGRESS_BAR(rw->progress), "Exporting...");
+        gtk_progress_bar_pulse(GTK_PROGRESS_BAR(rw->progress));
+        gtk_widget_show(rw->progress);
+    }
+    g_thread_unref(g_thread_new("export", export_worker, job));
+}
+
+static void on_reports_destroy(ReportsWindow *rw) {
+    cancel_reports(rw);
+    if (rw->export_job) rw->export_job->rw = NULL;
+    g_free(rw);
 }
 
 // Student Selected Callback
@@ -386,8 +1174,6 @@ static void on_student_selected(GtkComboBox *combo, gpointer user_data) {
     
     if (student_id <= 0) return;
     
-    extern sqlite3 *g_db;
-    
     // Get student info
     Student *student = db_get_student_by_id(student_id);
     if (!student) return;
@@ -416,81 +1202,74 @@ static void on_student_selected(GtkComboBox *combo, gpointer user_data) {
     free(student);
     
     // Attendance statistics
-    const char *att_sql = 
-        "SELECT "
-        "COUNT(DISTINCT date) as total, "
-        "SUM(CASE WHEN status = 1 THEN 1 ELSE 0 END) as present, "
-        "SUM(CASE WHEN status = 0 THEN 1 ELSE 0 END) as absent, "
-        "SUM(CASE WHEN status = 2 THEN 1 ELSE 0 END) as late "
-        "FROM attendance WHERE student_id = ?";
-    
-    sqlite3_stmt *stmt;
-    if (sqlite3_prepare_v2(g_db, att_sql, -1, &stmt, NULL) == SQLITE_OK) {
-        sqlite3_bind_int(stmt, 1, student_id);
+    int total, present, absent, late;
+    if (db_get_student_attendance_stats(student_id, &total, &present, &absent, &late)) {
+        GtkWidget *att_card = gtk_box_new(GTK_ORIENTATION_VERTICAL, 5);
+        GtkStyleContext *att_ctx = gtk_widget_get_style_context(att_card);
+        gtk_style_context_add_class(att_ctx, "report-card");
         
-        if (sqlite3_step(stmt) == SQLITE_ROW) {
-            int total = sqlite3_column_int(stmt, 0);
-            int present = sqlite3_column_int(stmt, 1);
-            int absent = sqlite3_column_int(stmt, 2);
-            int late = sqlite3_column_int(stmt, 3);
-            
-            GtkWidget *att_card = gtk_box_new(GTK_ORIENTATION_VERTICAL, 5);
-            GtkStyleContext *att_ctx = gtk_widget_get_style_context(att_card);
-            gtk_style_context_add_class(att_ctx, "report-card");
-            
-            char att_text[300];
-            float pct = total > 0 ? (float)(present + late) / total * 100 : 0;
-            snprintf(att_text, sizeof(att_text),
-                     "<b>Attendance Summary</b>\n"
-                     "Total Days: %d | Present: %d | Absent: %d | Late: %d\n"
-                     "Attendance Percentage: %.1f%%",
-                     total, present, absent, late, pct);
-            
-            GtkWidget *att_label = gtk_label_new(NULL);
-            gtk_label_set_markup(GTK_LABEL(att_label), att_text);
-            gtk_widget_set_halign(att_label, GTK_ALIGN_START);
-            gtk_box_pack_start(GTK_BOX(att_card), att_label, FALSE, FALSE, 5);
-            gtk_box_pack_start(GTK_BOX(rw->student_report_box), att_card, FALSE, FALSE, 5);
+        char att_text[300];
+        float pct = total > 0 ? (float)(present + late) / total * 100 : 0;
+        snprintf(att_text, sizeof(att_text),
+                 "<b>Attendance Summary</b>\n"
+                 "Total Days: %d | Present: %d | Absent: %d | Late: %d\n"
+                 "Attendance Percentage: %.1f%%",
+                 total, present, absent, late, pct);
+        
+        GtkWidget *att_label = gtk_label_new(NULL);
+        gtk_label_set_markup(GTK_LABEL(att_label), att_text);
+        gtk_widget_set_halign(att_label, GTK_ALIGN_START);
+        gtk_box_pack_start(GTK_BOX(att_card), att_label, FALSE, FALSE, 5);
+        gtk_box_pack_start(GTK_BOX(rw->student_report_box), att_card, FALSE, FALSE, 5);
+    }
+    
+    // Attendance by month, from the rollups
+    int month_count;
+    AttendanceRollup **months = db_get_student_rollup(student_id, &month_count);
+    if (months && month_count > 0) {
+        GtkWidget *month_card = gtk_box_new(GTK_ORIENTATION_VERTICAL, 5);
+        GtkStyleContext *month_ctx = gtk_widget_get_style_context(month_card);
+        gtk_style_context_add_class(month_ctx, "report-card");
+        
+        GString *month_text = g_string_new("<b>Attendance by Month</b>");
+        for (int i = 0; i < month_count; i++) {
+            AttendanceRollup *m = months[i];
+            int days = m->present + m->absent + m->late;
+            g_string_append_printf(month_text, "\n%s: %d days | Present: %d | Absent: %d | Late: %d (%.1f%%)",
+                                   m->period, days, m->present, m->absent, m->late,
+                                   (float)(m->present + m->late) / days * 100);
         }
-        sqlite3_finalize(stmt);
+        
+        GtkWidget *month_label = gtk_label_new(NULL);
+        gtk_label_set_markup(GTK_LABEL(month_label), month_text->str);
+        gtk_widget_set_halign(month_label, GTK_ALIGN_START);
+        gtk_box_pack_start(GTK_BOX(month_card), month_label, FALSE, FALSE, 5);
+        gtk_box_pack_start(GTK_BOX(rw->student_report_box), month_card, FALSE, FALSE, 5);
+        g_string_free(month_text, TRUE);
     }
+    db_free_rollups(months, month_count);
     
     // Assignment statistics
-    const char *assign_sql = 
-        "SELECT "
-        "COUNT(*) as total, "
-        "SUM(CASE WHEN s.status IN (1, 2) THEN 1 ELSE 0 END) as completed "
-        "FROM assignments a "
-        "LEFT JOIN assignment_submissions s ON a.id = s.assignment_id AND s.student_id = ? "
-        "WHERE a.class_id = ?";
-    
-    if (sqlite3_prepare_v2(g_db, assign_sql, -1, &stmt, NULL) == SQLITE_OK) {
-        sqlite3_bind_int(stmt, 1, student_id);
-        sqlite3_bind_int(stmt, 2, g_session.current_class_id);
+    int assign_total, completed;
+    if (db_get_student_assignment_stats(student_id, g_session.current_class_id,
+                                        &assign_total, &completed)) {
+        GtkWidget *assign_card = gtk_box_new(GTK_ORIENTATION_VERTICAL, 5);
+        GtkStyleContext *assign_ctx = gtk_widget_get_style_context(assign_card);
+        gtk_style_context_add_class(assign_ctx, "report-card");
         
-        if (sqlite3_step(stmt) == SQLITE_ROW) {
-            int total = sqlite3_column_int(stmt, 0);
-            int completed = sqlite3_column_int(stmt, 1);
-            
-            GtkWidget *assign_card = gtk_box_new(GTK_ORIENTATION_VERTICAL, 5);
-            GtkStyleContext *assign_ctx = gtk_widget_get_style_context(assign_card);
-            gtk_style_context_add_class(assign_ctx, "report-card");
-            
-            char assign_text[300];
-            float pct = total > 0 ? (float)completed / total * 100 : 0;
-            snprintf(assign_text, sizeof(assign_text),
-                     "<b>Assignment Completion</b>\n"
-                     "Total Assignments: %d | Completed: %d | Pending: %d\n"
-                     "Completion Rate: %.1f%%",
-                     total, completed, total - completed, pct);
-            
-            GtkWidget *assign_label = gtk_label_new(NULL);
-            gtk_label_set_markup(GTK_LABEL(assign_label), assign_text);
-            gtk_widget_set_halign(assign_label, GTK_ALIGN_START);
-            gtk_box_pack_start(GTK_BOX(assign_card), assign_label, FALSE, FALSE, 5);
-            gtk_box_pack_start(GTK_BOX(rw->student_report_box), assign_card, FALSE, FALSE, 5);
-        }
-        sqlite3_finalize(stmt);
+        char assign_text[300];
+        float pct = assign_total > 0 ? (float)completed / assign_total * 100 : 0;
+        snprintf(assign_text, sizeof(assign_text),
+                 "<b>Assignment Completion</b>\n"
+                 "Total Assignments: %d | Completed: %d | Pending: %d\n"
+                 "Completion Rate: %.1f%%",
+                 assign_total, completed, assign_total - completed, pct);
+        
+        GtkWidget *assign_label = gtk_label_new(NULL);
+        gtk_label_set_markup(GTK_LABEL(assign_label), assign_text);
+        gtk_widget_set_halign(assign_label, GTK_ALIGN_START);
+        gtk_box_pack_start(GTK_BOX(assign_card), assign_label, FALSE, FALSE, 5);
+        gtk_box_pack_start(GTK_BOX(rw->student_report_box), assign_card, FALSE, FALSE, 5);
     }
     
     gtk_widget_show_all(rw->student_report_box);
@@ -517,16 +1296,44 @@ void show_reports_window(GtkWindow *parent) {
     create_attendance_report_tab(rw);
     create_assignment_report_tab(rw);
     create_student_report_tab(rw);
+    create_monthly_report_tab(rw);
+    create_subject_report_tab(rw);
+    create_trends_tab(rw);
     
-    gtk_container_add(GTK_CONTAINER(rw->window), rw->notebook);
+    // Progress of the background job, shown while it runs
+    GtkWidget *content = gtk_box_new(GTK_ORIENTATION_VERTICAL, 0);
+    rw->progress = gtk_progress_bar_new();
+    gtk_progress_bar_set_show_text(GTK_PROGRESS_BAR(rw->progress), TRUE);
+    gtk_box_pack_start(GTK_BOX(content), rw->progress, FALSE, FALSE, 0);
+    gtk_box_pack_start(GTK_BOX(content), rw->notebook, TRUE, TRUE, 0);
     
-    // Load initial data
-    refresh_attendance_report(rw);
-    refresh_assignment_report(rw);
+    // Export to CSV or JSON
+    GtkWidget *export_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 10);
+    gtk_widget_set_margin_start(export_box, 15);
+    gtk_widget_set_margin_end(export_box, 15);
+    gtk_widget_set_margin_bottom(export_box, 10);
+    gtk_box_pack_start(GTK_BOX(export_box), gtk_label_new("Export:"), FALSE, FALSE, 0);
+    rw->export_combo = gtk_combo_box_text_new();
+    for (int i = 0; i < EXPORT_KINDS; i++) {
+        gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(rw->export_combo), EXPORT_LABELS[i]);
+    }
+    gtk_combo_box_set_active(GTK_COMBO_BOX(rw->export_combo), 0);
+    gtk_box_pack_start(GTK_BOX(export_box), rw->export_combo, FALSE, FALSE, 0);
+    rw->export_button = gtk_button_new_with_label("Export...");
+    gtk_widget_set_tooltip_text(rw->export_button, "Save as .csv, or .json for JSON");
+    g_signal_connect_swapped(rw->export_button, "clicked",
+                             G_CALLBACK(on_export_clicked), rw);
+    gtk_box_pack_start(GTK_BOX(export_box), rw->export_button, FALSE, FALSE, 0);
+    gtk_box_pack_start(GTK_BOX(content), export_box, FALSE, FALSE, 0);
+    gtk_container_add(GTK_CONTAINER(rw->window), content);
     
-    // Cleanup on close
+    // Cleanup on close; this also cancels a running job
     g_signal_connect_swapped(rw->window, "destroy",
-                             G_CALLBACK(g_free), rw);
+                             G_CALLBACK(on_reports_destroy), rw);
     
     gtk_widget_show_all(rw->window);
+    gtk_widget_hide(rw->progress);
+    
+    // Load initial data in the background
+    start_reports(rw, REPORT_ALL);
 }
@@ -0,0 +1,346 @@
+/**
+ * UI Result Model - GtkTreeModel over in-memory result sets
+ * Serves cells straight from db result arrays and report rows, without
+ * copying them into a GtkListStore
+ */
+
+#include <string.h>
+#include "ui_result_model.h"
+
+struct _ResultModel {
+    GObject parent;
+    int n_columns;
+    GType *types;
+    gpointer rows;
+    GArray *values;           // set instead of rows/get for GValue rows
+    int count;
+    ResultModelGetFunc get;
+    ResultModelFreeFunc free_rows;
+    int *order;               // row shown at each position
+    int capacity;
+    int sort_column;          // negative when unsorted
+    GtkSortType sort_order;
+    int stamp;
+};
+
+static void result_model_tree_model_init(GtkTreeModelIface *iface);
+static void result_model_sortable_init(GtkTreeSortableIface *iface);
+
+G_DEFINE_TYPE_WITH_CODE(ResultModel, result_model, G_TYPE_OBJECT,
+                        G_IMPLEMENT_INTERFACE(GTK_TYPE_TREE_MODEL, result_model_tree_model_init)
+                        G_IMPLEMENT_INTERFACE(GTK_TYPE_TREE_SORTABLE, result_model_sortable_init))
+
+static void result_model_init(ResultModel *model) {
+    model->sort_column = GTK_TREE_SORTABLE_UNSORTED_SORT_COLUMN_ID;
+    model->sort_order = GTK_SORT_ASCENDING;
+    model->stamp = g_random_int();
+}
+
+static void result_model_finalize(GObject *object) {
+    ResultModel *model = RESULT_MODEL(object);
+    
+    if (model->values) {
+        g_array_unref(model->values);
+    } else if (model->rows && model->free_rows) {
+        model->free_rows(model->rows, model->count);
+    }
+    g_free(model->types);
+    g_free(model->order);
+    
+    G_OBJECT_CLASS(result_model_parent_class)->finalize(object);
+}
+
+static void result_model_class_init(ResultModelClass *klass) {
+    G_OBJECT_CLASS(klass)->finalize = result_model_finalize;
+}
+
+static void read_cell(ResultModel *model, int row, int column, GValue *value) {
+    if (model->values) {
+        GValue *cell = &g_array_index(model->values, GValue, row * model->n_columns + column);
+        if (G_VALUE_HOLDS_STRING(cell)) {
+            g_value_set_static_string(value, g_value_get_string(cell));
+        } else {
+            g_value_copy(cell, value);
+        }
+    } else {
+        model->get(model->rows, row, column, value);
+    }
+}
+
+// Make room for count rows in the position map
+static void reserve_rows(ResultModel *model, int count) {
+    if (count <= model->capacity) return;
+    int capacity = model->capacity > 0 ? model->capacity : 64;
+    while (capacity < count) capacity *= 2;
+    model->order = g_renew(int, model->order, capacity);
+    model->capacity = capacity;
+}
+
+// ---------------------------------------------------------------------------
+// GtkTreeModel: a flat list, iters hold the row's position
+
+static GtkTreeModelFlags result_model_get_flags(GtkTreeModel *tree_model) {
+    (void)tree_model;
+    return GTK_TREE_MODEL_LIST_ONLY;
+}
+
+static gint result_model_get_n_columns(GtkTreeModel *tree_model) {
+    return RESULT_MODEL(tree_model)->n_columns;
+}
+
+static GType result_model_get_column_type(GtkTreeModel *tree_model, gint column) {
+    ResultModel *model = RESULT_MODEL(tree_model);
+    g_return_val_if_fail(column >= 0 && column < model->n_columns, G_TYPE_INVALID);
+    return model->types[column];
+}
+
+static gboolean set_iter(ResultModel *model, GtkTreeIter *iter, int position) {
+    if (position < 0 || position >= model->count) {
+        iter->stamp = 0;
+        return FALSE;
+    }
+    iter->stamp = model->stamp;
+    iter->user_data = GINT_TO_POINTER(position);
+    return TRUE;
+}
+
+static gboolean result_model_get_iter(GtkTreeModel *tree_model, GtkTreeIter *iter, GtkTreePath *path) {
+    if (gtk_tree_path_get_depth(path) != 1) return FALSE;
+    return set_iter(RESULT_MODEL(tree_model), iter, gtk_tree_path_get_indices(path)[0]);
+}
+
+static GtkTreePath* result_model_get_path(GtkTreeModel *tree_model, GtkTreeIter *iter) {
+    g_return_val_if_fail(iter->stamp == RESULT_MODEL(tree_model)->stamp, NULL);
+    return gtk_tree_path_new_from_indices(GPOINTER_TO_INT(iter->user_data), -1);
+}
+
+static void result_model_get_value(GtkTreeModel *tree_model, GtkTreeIter *iter,
+                                   gint column, GValue *value) {
+    ResultModel *model = RESULT_MODEL(tree_model);
+    g_return_if_fail(iter->stamp == model->stamp);
+    g_return_if_fail(column >= 0 && column < model->n_columns);
+    
+    g_value_init(value, model->types[column]);
+    read_cell(model, model->order[GPOINTER_TO_INT(iter->user_data)], column, value);
+}
+
+static gboolean result_model_iter_next(GtkTreeModel *tree_model, GtkTreeIter *iter) {
+    return set_iter(RESULT_MODEL(tree_model), iter, GPOINTER_TO_INT(iter->user_data) + 1);
+}
+
+static gboolean result_model_iter_previous(GtkTreeModel *tree_model, GtkTreeIter *iter) {
+    return set_iter(RESULT_MODEL(tree_model), iter, GPOINTER_TO_INT(iter->user_data) - 1);
+}
+
+static gboolean result_model_iter_children(GtkTreeModel *tree_model, GtkTreeIter *iter,
+                                           GtkTreeIter *parent) {
+    if (parent) return FALSE;
+    return set_iter(RESULT_MODEL(tree_model), iter, 0);
+}
+
+static gboolean result_model_iter_has_child(GtkTreeModel *tree_model, GtkTreeIter *iter) {
+    (void)tree_model;
+    (void)iter;
+    return FALSE;
+}
+
+static gint result_model_iter_n_children(GtkTreeModel *tree_model, GtkTreeIter *iter) {
+    return iter ? 0 : RESULT_MODEL(tree_model)->count;
+}
+
+static gboolean result_model_iter_nth_child(GtkTreeModel *tree_model, GtkTreeIter *iter,
+                                            GtkTreeIter *parent, gint n) {
+    if (parent) return FALSE;
+    return set_iter(RESULT_MODEL(tree_model), iter, n);
+}
+
+static gboolean result_model_iter_parent(GtkTreeModel *tree_model, GtkTreeIter *iter,
+                                         GtkTreeIter *child) {
+    (void)tree_model;
+    (void)iter;
+    (void)child;
+    return FALSE;
+}
+
+static void result_model_tree_model_init(GtkTreeModelIface *iface) {
+    iface->get_flags = result_model_get_flags;
+    iface->get_n_columns = result_model_get_n_columns;
+    iface->get_column_type = result_model_get_column_type;
+    iface->get_iter = result_model_get_iter;
+    iface->get_path = result_model_get_path;
+    iface->get_value = result_model_get_value;
+    iface->iter_next = result_model_iter_next;
+    iface->iter_previous = result_model_iter_previous;
+    iface->iter_children = result_model_iter_children;
+    iface->iter_has_child = result_model_iter_has_child;
+    iface->iter_n_children = result_model_iter_n_children;
+    iface->iter_nth_child = result_model_iter_nth_child;
+    iface->iter_parent = result_model_iter_parent;
+}
+
+// ---------------------------------------------------------------------------
+// GtkTreeSortable: sort by the cell values of one column, ties by row
+
+static gint compare_rows(gconstpointer a, gconstpointer b, gpointer data) {
+    ResultModel *model = data;
+    int row_a = *(const int *)a;
+    int row_b = *(const int *)b;
+    GType type = model->types[model->sort_column];
+    
+    GValue value_a = G_VALUE_INIT;
+    GValue value_b = G_VALUE_INIT;
+    g_value_init(&value_a, type);
+    g_value_init(&value_b, type);
+    read_cell(model, row_a, model->sort_column, &value_a);
+    read_cell(model, row_b, model->sort_column, &value_b);
+    
+    int result = 0;
+    switch (G_TYPE_FUNDAMENTAL(type)) {
+        case G_TYPE_STRING: {
+            const char *text_a = g_value_get_string(&value_a);
+            const char *text_b = g_value_get_string(&value_b);
+            result = g_utf8_collate(text_a ? text_a : "", text_b ? text_b : "");
+            break;
+        }
+        case G_TYPE_INT: {
+            int x = g_value_get_int(&value_a);
+            int y = g_value_get_int(&value_b);
+            result = (x > y) - (x < y);
+            break;
+        }
+        case G_TYPE_DOUBLE: {
+            double x = g_value_get_double(&value_a);
+            double y = g_value_get_double(&value_b);
+            result = (x > y) - (x < y);
+            break;
+        }
+        case G_TYPE_BOOLEAN:
+            result = g_value_get_boolean(&value_a) - g_value_get_boolean(&value_b);
+            break;
+        default:
+            break;
+    }
+    g_value_unset(&value_a);
+    g_value_unset(&value_b);
+    
+    if (model->sort_order == GTK_SORT_DESCENDING) result = -result;
+    return result != 0 ? result : (row_a > row_b) - (row_a < row_b);
+}
+
+// Reorder the positions for the current sort column and tell the views
+static void resort(ResultModel *model) {
+    if (model->count < 2) return;
+    
+    int *previous = g_new(int, model->count);
+    memcpy(previous, model->order, model->count * sizeof(int));
+    
+    if (model->sort_column >= 0) {
+        g_qsort_with_data(model->order, model->count, sizeof(int), compare_rows, model);
+    } else {
+        for (int i = 0; i < model->count; i++) model->order[i] = i;
+    }
+    
+    // new_order[position] = the position the row had before
+    int *was_at = g_new(int, model->count);
+    int *new_order = g_new(int, model->count);
+    for (int i = 0; i < model->count; i++) was_at[previous[i]] = i;
+    for (int i = 0; i < model->count; i++) new_order[i] = was_at[model->order[i]];
+    
+    GtkTreePath *path = gtk_tree_path_new();
+    gtk_tree_model_rows_reordered(GTK_TREE_MODEL(model), path, NULL, new_order);
+    gtk_tree_path_free(path);
+    
+    g_free(new_order);
+    g_free(was_at);
+    g_free(previous);
+}
+
+static gboolean result_model_get_sort_column_id(GtkTreeSortable *sortable, gint *column,
+                                                GtkSortType *order) {
+    ResultModel *model = RESULT_MODEL(sortable);
+    if (column) *column = model->sort_column;
+    if (order) *order = model->sort_order;
+    return model->sort_column >= 0;
+}
+
+static void result_model_set_sort_column_id(GtkTreeSortable *sortable, gint column,
+                                            GtkSortType order) {
+    ResultModel *model = RESULT_MODEL(sortable);
+    if (column >= model->n_columns) return;
+    if (column == model->sort_column && order == model->sort_order) return;
+    
+    model->sort_column = column;
+    model->sort_order = order;
+    gtk_tree_sortable_sort_column_changed(sortable);
+    resort(model);
+}
+
+static gboolean result_model_has_default_sort_func(GtkTreeSortable *sortable) {
+    (void)sortable;
+    return FALSE;
+}
+
+static void result_model_sortable_init(GtkTreeSortableIface *iface) {
+    iface->get_sort_column_id = result_model_get_sort_column_id;
+    iface->set_sort_column_id = result_model_set_sort_column_id;
+    iface->has_default_sort_func = result_model_has_default_sort_func;
+}
+
+// ---------------------------------------------------------------------------
+
+static ResultModel* new_model(int n_columns, const GType *types, int count) {
+    ResultModel *model = g_object_new(RESULT_TYPE_MODEL, NULL);
+    model->n_columns = n_columns;
+    model->types = g_new(GType, n_columns);
+    memcpy(model->types, types, n_columns * sizeof(GType));
+    
+    reserve_rows(model, count);
+    for (int i = 0; i < count; i++) model->order[i] = i;
+    model->count = count;
+    return model;
+}
+
+ResultModel* result_model_new(int n_columns, const GType *types, gpointer rows, int count,
+                              ResultModelGetFunc get, ResultModelFreeFunc free_rows) {
+    ResultModel *model = new_model(n_columns, types, rows ? count : 0);
+    model->rows = rows;
+    model->get = get;
+    model->free_rows = free_rows;
+    return model;
+}
+
+ResultModel* result_model_new_values(int n_columns, const GType *types, GArray *values) {
+    ResultModel *model = new_model(n_columns, types, values ? (int)values->len / n_columns : 0);
+    model->values = values ? g_array_ref(values) : NULL;
+    return model;
+}
+
+void result_model_rows_added(ResultModel *model, int count) {
+    if (count <= model->count) return;
+    reserve_rows(model, count);
+    
+    // New rows go at the end, then move into place if the view is sorted
+    while (model->count < count) {
+        int position = model->count;
+        model->order[position] = position;
+        model->count++;
+    
+        GtkTreeIter iter;
+        set_iter(model, &iter, position);
+        GtkTreePath *path = gtk_tree_path_new_from_indices(position, -1);
+        gtk_tree_model_row_inserted(GTK_TREE_MODEL(model), path, &iter);
+        gtk_tree_path_free(path);
+    }
+    if (model->sort_column >= 0) resort(model);
+}
+
+void result_model_attach(GtkTreeView *view, ResultModel *model) {
+    GtkTreeModel *previous = gtk_tree_view_get_model(view);
+    gint column;
+    GtkSortType order;
+    if (previous && GTK_IS_TREE_SORTABLE(previous) &&
+        gtk_tree_sortable_get_sort_column_id(GTK_TREE_SORTABLE(previous), &column, &order)) {
+        gtk_tree_sortable_set_sort_column_id(GTK_TREE_SORTABLE(model), column, order);
+    }
+    gtk_tree_view_set_model(view, GTK_TREE_MODEL(model));
+}
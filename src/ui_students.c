@@ -1,11 +1,12 @@
 #include "ui_students.h"
 #include "database.h"
+#include "db_import.h"
 #include "validation.h"
+#include "ui_result_model.h"
 
 typedef struct {
     GtkWidget *window;
     GtkWidget *tree_view;
-    GtkListStore *list_store;
     GtkWidget *name_entry;
     GtkWidget *email_entry;
     GtkWidget *roll_entry;
@@ -81,26 +82,34 @@ static void apply_students_css(void) {
     g_object_unref(provider);
 }
 
+static const GType STUDENT_COLUMN_TYPES[NUM_COLS] = {
+    G_TYPE_INT, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING
+};
+
+// Cells come straight from the Student array the model holds
+static void get_student_cell(gpointer rows, int row, int column, GValue *value) {
+    Student *student = ((Student **)rows)[row];
+    switch (column) {
+        case COL_ID: g_value_set_int(value, student->id); break;
+        case COL_NAME: g_value_set_static_string(value, student->name); break;
+        case COL_EMAIL: g_value_set_static_string(value, student->email); break;
+        case COL_ROLL: g_value_set_static_string(value, student->roll_number); break;
+        case COL_PHONE: g_value_set_static_string(value, student->phone); break;
+    }
+}
+
+static void free_student_rows(gpointer rows, int count) {
+    db_free_students(rows, count);
+}
+
 static void refresh_students_list(StudentsWindow *sw) {
-    gtk_list_store_clear(sw->list_store);
-    
     int count;
     Student **students = db_get_students_by_class(g_session.current_class_id, &count);
     
-    if (students) {
-        for (int i = 0; i < count; i++) {
-            GtkTreeIter iter;
-            gtk_list_store_append(sw->list_store, &iter);
-            gtk_list_store_set(sw->list_store, &iter,
-                             COL_ID, students[i]->id,
-                             COL_NAME, students[i]->name,
-                             COL_EMAIL, students[i]->email,
-                             COL_ROLL, students[i]->roll_number,
-                             COL_PHONE, students[i]->phone,
-                             -1);
-        }
-        db_free_students(students, count);
-    }
+    ResultModel *model = result_model_new(NUM_COLS, STUDENT_COLUMN_TYPES, students, count,
+                                          get_student_cell, free_student_rows);
+    result_model_attach(GTK_TREE_VIEW(sw->tree_view), model);
+    g_object_unref(model);
 }
 
 static void clear_form(StudentsWindow *sw) {
@@ -243,6 +252,42 @@ static void on_clear_form_clicked(GtkButton *button, gpointer user_data) {
     clear_form(sw);
 }
 
+// Add the students of a CSV/TSV roster to the current class
+static void on_import_students_clicked(GtkButton *button, gpointer user_data) {
+    (void)button;
+    StudentsWindow *sw = (StudentsWindow *)user_data;
+    
+    char *path = choose_csv_file(GTK_WINDOW(sw->window), "Import Students");
+    if (!path) return;
+    
+    ImportReport report;
+    bool ok = db_import_students_csv(path, g_session.current_class_id, &report);
+    g_free(path);
+    
+    if (!ok && report.imported == 0) {
+        show_error_dialog(GTK_WINDOW(sw->window), report.failure);
+        db_free_import_report(&report);
+        return;
+    }
+    
+    // One line per rejected row
+    GString *details = g_string_new(NULL);
+    for (int i = 0; i < report.error_count; i++) {
+        g_string_append_printf(details, "Line %d: %s\n", report.errors[i].line, report.errors[i].message);
+    }
+    
+    char message[300];
+    snprintf(message, sizeof(message), "Imported %d of %d students.%s%s%s",
+             report.imported, report.rows,
+             ok ? "" : "\nThe import stopped early: ", ok ? "" : report.failure,
+             report.rejected > 0 ? "\nThese rows were skipped:" : "");
+    show_details_dialog(GTK_WINDOW(sw->window), message, details->str);
+    
+    g_string_free(details, TRUE);
+    db_free_import_report(&report);
+    refresh_students_list(sw);
+}
+
 static void on_student_selected(GtkTreeView *tree_view, gpointer user_data) {
     StudentsWindow *sw = (StudentsWindow *)user_data;
     
@@ -327,9 +372,8 @@ void show_students_window(GtkWindow *parent) {
     gtk_box_pack_start(GTK_BOX(left_box), list_label, FALSE, FALSE, 0);
     
     // Create tree view
-    sw->list_store = gtk_list_store_new(NUM_COLS, G_TYPE_INT, G_TYPE_STRING, 
-                                        G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING);
-    sw->tree_view = gtk_tree_view_new_with_model(GTK_TREE_MODEL(sw->list_store));
+    // Filled with a result model by refresh_students_list
+    sw->tree_view = gtk_tree_view_new();
     gtk_tree_view_set_grid_lines(GTK_TREE_VIEW(sw->tree_view), GTK_TREE_VIEW_GRID_LINES_HORIZONTAL);
     
     GtkCellRenderer *renderer;
@@ -455,6 +499,14 @@ void show_students_window(GtkWindow *parent) {
     g_signal_connect(clear_button, "clicked", G_CALLBACK(on_clear_form_clicked), sw);
     gtk_grid_attach(GTK_GRID(button_grid), clear_button, 1, 1, 1, 1);
     
+    GtkWidget *import_button = gtk_button_new_with_label("Import CSV...");
+    gtk_widget_set_tooltip_text(import_button,
+                                "Add students from a CSV or TSV file with name, email, roll and phone columns");
+    GtkStyleContext *imp_ctx = gtk_widget_get_style_context(import_button);
+    gtk_style_context_add_class(imp_ctx, "action-btn");
+    g_signal_connect(import_button, "clicked", G_CALLBACK(on_import_students_clicked), sw);
+    gtk_grid_attach(GTK_GRID(button_grid), import_button, 0, 2, 2, 1);
+    
     gtk_box_pack_start(GTK_BOX(right_box), button_grid, FALSE, FALSE, 0);
     
     gtk_container_add(GTK_CONTAINER(right_frame), right_box);
@@ -0,0 +1,11 @@
+#include "database.h"
+#include "db_rollup.h"
+#include "db_bitmap.h"
+int main(int argc,char**argv){
+  if(!db_init(argv[1])){printf("init failed\n");return 1;}
+  int n; AttendanceSummary **r=db_get_attendance_summary(1,&n);
+  for(int i=0;i<n;i++) printf("%s days=%d p=%d a=%d l=%d\n",r[i]->name,r[i]->total_days,r[i]->present,r[i]->absent,r[i]->late);
+  db_free_attendance_summary(r,n);
+  AttendanceRollup **ru=db_get_class_rollup(1,ROLLUP_CLASS_DAY,&n);
+  printf("rollups=%d\n",n); db_free_rollups(ru,n);
+  db_cleanup(); return 0;}
@@ -0,0 +1,861 @@
+/**
+ * Database benchmark harness
+ * Generates a deterministic synthetic dataset into a scratch database, then
+ * times every db_* operation and the report queries used by the UI.
+ * Results are written as JSON so runs can be compared between builds.
+ *
+ * Usage: bench [--db PATH] [--out PATH] [--classes N] [--students N]
+ *              [--days N] [--assignments N] [--seed N] [--iterations N]
+ *              [--sparse]
+ */
+
+#include "database.h"
+#include "db_analytics.h"
+#include "db_batch.h"
+#include "db_bitmap.h"
+#include "db_bulk.h"
+#include "db_cursor.h"
+#include "db_export.h"
+#include "db_import.h"
+#include "db_rollup.h"
+#include "db_snapshot.h"
+#include "synth.h"
+
+typedef struct {
+    SynthConfig config;
+    SynthDataset data;
+    unsigned long long rng;
+    int iterations;
+    AnalyticsStore analytics;        // Last store loaded by analytics_load
+    char roster_path[512];           // CSV written by the first roster import
+    char attendance_path[512];       // CSV written by the first attendance import
+    char export_path[512];           // File the export ops overwrite
+    char snapshot_path[512];         // Class snapshot the snapshot ops overwrite
+} BenchContext;
+
+typedef struct {
+    const char *name;
+    int (*run)(BenchContext *ctx);   // Returns number of rows touched
+    int iterations;                  // 0 = use the default count
+} BenchOp;
+
+typedef struct {
+    const char *name;
+    int iterations;
+    double total_us;
+    double min_us;
+    double max_us;
+    long long rows;
+} BenchResult;
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec / 1e3;
+}
+
+static int pick(BenchContext *ctx, int n) {
+    return n > 0 ? (int)(synth_next(&ctx->rng) % (unsigned long long)n) : 0;
+}
+
+static int total_students(BenchContext *ctx) {
+    return ctx->config.classes * ctx->config.students_per_class;
+}
+
+static int total_assignments(BenchContext *ctx) {
+    return ctx->config.classes * ctx->config.assignments_per_class;
+}
+
+static int random_class(BenchContext *ctx) {
+    return ctx->data.class_ids[pick(ctx, ctx->config.classes)];
+}
+
+static int random_student(BenchContext *ctx) {
+    return ctx->data.student_ids[pick(ctx, total_students(ctx))];
+}
+
+static int random_assignment_index(BenchContext *ctx) {
+    return pick(ctx, total_assignments(ctx));
+}
+
+static time_t random_day(BenchContext *ctx) {
+    return ctx->data.school_days[pick(ctx, ctx->config.school_days)];
+}
+
+static void random_day_string(BenchContext *ctx, char *out, size_t size) {
+    time_t day = random_day(ctx);
+    struct tm *tm_info = gmtime(&day);
+    strftime(out, size, "%Y-%m-%d", tm_info);
+}
+
+// User and class operations
+static int op_verify_user(BenchContext *ctx) {
+    (void)ctx;
+    int user_id;
+    char name[MAX_NAME_LENGTH];
+    return db_verify_user(SYNTH_EMAIL, SYNTH_PASSWORD, &user_id, name) ? 1 : 0;
+}
+
+static int op_get_user_classes(BenchContext *ctx) {
+    int count;
+    Class **classes = db_get_user_classes(ctx->data.user_id, &count);
+    db_free_classes(classes, count);
+    return count;
+}
+
+static int op_get_class_by_id(BenchContext *ctx) {
+    Class *cls = db_get_class_by_id(random_class(ctx));
+    int rows = cls ? 1 : 0;
+    free(cls);
+    return rows;
+}
+
+// Student operations
+static int op_get_students_by_class(BenchContext *ctx) {
+    int count;
+    Student **students = db_get_students_by_class(random_class(ctx), &count);
+    db_free_students(students, count);
+    return count;
+}
+
+static int op_get_all_students(BenchContext *ctx) {
+    (void)ctx;
+    int count;
+    Student **students = db_get_all_students(&count);
+    db_free_students(students, count);
+    return count;
+}
+
+static int op_get_student_by_id(BenchContext *ctx) {
+    Student *s = db_get_student_by_id(random_student(ctx));
+    int rows = s ? 1 : 0;
+    free(s);
+    return rows;
+}
+
+static int op_student_email_exists(BenchContext *ctx) {
+    char email[MAX_EMAIL_LENGTH];
+    snprintf(email, sizeof(email), "student%06d@example.com", pick(ctx, total_students(ctx)) + 1);
+    return db_student_email_exists(email, 0) ? 1 : 0;
+}
+
+static int op_student_roll_exists(BenchContext *ctx) {
+    char roll[50];
+    snprintf(roll, sizeof(roll), "R%06d", pick(ctx, total_students(ctx)) + 1);
+    return db_student_roll_exists(roll, 0) ? 1 : 0;
+}
+
+static int op_student_create_update_delete(BenchContext *ctx) {
+    int class_id = random_class(ctx);
+    if (!db_create_student("Bench Temp", "bench-temp@example.com", "BENCH-TEMP", "", class_id)) {
+        return 0;
+    }
+    int id = (int)sqlite3_last_insert_rowid(g_db);
+    db_update_student(id, "Bench Temp 2", "bench-temp@example.com", "BENCH-TEMP", "123");
+    db_delete_student(id);
+    return 3;
+}
+
+// Import a 1,000-row roster (one row in 50 repeating a registered student)
+// into a new class, then delete the class again
+#define BENCH_ROSTER_ROWS 1000
+
+static int op_import_students_csv(BenchContext *ctx) {
+    if (!ctx->roster_path[0]) return 0;
+
+    FILE *file = fopen(ctx->roster_path, "r");
+    if (file) {
+        fclose(file);
+    } else {
+        file = fopen(ctx->roster_path, "w");
+        if (!file) return 0;
+        fprintf(file, "Roll No,Name,Email,Phone\n");
+        for (int i = 0; i < BENCH_ROSTER_ROWS; i++) {
+            if (i % 50 == 49) {
+                fprintf(file, "R%06d,Registered,student%06d@example.com,\n", i + 1, i + 1);
+            } else {
+                fprintf(file, "IMPORT-%d,\"Imported, Student %d\",import%d@example.com,555-%04d\n", i, i, i, i);
+            }
+        }
+        fclose(file);
+    }
+
+    int class_id;
+    if (!db_create_class("Bench Import", "", ctx->data.user_id, &class_id)) return 0;
+    ImportReport report;
+    db_import_students_csv(ctx->roster_path, class_id, &report);
+    int imported = report.imported;
+    db_free_import_report(&report);
+    db_delete_class(class_id);
+    return imported;
+}
+
+// Assignment operations
+static int op_get_assignments_by_class(BenchContext *ctx) {
+    int count;
+    Assignment **assignments = db_get_assignments_by_class(random_class(ctx), &count);
+    db_free_assignments(assignments, count);
+    return count;
+}
+
+static int op_get_all_assignments(BenchContext *ctx) {
+    (void)ctx;
+    int count;
+    Assignment **assignments = db_get_all_assignments(&count);
+    db_free_assignments(assignments, count);
+    return count;
+}
+
+static int op_get_assignment_by_id(BenchContext *ctx) {
+    Assignment *a = db_get_assignment_by_id(ctx->data.assignment_ids[random_assignment_index(ctx)]);
+    int rows = a ? 1 : 0;
+    free(a);
+    return rows;
+}
+
+static int op_assignment_create_update_delete(BenchContext *ctx) {
+    int class_id = random_class(ctx);
+    time_t due = random_day(ctx);
+    if (!db_create_assignment("Bench Temp", "Bench", "", due, ctx->data.user_id, class_id)) {
+        return 0;
+    }
+    int id = (int)sqlite3_last_insert_rowid(g_db);
+    db_update_assignment(id, "Bench Temp 2", "Bench", "updated", due);
+    db_delete_assignment(id);
+    return 3;
+}
+
+// Submission operations
+static int op_get_submissions_by_assignment(BenchContext *ctx) {
+    int count;
+    AssignmentSubmission **subs = db_get_submissions_by_assignment(
+        ctx->data.assignment_ids[random_assignment_index(ctx)], &count);
+    db_free_submissions(subs, count);
+    return count;
+}
+
+static int op_get_submission(BenchContext *ctx) {
+    int a = random_assignment_index(ctx);
+    int c = a / ctx->config.assignments_per_class;
+    int s = c * ctx->config.students_per_class + pick(ctx, ctx->config.students_per_class);
+    AssignmentSubmission *sub = db_get_submission(ctx->data.assignment_ids[a], ctx->data.student_ids[s]);
+    int rows = sub ? 1 : 0;
+    free(sub);
+    return rows;
+}
+
+static int op_create_or_update_submission(BenchContext *ctx) {
+    int a = random_assignment_index(ctx);
+    int c = a / ctx->config.assignments_per_class;
+    int s = c * ctx->config.students_per_class + pick(ctx, ctx->config.students_per_class);
+    return db_create_or_update_submission(ctx->data.assignment_ids[a], ctx->data.student_ids[s],
+                                          SUBMISSION_TIMELY, QUALITY_HIGH, "bench") ? 1 : 0;
+}
+
+// Attendance operations
+static int op_mark_attendance(BenchContext *ctx) {
+    return db_mark_attendance(random_student(ctx), random_day(ctx),
+                              ATTENDANCE_PRESENT, "") ? 1 : 0;
+}
+
+static int op_get_attendance_by_date(BenchContext *ctx) {
+    int count;
+    Attendance **rows = db_get_attendance_by_date(random_day(ctx), &count);
+    db_free_attendance(rows, count);
+    return count;
+}
+
+static int op_get_attendance_by_student(BenchContext *ctx) {
+    int count;
+    Attendance **rows = db_get_attendance_by_student(random_student(ctx), &count);
+    db_free_attendance(rows, count);
+    return count;
+}
+
+// Copy one day of a class onto another and undo it, leaving the data as it was
+static int op_bulk_copy_undo(BenchContext *ctx) {
+    int class_id = random_class(ctx);
+    char from[20], to[20];
+    random_day_string(ctx, from, sizeof(from));
+    random_day_string(ctx, to, sizeof(to));
+    if (strcmp(from, to) == 0) return 0;
+
+    int days = db_bulk_copy_date(class_id, from, to);
+    if (days > 0 && !db_bulk_undo(class_id, NULL, 0)) return 0;
+    return days > 0 ? ctx->config.students_per_class : 0;
+}
+
+// Import a month of attendance for the first class, a column per day, on
+// dates before the synthetic ones; every run writes the same marks
+#define BENCH_IMPORT_DAYS 30
+
+static int op_import_attendance_csv(BenchContext *ctx) {
+    if (!ctx->attendance_path[0]) return 0;
+    int class_id = ctx->data.class_ids[0];
+
+    FILE *file = fopen(ctx->attendance_path, "r");
+    if (file) {
+        fclose(file);
+    } else {
+        file = fopen(ctx->attendance_path, "w");
+        if (!file) return 0;
+        int count;
+        Student **students = db_get_students_by_class(class_id, &count);
+        fprintf(file, "Roll No,Name");
+        for (int day = 1; day <= BENCH_IMPORT_DAYS; day++) fprintf(file, ",2000-01-%02d", day);
+        fprintf(file, "\n");
+        for (int i = 0; i < count; i++) {
+            fprintf(file, "%s,\"%s\"", students[i]->roll_number, students[i]->name);
+            for (int day = 1; day <= BENCH_IMPORT_DAYS; day++) {
+                fprintf(file, ",%s", (i + day) % 11 == 0 ? "A" : ((i + day) % 7 == 0 ? "L" : "P"));
+            }
+            fprintf(file, "\n");
+        }
+        db_free_students(students, count);
+        fclose(file);
+    }
+
+    ImportReport report;
+    db_import_attendance_csv(ctx->attendance_path, class_id, &report);
+    int imported = report.imported;
+    db_free_import_report(&report);
+    return imported;
+}
+
+// Export every attendance mark of a random class
+static int op_export_attendance_history(BenchContext *ctx) {
+    long rows = db_export_attendance_history(ctx->export_path, EXPORT_CSV, random_class(ctx));
+    return rows > 0 ? (int)rows : 0;
+}
+
+// Snapshot a random class, compressed when the build has zstd
+static int op_snapshot_export(BenchContext *ctx) {
+    long size = db_snapshot_export(ctx->snapshot_path, random_class(ctx), true);
+    return size > 0 ? 1 : 0;
+}
+
+// Move the last class out to a snapshot and back in, as when it changes
+// installations; the benchmark's ids follow it
+static int op_snapshot_move_class(BenchContext *ctx) {
+    int index = ctx->config.classes - 1;
+    int class_id = ctx->data.class_ids[index];
+    if (db_snapshot_export(ctx->snapshot_path, class_id, true) < 0 || !db_delete_class(class_id)) {
+        return 0;
+    }
+
+    SnapshotReport report;
+    if (!db_snapshot_import(ctx->snapshot_path, ctx->data.user_id, &report)) {
+        fprintf(stderr, "Snapshot import failed: %s\n", report.failure);
+        return 0;
+    }
+    ctx->data.class_ids[index] = report.class_id;
+
+    int count;
+    Student **students = db_get_students_by_class(report.class_id, &count);
+    int *student_ids = ctx->data.student_ids + index * ctx->config.students_per_class;
+    for (int i = 0; i < count && i < ctx->config.students_per_class; i++) {
+        student_ids[i] = students[i]->id;
+    }
+    db_free_students(students, count);
+    Assignment **assignments = db_get_assignments_by_class(report.class_id, &count);
+    int *assignment_ids = ctx->data.assignment_ids + index * ctx->config.assignments_per_class;
+    for (int i = 0; i < count && i < ctx->config.assignments_per_class; i++) {
+        assignment_ids[i] = assignments[i]->id;
+    }
+    db_free_assignments(assignments, count);
+
+    return report.students + report.assignments + report.submissions + report.marks;
+}
+
+// Batch and cursor operations
+static int op_mark_attendance_batch(BenchContext *ctx) {
+    int class_id = random_class(ctx);
+    time_t day = random_day(ctx);
+
+    int count;
+    Student **students = db_get_students_by_class(class_id, &count);
+    AttendanceEntry *entries = calloc(count > 0 ? count : 1, sizeof(AttendanceEntry));
+    for (int i = 0; i < count; i++) {
+        entries[i].student_id = students[i]->id;
+        entries[i].status = ATTENDANCE_PRESENT;
+        entries[i].notes = "";
+    }
+    int saved = db_mark_attendance_batch(day, entries, count);
+    free(entries);
+    db_free_students(students, count);
+    return saved > 0 ? saved : 0;
+}
+
+static int op_save_submissions_batch(BenchContext *ctx) {
+    int a = random_assignment_index(ctx);
+    int first = (a / ctx->config.assignments_per_class) * ctx->config.students_per_class;
+    int count = ctx->config.students_per_class;
+
+    SubmissionEntry *entries = calloc(count, sizeof(SubmissionEntry));
+    for (int i = 0; i < count; i++) {
+        entries[i].student_id = ctx->data.student_ids[first + i];
+        entries[i].status = SUBMISSION_TIMELY;
+        entries[i].quality = QUALITY_ABOVE_AVERAGE;
+        entries[i].notes = "";
+    }
+    int saved = db_save_submissions_batch(ctx->data.assignment_ids[a], entries, count);
+    free(entries);
+    return saved > 0 ? saved : 0;
+}
+
+static int op_cursor_students_by_class(BenchContext *ctx) {
+    DbCursor cursor;
+    Student page[64];
+    int rows = 0;
+    if (db_cursor_students_by_class(&cursor, random_class(ctx))) {
+        int n;
+        while ((n = db_cursor_fetch_students(&cursor, page, 64)) > 0) {
+            rows += n;
+        }
+    }
+    db_cursor_close(&cursor);
+    return rows;
+}
+
+static int op_cursor_attendance_by_class(BenchContext *ctx) {
+    DbCursor cursor;
+    Attendance row;
+    int rows = 0;
+    if (db_cursor_attendance_by_class(&cursor, random_class(ctx))) {
+        while (db_cursor_next_attendance(&cursor, &row)) {
+            rows++;
+        }
+    }
+    db_cursor_close(&cursor);
+    return rows;
+}
+
+// Report queries used by the attendance and reports windows
+static int op_get_attendance_dates(BenchContext *ctx) {
+    int count;
+    char **dates = db_get_attendance_dates(random_class(ctx), &count);
+    db_free_attendance_dates(dates, count);
+    return count;
+}
+
+// Month search as typed into the attendance window ("YYYY-MM")
+static int op_search_attendance_dates(BenchContext *ctx) {
+    char month[20];
+    random_day_string(ctx, month, sizeof(month));
+    month[7] = '\0';
+    int count;
+    char **dates = db_search_attendance_dates(random_class(ctx), month, month, &count);
+    db_free_attendance_dates(dates, count);
+    return count;
+}
+
+static int op_get_attendance_sheet(BenchContext *ctx) {
+    char date[20];
+    random_day_string(ctx, date, sizeof(date));
+    int count;
+    AttendanceSheetRow **rows = db_get_attendance_sheet(random_class(ctx), date, &count);
+    db_free_attendance_sheet(rows, count);
+    return count;
+}
+
+static int op_get_submission_sheet(BenchContext *ctx) {
+    int a = random_assignment_index(ctx);
+    int class_id = ctx->data.class_ids[a / ctx->config.assignments_per_class];
+    int count;
+    SubmissionSheetRow **rows = db_get_submission_sheet(class_id, ctx->data.assignment_ids[a], &count);
+    db_free_submission_sheet(rows, count);
+    return count;
+}
+
+static int op_count_students_by_class(BenchContext *ctx) {
+    return db_count_students_by_class(random_class(ctx)) > 0 ? 1 : 0;
+}
+
+static int op_get_attendance_summary(BenchContext *ctx) {
+    int count;
+    AttendanceSummary **rows = db_get_attendance_summary(random_class(ctx), &count);
+    db_free_attendance_summary(rows, count);
+    return count;
+}
+
+static int op_get_attendance_summary_range(BenchContext *ctx) {
+    char first[20], second[20];
+    random_day_string(ctx, first, sizeof(first));
+    random_day_string(ctx, second, sizeof(second));
+    bool ordered = strcmp(first, second) <= 0;
+
+    int count;
+    AttendanceSummary **rows = db_get_attendance_summary_range(random_class(ctx),
+                                                               ordered ? first : second,
+                                                               ordered ? second : first, &count);
+    db_free_attendance_summary(rows, count);
+    return count;
+}
+
+static int op_get_assignment_summary(BenchContext *ctx) {
+    int count;
+    AssignmentSummary **rows = db_get_assignment_summary(random_class(ctx), &count);
+    db_free_assignment_summary(rows, count);
+    return count;
+}
+
+static int op_get_student_attendance_stats(BenchContext *ctx) {
+    int total, present, absent, late;
+    return db_get_student_attendance_stats(random_student(ctx), &total, &present, &absent, &late) ? 1 : 0;
+}
+
+static int op_get_student_assignment_stats(BenchContext *ctx) {
+    int s = pick(ctx, total_students(ctx));
+    int class_id = ctx->data.class_ids[s / ctx->config.students_per_class];
+    int total, completed;
+    return db_get_student_assignment_stats(ctx->data.student_ids[s], class_id, &total, &completed) ? 1 : 0;
+}
+
+static int op_analytics_load(BenchContext *ctx) {
+    analytics_free(&ctx->analytics);
+    if (!analytics_load(&ctx->analytics, ctx->data.user_id)) return 0;
+    return ctx->analytics.attendance_count + ctx->analytics.submission_count;
+}
+
+static int op_analytics_monthly_attendance(BenchContext *ctx) {
+    int count;
+    free(analytics_monthly_attendance(&ctx->analytics, NULL, NULL, &count));
+    return count;
+}
+
+static int op_analytics_subject_quality(BenchContext *ctx) {
+    int count;
+    free(analytics_subject_quality(&ctx->analytics, NULL, NULL, &count));
+    return count;
+}
+
+static int op_get_class_rollup(BenchContext *ctx) {
+    int count;
+    AttendanceRollup **rows = db_get_class_rollup(random_class(ctx), (RollupTable)pick(ctx, 3), &count);
+    db_free_rollups(rows, count);
+    return count;
+}
+
+// A year of class days, as read by the attendance calendar
+static int op_get_class_rollup_year(BenchContext *ctx) {
+    char from[20];
+    char to[20];
+    random_day_string(ctx, from, sizeof(from));
+    snprintf(to, sizeof(to), "%.4s-12-31", from);
+    memcpy(from + 4, "-01-01", 7);
+    int count;
+    AttendanceRollup **rows = db_get_class_rollup_range(random_class(ctx), ROLLUP_CLASS_DAY,
+                                                        from, to, &count);
+    db_free_rollups(rows, count);
+    return count;
+}
+
+static int op_get_student_rollup(BenchContext *ctx) {
+    int count;
+    AttendanceRollup **rows = db_get_student_rollup(random_student(ctx), &count);
+    db_free_rollups(rows, count);
+    return count;
+}
+
+// Whole-screen scenarios, issuing the same calls in the same order as the UI
+static int scenario_open_submission_tracker(BenchContext *ctx) {
+    int a = random_assignment_index(ctx);
+    int class_id = ctx->data.class_ids[a / ctx->config.assignments_per_class];
+    int rows = 0;
+
+    Assignment *assignment = db_get_assignment_by_id(ctx->data.assignment_ids[a]);
+    free(assignment);
+
+    int count;
+    SubmissionSheetRow **sheet = db_get_submission_sheet(class_id, ctx->data.assignment_ids[a], &count);
+    for (int i = 0; i < count; i++) {
+        rows += sheet[i]->status != SUBMISSION_NONE ? 1 : 0;
+    }
+    db_free_submission_sheet(sheet, count);
+    return rows;
+}
+
+static int scenario_save_attendance_day(BenchContext *ctx) {
+    int class_id = random_class(ctx);
+    time_t day = random_day(ctx);
+
+    int count;
+    Student **students = db_get_students_by_class(class_id, &count);
+    AttendanceEntry *entries = calloc(count > 0 ? count : 1, sizeof(AttendanceEntry));
+    if (!entries) {
+        db_free_students(students, count);
+        return 0;
+    }
+
+    // Same mix as the generated data: mostly present, a few absent or late
+    for (int i = 0; i < count; i++) {
+        int roll = (int)(synth_next(&ctx->rng) % 100);
+        entries[i].student_id = students[i]->id;
+        entries[i].status = roll < 88 ? ATTENDANCE_PRESENT : roll < 95 ? ATTENDANCE_ABSENT : ATTENDANCE_LATE;
+        entries[i].notes = "";
+    }
+
+    int rows = db_save_attendance_day(class_id, day, entries, count);
+    free(entries);
+    db_free_students(students, count);
+    return rows > 0 ? rows : 0;
+}
+
+static int scenario_open_attendance_window(BenchContext *ctx) {
+    int class_id = random_class(ctx);
+    int rows = 0;
+
+    int count;
+    char **dates = db_get_attendance_dates(class_id, &count);
+    if (dates) {
+        int sheet_count;
+        AttendanceSheetRow **sheet = db_get_attendance_sheet(class_id, dates[0], &sheet_count);
+        db_free_attendance_sheet(sheet, sheet_count);
+        rows += sheet_count;
+    }
+    db_free_attendance_dates(dates, count);
+
+    Student **students = db_get_students_by_class(class_id, &count);
+    db_free_students(students, count);
+    return rows + count;
+}
+
+static int scenario_open_reports_window(BenchContext *ctx) {
+    int class_id = random_class(ctx);
+    int rows = 0;
+
+    int count;
+    AttendanceSummary **att = db_get_attendance_summary(class_id, &count);
+    db_free_attendance_summary(att, count);
+    rows += count;
+
+    db_count_students_by_class(class_id);
+    AssignmentSummary **assign = db_get_assignment_summary(class_id, &count);
+    db_free_assignment_summary(assign, count);
+    rows += count;
+
+    Student **students = db_get_students_by_class(class_id, &count);
+    db_free_students(students, count);
+    return rows + count;
+}
+
+static const BenchOp BENCH_OPS[] = {
+    {"db_verify_user", op_verify_user, 0},
+    {"db_get_user_classes", op_get_user_classes, 0},
+    {"db_get_class_by_id", op_get_class_by_id, 0},
+    {"db_get_students_by_class", op_get_students_by_class, 0},
+    {"db_get_all_students", op_get_all_students, 10},
+    {"db_get_student_by_id", op_get_student_by_id, 0},
+    {"db_student_email_exists", op_student_email_exists, 0},
+    {"db_student_roll_exists", op_student_roll_exists, 0},
+    {"db_student_create_update_delete", op_student_create_update_delete, 0},
+    {"db_import_students_csv", op_import_students_csv, 10},
+    {"db_get_assignments_by_class", op_get_assignments_by_class, 0},
+    {"db_get_all_assignments", op_get_all_assignments, 10},
+    {"db_get_assignment_by_id", op_get_assignment_by_id, 0},
+    {"db_assignment_create_update_delete", op_assignment_create_update_delete, 0},
+    {"db_get_submissions_by_assignment", op_get_submissions_by_assignment, 0},
+    {"db_get_submission", op_get_submission, 0},
+    {"db_create_or_update_submission", op_create_or_update_submission, 0},
+    {"db_mark_attendance", op_mark_attendance, 0},
+    {"db_get_attendance_by_date", op_get_attendance_by_date, 0},
+    {"db_get_attendance_by_student", op_get_attendance_by_student, 0},
+    {"db_mark_attendance_batch", op_mark_attendance_batch, 20},
+    {"db_save_submissions_batch", op_save_submissions_batch, 20},
+    {"db_bulk_copy_undo", op_bulk_copy_undo, 10},
+    {"db_import_attendance_csv", op_import_attendance_csv, 5},
+    {"db_export_attendance_history", op_export_attendance_history, 10},
+    {"db_snapshot_export", op_snapshot_export, 10},
+    {"db_snapshot_move_class", op_snapshot_move_class, 3},
+    {"db_cursor_students_by_class", op_cursor_students_by_class, 0},
+    {"db_cursor_attendance_by_class", op_cursor_attendance_by_class, 10},
+    {"db_get_attendance_dates", op_get_attendance_dates, 0},
+    {"db_search_attendance_dates", op_search_attendance_dates, 0},
+    {"db_get_attendance_sheet", op_get_attendance_sheet, 0},
+    {"db_get_submission_sheet", op_get_submission_sheet, 0},
+    {"db_count_students_by_class", op_count_students_by_class, 0},
+    {"db_get_attendance_summary", op_get_attendance_summary, 10},
+    {"db_get_assignment_summary", op_get_assignment_summary, 10},
+    {"db_get_student_attendance_stats", op_get_student_attendance_stats, 0},
+    {"db_get_student_assignment_stats", op_get_student_assignment_stats, 0},
+    {"db_get_attendance_summary_range", op_get_attendance_summary_range, 10},
+    {"analytics_load", op_analytics_load, 5},
+    {"analytics_monthly_attendance", op_analytics_monthly_attendance, 0},
+    {"analytics_subject_quality", op_analytics_subject_quality, 0},
+    {"db_get_class_rollup", op_get_class_rollup, 0},
+    {"db_get_class_rollup_year", op_get_class_rollup_year, 0},
+    {"db_get_student_rollup", op_get_student_rollup, 0},
+    {"scenario_open_submission_tracker", scenario_open_submission_tracker, 5},
+    {"scenario_save_attendance_day", scenario_save_attendance_day, 5},
+    {"scenario_open_attendance_window", scenario_open_attendance_window, 5},
+    {"scenario_open_reports_window", scenario_open_reports_window, 5},
+};
+
+#define BENCH_OP_COUNT (int)(sizeof(BENCH_OPS) / sizeof(BENCH_OPS[0]))
+
+static void run_op(BenchContext *ctx, const BenchOp *op, BenchResult *result) {
+    result->name = op->name;
+    result->iterations = op->iterations > 0 && op->iterations < ctx->iterations ?
+                         op->iterations : ctx->iterations;
+    result->total_us = 0;
+    result->min_us = 0;
+    result->max_us = 0;
+    result->rows = 0;
+
+    for (int i = 0; i < result->iterations; i++) {
+        double start = now_us();
+        result->rows += op->run(ctx);
+        double elapsed = now_us() - start;
+
+        result->total_us += elapsed;
+        if (i == 0 || elapsed < result->min_us) result->min_us = elapsed;
+        if (elapsed > result->max_us) result->max_us = elapsed;
+    }
+}
+
+static void write_json(FILE *out, BenchContext *ctx, double generate_ms,
+                       BenchResult *results, int count) {
+    fprintf(out, "{\n");
+    fprintf(out, "  \"sqlite_version\": \"%s\",\n", sqlite3_libversion());
+    fprintf(out, "  \"config\": {\"classes\": %d, \"students_per_class\": %d, "
+                 "\"school_days\": %d, \"assignments_per_class\": %d, "
+                 "\"seed\": %llu, \"iterations\": %d, \"sparse_attendance\": %d},\n",
+            ctx->config.classes, ctx->config.students_per_class,
+            ctx->config.school_days, ctx->config.assignments_per_class,
+            ctx->config.seed, ctx->iterations, ctx->config.sparse_attendance ? 1 : 0);
+    fprintf(out, "  \"dataset\": {\"students\": %d, \"assignments\": %d, "
+                 "\"attendance_rows\": %lld, \"submission_rows\": %lld, "
+                 "\"generate_ms\": %.3f},\n",
+            total_students(ctx), total_assignments(ctx),
+            ctx->data.attendance_rows, ctx->data.submission_rows, generate_ms);
+    fprintf(out, "  \"results\": [\n");
+    for (int i = 0; i < count; i++) {
+        BenchResult *r = &results[i];
+        fprintf(out, "    {\"name\": \"%s\", \"iterations\": %d, \"total_ms\": %.3f, "
+                     "\"mean_us\": %.3f, \"min_us\": %.3f, \"max_us\": %.3f, \"rows\": %lld}%s\n",
+                r->name, r->iterations, r->total_us / 1000.0,
+                r->iterations > 0 ? r->total_us / r->iterations : 0.0,
+                r->min_us, r->max_us, r->rows, i + 1 < count ? "," : "");
+    }
+    fprintf(out, "  ]\n");
+    fprintf(out, "}\n");
+}
+
+static void print_usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [--db PATH] [--out PATH] [--classes N] [--students N]\n"
+            "          [--days N] [--assignments N] [--seed N] [--iterations N]\n"
+            "          [--sparse]\n",
+            prog);
+}
+
+int main(int argc, char *argv[]) {
+    BenchContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    synth_default_config(&ctx.config);
+    ctx.iterations = 200;
+
+    const char *db_path = "build/bench.db";
+    const char *out_path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        }
+        if (strcmp(arg, "--sparse") == 0) {
+            ctx.config.sparse_attendance = true;
+            continue;
+        }
+        if (!value) {
+            print_usage(argv[0]);
+            return 1;
+        }
+
+        if (strcmp(arg, "--db") == 0) db_path = value;
+        else if (strcmp(arg, "--out") == 0) out_path = value;
+        else if (strcmp(arg, "--classes") == 0) ctx.config.classes = atoi(value);
+        else if (strcmp(arg, "--students") == 0) ctx.config.students_per_class = atoi(value);
+        else if (strcmp(arg, "--days") == 0) ctx.config.school_days = atoi(value);
+        else if (strcmp(arg, "--assignments") == 0) ctx.config.assignments_per_class = atoi(value);
+        else if (strcmp(arg, "--seed") == 0) ctx.config.seed = strtoull(value, NULL, 10);
+        else if (strcmp(arg, "--iterations") == 0) ctx.iterations = atoi(value);
+        else {
+            print_usage(argv[0]);
+            return 1;
+        }
+        i++;
+    }
+
+    if (ctx.config.classes <= 0 || ctx.config.students_per_class <= 0 ||
+        ctx.config.school_days <= 0 || ctx.config.assignments_per_class <= 0 ||
+        ctx.iterations <= 0) {
+        fprintf(stderr, "All sizes and the iteration count must be positive\n");
+        return 1;
+    }
+
+    // Always start from an empty scratch database
+    remove(db_path);
+    if (!db_init(db_path)) {
+        fprintf(stderr, "Failed to initialize database at %s\n", db_path);
+        return 1;
+    }
+
+    fprintf(stderr, "Generating dataset: %d classes x %d students, %d days, %d assignments/class%s\n",
+            ctx.config.classes, ctx.config.students_per_class,
+            ctx.config.school_days, ctx.config.assignments_per_class,
+            ctx.config.sparse_attendance ? ", sparse attendance" : "");
+
+    double start = now_us();
+    if (!synth_generate(&ctx.config, &ctx.data)) {
+        fprintf(stderr, "Failed to generate synthetic dataset\n");
+        db_cleanup();
+        return 1;
+    }
+    double generate_ms = (now_us() - start) / 1000.0;
+
+    ctx.rng = ctx.config.seed ^ 0xB5AD4ECEDA1CE2A9ULL;
+    snprintf(ctx.roster_path, sizeof(ctx.roster_path), "%s.roster.csv", db_path);
+    remove(ctx.roster_path);
+    snprintf(ctx.attendance_path, sizeof(ctx.attendance_path), "%s.attendance.csv", db_path);
+    remove(ctx.attendance_path);
+    snprintf(ctx.export_path, sizeof(ctx.export_path), "%s.export.csv", db_path);
+    snprintf(ctx.snapshot_path, sizeof(ctx.snapshot_path), "%s.akclass", db_path);
+
+    BenchResult results[BENCH_OP_COUNT];
+    for (int i = 0; i < BENCH_OP_COUNT; i++) {
+        fprintf(stderr, "  %-40s", BENCH_OPS[i].name);
+        run_op(&ctx, &BENCH_OPS[i], &results[i]);
+        fprintf(stderr, "%10.1f us/op\n", results[i].total_us / results[i].iterations);
+    }
+    remove(ctx.roster_path);
+    remove(ctx.attendance_path);
+    remove(ctx.export_path);
+    remove(ctx.snapshot_path);
+
+    FILE *out = stdout;
+    if (out_path) {
+        out = fopen(out_path, "w");
+        if (!out) {
+            fprintf(stderr, "Cannot write %s\n", out_path);
+            synth_free(&ctx.data);
+            db_cleanup();
+            return 1;
+        }
+    }
+
+    write_json(out, &ctx, generate_ms, results, BENCH_OP_COUNT);
+
+    if (out != stdout) {
+        fclose(out);
+        fprintf(stderr, "Results written to %s\n", out_path);
+    }
+
+    analytics_free(&ctx.analytics);
+    synth_free(&ctx.data);
+    db_cleanup();
+    return 0;
+}
@@ -0,0 +1,339 @@
+/**
+ * Performance regression gate
+ * Compares a bench results file against the checked-in baseline and fails
+ * when any operation exceeds its budget:
+ *
+ *     limit = baseline_mean_us * (1 + tolerance) * scale + slack_us
+ *
+ * Usage: perf_check --baseline PATH --results PATH [--scale F] [--update]
+ *
+ * --update rewrites the baseline from the results, keeping the existing
+ * per-operation tolerances.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#define MAX_OPS 128
+#define OP_NAME_LENGTH 64
+
+typedef struct {
+    char name[OP_NAME_LENGTH];
+    double mean_us;
+    double tolerance;   // < 0 = use the file default
+    bool seen;
+} PerfOp;
+
+typedef struct {
+    int classes;
+    int students_per_class;
+    int school_days;
+    int assignments_per_class;
+    long long seed;
+    int sparse_attendance;
+} PerfConfig;
+
+typedef struct {
+    PerfConfig config;
+    double default_tolerance;
+    double slack_us;
+    PerfOp ops[MAX_OPS];
+    int count;
+} PerfBaseline;
+
+// Both files are written by our own tools, so a flat key scanner is enough:
+// every entry is a single-level object inside one top-level array.
+
+static char* read_file(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return NULL;
+    }
+
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    char *text = malloc(size + 1);
+    if (!text) {
+        fclose(f);
+        return NULL;
+    }
+    size_t read = fread(text, 1, size, f);
+    text[read] = '\0';
+    fclose(f);
+    return text;
+}
+
+// Find "key": inside [begin, end) and return a pointer to its value
+static const char* find_key(const char *begin, const char *end, const char *key) {
+    char pattern[OP_NAME_LENGTH + 4];
+    snprintf(pattern, sizeof(pattern), "\"%s\"", key);
+    size_t len = strlen(pattern);
+
+    for (const char *p = begin; p + len <= end; p++) {
+        if (strncmp(p, pattern, len) != 0) continue;
+
+        const char *v = p + len;
+        while (v < end && (*v == ' ' || *v == '\t' || *v == '\n' || *v == '\r')) v++;
+        if (v < end && *v == ':') {
+            v++;
+            while (v < end && (*v == ' ' || *v == '\t' || *v == '\n' || *v == '\r')) v++;
+            return v;
+        }
+    }
+    return NULL;
+}
+
+static bool get_number(const char *begin, const char *end, const char *key, double *out) {
+    const char *v = find_key(begin, end, key);
+    if (!v) return false;
+
+    char *stop;
+    double value = strtod(v, &stop);
+    if (stop == v) return false;
+    *out = value;
+    return true;
+}
+
+static bool get_string(const char *begin, const char *end, const char *key, char *out, size_t size) {
+    const char *v = find_key(begin, end, key);
+    if (!v || *v != '"') return false;
+
+    v++;
+    size_t n = 0;
+    while (v < end && *v != '"' && n + 1 < size) {
+        out[n++] = *v++;
+    }
+    out[n] = '\0';
+    return true;
+}
+
+// Bounds of the object that starts at the '{' found after key
+static bool find_object(const char *begin, const char *end, const char *key,
+                        const char **obj_begin, const char **obj_end) {
+    const char *v = find_key(begin, end, key);
+    if (!v || *v != '{') return false;
+
+    const char *close = memchr(v, '}', end - v);
+    if (!close) return false;
+    *obj_begin = v;
+    *obj_end = close + 1;
+    return true;
+}
+
+static void read_config(const char *begin, const char *end, PerfConfig *config) {
+    double value;
+    memset(config, 0, sizeof(*config));
+    if (get_number(begin, end, "classes", &value)) config->classes = (int)value;
+    if (get_number(begin, end, "students_per_class", &value)) config->students_per_class = (int)value;
+    if (get_number(begin, end, "school_days", &value)) config->school_days = (int)value;
+    if (get_number(begin, end, "assignments_per_class", &value)) config->assignments_per_class = (int)value;
+    if (get_number(begin, end, "seed", &value)) config->seed = (long long)value;
+    if (get_number(begin, end, "sparse_attendance", &value)) config->sparse_attendance = (int)value;
+}
+
+// Parse the objects of the array stored under key into ops
+static bool read_ops(const char *text, const char *array_key, PerfBaseline *out) {
+    const char *end = text + strlen(text);
+    const char *p = find_key(text, end, array_key);
+    if (!p || *p != '[') {
+        fprintf(stderr, "Missing \"%s\" array\n", array_key);
+        return false;
+    }
+
+    out->count = 0;
+    while ((p = strpbrk(p, "{]")) != NULL && *p == '{') {
+        const char *close = strchr(p, '}');
+        if (!close) break;
+
+        if (out->count >= MAX_OPS) {
+            fprintf(stderr, "Too many operations (max %d)\n", MAX_OPS);
+            return false;
+        }
+
+        PerfOp *op = &out->ops[out->count];
+        memset(op, 0, sizeof(*op));
+        op->tolerance = -1;
+        if (get_string(p, close, "name", op->name, sizeof(op->name)) &&
+            get_number(p, close, "mean_us", &op->mean_us)) {
+            get_number(p, close, "tolerance", &op->tolerance);
+            out->count++;
+        }
+        p = close + 1;
+    }
+    return true;
+}
+
+static bool load(const char *path, const char *array_key, PerfBaseline *out) {
+    char *text = read_file(path);
+    if (!text) return false;
+
+    memset(out, 0, sizeof(*out));
+    out->default_tolerance = 1.0;
+    out->slack_us = 50.0;
+
+    const char *end = text + strlen(text);
+    const char *cfg_begin, *cfg_end;
+    if (find_object(text, end, "config", &cfg_begin, &cfg_end)) {
+        read_config(cfg_begin, cfg_end, &out->config);
+    }
+    get_number(text, end, "default_tolerance", &out->default_tolerance);
+    get_number(text, end, "slack_us", &out->slack_us);
+
+    bool ok = read_ops(text, array_key, out);
+    free(text);
+    return ok;
+}
+
+static PerfOp* find_op(PerfBaseline *set, const char *name) {
+    for (int i = 0; i < set->count; i++) {
+        if (strcmp(set->ops[i].name, name) == 0) {
+            return &set->ops[i];
+        }
+    }
+    return NULL;
+}
+
+static bool same_config(const PerfConfig *a, const PerfConfig *b) {
+    return a->classes == b->classes && a->students_per_class == b->students_per_class &&
+           a->school_days == b->school_days && a->assignments_per_class == b->assignments_per_class &&
+           a->seed == b->seed && a->sparse_attendance == b->sparse_attendance;
+}
+
+static bool write_baseline(const char *path, const PerfBaseline *baseline, const PerfBaseline *results) {
+    FILE *out = fopen(path, "w");
+    if (!out) {
+        fprintf(stderr, "Cannot write %s\n", path);
+        return false;
+    }
+
+    const PerfConfig *c = &results->config;
+    fprintf(out, "{\n");
+    fprintf(out, "  \"config\": {\"classes\": %d, \"students_per_class\": %d, "
+                 "\"school_days\": %d, \"assignments_per_class\": %d, \"seed\": %lld, "
+                 "\"sparse_attendance\": %d},\n",
+            c->classes, c->students_per_class, c->school_days, c->assignments_per_class, c->seed,
+            c->sparse_attendance);
+    fprintf(out, "  \"default_tolerance\": %.2f,\n", baseline->default_tolerance);
+    fprintf(out, "  \"slack_us\": %.1f,\n", baseline->slack_us);
+    fprintf(out, "  \"operations\": [\n");
+    for (int i = 0; i < results->count; i++) {
+        const PerfOp *r = &results->ops[i];
+        const PerfOp *old = find_op((PerfBaseline *)baseline, r->name);
+
+        fprintf(out, "    {\"name\": \"%s\", \"mean_us\": %.1f", r->name, r->mean_us);
+        if (old && old->tolerance >= 0) {
+            fprintf(out, ", \"tolerance\": %.2f", old->tolerance);
+        }
+        fprintf(out, "}%s\n", i + 1 < results->count ? "," : "");
+    }
+    fprintf(out, "  ]\n");
+    fprintf(out, "}\n");
+    fclose(out);
+    return true;
+}
+
+static void print_usage(const char *prog) {
+    fprintf(stderr, "Usage: %s --baseline PATH --results PATH [--scale F] [--update]\n", prog);
+}
+
+int main(int argc, char *argv[]) {
+    const char *baseline_path = NULL;
+    const char *results_path = NULL;
+    double scale = 1.0;
+    bool update = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--update") == 0) {
+            update = true;
+        } else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            baseline_path = argv[++i];
+        } else if (strcmp(argv[i], "--results") == 0 && i + 1 < argc) {
+            results_path = argv[++i];
+        } else if (strcmp(argv[i], "--scale") == 0 && i + 1 < argc) {
+            scale = atof(argv[++i]);
+        } else {
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (!baseline_path || !results_path || scale <= 0) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    static PerfBaseline baseline;
+    static PerfBaseline results;
+
+    if (!load(results_path, "results", &results)) return 2;
+
+    if (!load(baseline_path, "operations", &baseline)) {
+        if (!update) return 2;
+        memset(&baseline, 0, sizeof(baseline));
+        baseline.default_tolerance = 1.0;
+        baseline.slack_us = 50.0;
+    }
+
+    if (update) {
+        if (!write_baseline(baseline_path, &baseline, &results)) return 2;
+        printf("Baseline %s updated with %d operations\n", baseline_path, results.count);
+        return 0;
+    }
+
+    if (!same_config(&baseline.config, &results.config)) {
+        fprintf(stderr, "Dataset mismatch: baseline was recorded with %d classes x %d students, "
+                        "%d days, %d assignments, seed %lld, sparse %d; "
+                        "results used %d x %d, %d, %d, seed %lld, sparse %d\n",
+                baseline.config.classes, baseline.config.students_per_class,
+                baseline.config.school_days, baseline.config.assignments_per_class, baseline.config.seed,
+                baseline.config.sparse_attendance,
+                results.config.classes, results.config.students_per_class,
+                results.config.school_days, results.config.assignments_per_class, results.config.seed,
+                results.config.sparse_attendance);
+        return 2;
+    }
+
+    int failures = 0;
+    printf("%-38s %12s %12s %12s %8s  %s\n", "operation", "baseline_us", "current_us", "limit_us", "change", "");
+
+    for (int i = 0; i < results.count; i++) {
+        PerfOp *r = &results.ops[i];
+        PerfOp *b = find_op(&baseline, r->name);
+
+        if (!b) {
+            printf("%-38s %12s %12.1f %12s %8s  new (no baseline)\n", r->name, "-", r->mean_us, "-", "");
+            continue;
+        }
+        b->seen = true;
+
+        double tolerance = b->tolerance >= 0 ? b->tolerance : baseline.default_tolerance;
+        double limit = b->mean_us * (1.0 + tolerance) * scale + baseline.slack_us;
+        double change = b->mean_us > 0 ? (r->mean_us - b->mean_us) * 100.0 / b->mean_us : 0.0;
+        bool over = r->mean_us > limit;
+
+        printf("%-38s %12.1f %12.1f %12.1f %+7.0f%%  %s\n",
+               r->name, b->mean_us, r->mean_us, limit, change, over ? "FAIL" : "ok");
+        if (over) failures++;
+    }
+
+    for (int i = 0; i < baseline.count; i++) {
+        if (!baseline.ops[i].seen) {
+            printf("%-38s %12.1f %12s %12s %8s  FAIL (missing from results)\n",
+                   baseline.ops[i].name, baseline.ops[i].mean_us, "-", "-", "");
+            failures++;
+        }
+    }
+
+    if (failures > 0) {
+        printf("\nperf-check: %d operation(s) over budget\n", failures);
+        return 1;
+    }
+
+    printf("\nperf-check: all %d operations within budget\n", baseline.count);
+    return 0;
+}
@@ -0,0 +1,522 @@
+/**
+ * Query plan regression check
+ * Calls every public db_* function against a small synthetic dataset,
+ * records each distinct SQL statement the core library prepares, and runs
+ * EXPLAIN QUERY PLAN on it. A statement fails when its plan does a full
+ * scan of a large table or needs a temp B-tree for ORDER BY/DISTINCT on a
+ * statement that reads a large table.
+ *
+ * Plans that are known to be unfixable (or waiting on a migration) are
+ * listed in PLAN_EXEMPTIONS with the reason; an exemption that no longer
+ * matches a failing plan is reported so the list does not go stale.
+ *
+ * Usage: plan_check [--db PATH] [--verbose]
+ */
+
+#include <ctype.h>
+#include <strings.h>
+#include "database.h"
+#include "db_analytics.h"
+#include "db_batch.h"
+#include "db_bitmap.h"
+#include "db_bulk.h"
+#include "db_cursor.h"
+#include "db_import.h"
+#include "db_export.h"
+#include "db_snapshot.h"
+#include "db_rollup.h"
+#include "synth.h"
+
+// Tables that grow with the number of students, days or submissions
+static const char *LARGE_TABLES[] = {
+    "students", "attendance", "assignment_submissions", "attendance_sessions",
+    "attendance_bitmaps", "attendance_rollup_class_day", "attendance_rollup_student_month",
+};
+
+#define LARGE_TABLE_COUNT (int)(sizeof(LARGE_TABLES) / sizeof(LARGE_TABLES[0]))
+
+// Accepted plan problems: a distinctive fragment of the SQL and why
+typedef struct {
+    const char *sql_fragment;
+    const char *reason;
+} PlanExemption;
+
+static const PlanExemption PLAN_EXEMPTIONS[] = {
+    {"SELECT COUNT(*) FROM students;", "one-time class-system migration"},
+    {"FROM students WHERE class_id IS NULL OR class_id = 0", "one-time class-system migration"},
+    {"FROM students ORDER BY name", "all-students listing has no filter by design"},
+    {"GROUP BY a.due_date, a.id ORDER BY a.title", "sorts one row per assignment of the class"},
+    {"FROM attendance ORDER BY student_id, date", "bitmap index rebuild reads every row by design"},
+    {"DELETE FROM attendance_bitmaps;", "bitmap index rebuild starts from an empty table"},
+    {"DELETE FROM attendance_rollup_class_day;", "rollup rebuild starts from empty tables"},
+    {"DELETE FROM attendance_rollup_student_month;", "rollup rebuild starts from empty tables"},
+    {") GROUP BY class_id, date;", "rollup rebuild reads every row by design"},
+    {"FROM attendance_rollup_class_day GROUP BY", "rollup rebuild sums every class day by design"},
+    {"SELECT student_id, strftime('%Y-%m', date)", "rollup rebuild reads every row by design"},
+};
+
+#define PLAN_EXEMPTION_COUNT (int)(sizeof(PLAN_EXEMPTIONS) / sizeof(PLAN_EXEMPTIONS[0]))
+
+typedef struct {
+    char **sql;            // [count] distinct statements in first-seen order
+    int count;
+    int capacity;
+    bool failed;           // out of memory: some statements were not logged
+} StatementLog;
+
+static StatementLog g_log;
+
+static void log_statement(const char *sql) {
+    if (!sql) return;
+
+    for (int i = 0; i < g_log.count; i++) {
+        if (strcmp(g_log.sql[i], sql) == 0) return;
+    }
+    if (g_log.count == g_log.capacity) {
+        int capacity = g_log.capacity ? g_log.capacity * 2 : 256;
+        char **grown = realloc(g_log.sql, capacity * sizeof(char *));
+        if (!grown) {
+            g_log.failed = true;
+            return;
+        }
+        g_log.sql = grown;
+        g_log.capacity = capacity;
+    }
+
+    g_log.sql[g_log.count] = malloc(strlen(sql) + 1);
+    if (!g_log.sql[g_log.count]) {
+        g_log.failed = true;
+        return;
+    }
+    strcpy(g_log.sql[g_log.count], sql);
+    g_log.count++;
+}
+
+static int trace_callback(unsigned type, void *ctx, void *p, void *x) {
+    (void)ctx;
+    (void)x;
+    if (type == SQLITE_TRACE_STMT) {
+        log_statement(sqlite3_sql((sqlite3_stmt *)p));
+    }
+    return 0;
+}
+
+// Only data statements have plans worth checking
+static bool is_query(const char *sql) {
+    while (*sql == ' ' || *sql == '\n' || *sql == '\t') sql++;
+    return strncasecmp(sql, "SELECT", 6) == 0 || strncasecmp(sql, "INSERT", 6) == 0 ||
+           strncasecmp(sql, "UPDATE", 6) == 0 || strncasecmp(sql, "DELETE", 6) == 0 ||
+           strncasecmp(sql, "WITH", 4) == 0;
+}
+
+static bool is_ident_char(char c) {
+    return isalnum((unsigned char)c) || c == '_';
+}
+
+// Read the identifier at p into out; returns the position after it
+static const char* read_ident(const char *p, char *out, size_t size) {
+    while (*p && !is_ident_char(*p)) p++;
+    size_t n = 0;
+    while (*p && is_ident_char(*p)) {
+        if (n + 1 < size) out[n++] = *p;
+        p++;
+    }
+    out[n] = '\0';
+    return p;
+}
+
+static bool is_keyword(const char *word) {
+    static const char *keywords[] = {
+        "WHERE", "ON", "INNER", "LEFT", "JOIN", "ORDER", "GROUP", "SET", "VALUES",
+        "LIMIT", "USING", "NATURAL", "CROSS", "UNION", "HAVING", "WINDOW", "",
+    };
+    for (size_t i = 0; i < sizeof(keywords) / sizeof(keywords[0]); i++) {
+        if (strcasecmp(word, keywords[i]) == 0) return true;
+    }
+    return false;
+}
+
+// Does name (a table or an alias in sql) refer to one of the large tables?
+static bool names_large_table(const char *sql, const char *name) {
+    for (int t = 0; t < LARGE_TABLE_COUNT; t++) {
+        if (strcmp(name, LARGE_TABLES[t]) == 0) return true;
+    }
+
+    char word[64], next[64];
+    const char *p = sql;
+    while (*p) {
+        p = read_ident(p, word, sizeof(word));
+        if (word[0] == '\0') break;
+
+        for (int t = 0; t < LARGE_TABLE_COUNT; t++) {
+            if (strcmp(word, LARGE_TABLES[t]) != 0) continue;
+
+            const char *q = read_ident(p, next, sizeof(next));
+            if (strcasecmp(next, "AS") == 0) {
+                read_ident(q, next, sizeof(next));
+            }
+            if (!is_keyword(next) && strcmp(next, name) == 0) return true;
+        }
+    }
+    return false;
+}
+
+static bool reads_large_table(const char *sql) {
+    char word[64];
+    const char *p = sql;
+    while (*p) {
+        p = read_ident(p, word, sizeof(word));
+        if (word[0] == '\0') break;
+        for (int t = 0; t < LARGE_TABLE_COUNT; t++) {
+            if (strcmp(word, LARGE_TABLES[t]) == 0) return true;
+        }
+    }
+    return false;
+}
+
+// One line, single-spaced, for readable output
+static void print_sql(const char *sql) {
+    bool space = false;
+    printf("    ");
+    for (const char *p = sql; *p; p++) {
+        if (isspace((unsigned char)*p)) {
+            space = true;
+            continue;
+        }
+        if (space) putchar(' ');
+        space = false;
+        putchar(*p);
+    }
+    putchar('\n');
+}
+
+static const PlanExemption* find_exemption(const char *sql) {
+    for (int i = 0; i < PLAN_EXEMPTION_COUNT; i++) {
+        if (strstr(sql, PLAN_EXEMPTIONS[i].sql_fragment)) {
+            return &PLAN_EXEMPTIONS[i];
+        }
+    }
+    return NULL;
+}
+
+// Returns the number of problems found in the plan of sql
+static int check_plan(const char *sql, bool verbose) {
+    char *explain = malloc(strlen(sql) + 32);
+    if (!explain) return 1;
+    sprintf(explain, "EXPLAIN QUERY PLAN %s", sql);
+
+    sqlite3_stmt *stmt;
+    int rc = sqlite3_prepare_v2(g_db, explain, -1, &stmt, NULL);
+    free(explain);
+    if (rc != SQLITE_OK) {
+        printf("ERROR  cannot explain: %s\n", sqlite3_errmsg(g_db));
+        print_sql(sql);
+        return 1;
+    }
+
+    char problems[1024] = "";
+    char plan[2048] = "";
+    int count = 0;
+    bool large = reads_large_table(sql);
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        const char *detail = (const char *)sqlite3_column_text(stmt, 3);
+        if (!detail) continue;
+
+        strncat(plan, "      ", sizeof(plan) - strlen(plan) - 1);
+        strncat(plan, detail, sizeof(plan) - strlen(plan) - 1);
+        strncat(plan, "\n", sizeof(plan) - strlen(plan) - 1);
+
+        bool bad = false;
+        if (strncmp(detail, "SCAN ", 5) == 0 && strncmp(detail, "SCAN CONSTANT ROW", 17) != 0) {
+            char name[64];
+            read_ident(detail + 5, name, sizeof(name));
+            bad = names_large_table(sql, name);
+        } else if (large && (strcmp(detail, "USE TEMP B-TREE FOR ORDER BY") == 0 ||
+                             strcmp(detail, "USE TEMP B-TREE FOR DISTINCT") == 0 ||
+                             strstr(detail, "USE TEMP B-TREE FOR RIGHT PART OF ORDER BY"))) {
+            bad = true;
+        }
+
+        if (bad) {
+            strncat(problems, "      -> ", sizeof(problems) - strlen(problems) - 1);
+            strncat(problems, detail, sizeof(problems) - strlen(problems) - 1);
+            strncat(problems, "\n", sizeof(problems) - strlen(problems) - 1);
+            count++;
+        }
+    }
+    sqlite3_finalize(stmt);
+
+    const PlanExemption *exemption = find_exemption(sql);
+    if (count > 0 && exemption) {
+        printf("EXEMPT %s\n", exemption->reason);
+        print_sql(sql);
+        if (verbose) printf("%s", problems);
+        return 0;
+    }
+    if (count > 0) {
+        printf("FAIL\n");
+        print_sql(sql);
+        printf("%s", problems);
+        return count;
+    }
+    if (exemption) {
+        printf("STALE  exemption \"%s\" no longer needed\n", exemption->sql_fragment);
+        print_sql(sql);
+        return 1;
+    }
+    if (verbose) {
+        printf("ok\n");
+        print_sql(sql);
+        printf("%s", plan);
+    }
+    return 0;
+}
+
+// Call every public db_* function once so its SQL gets traced
+static void exercise_api(SynthConfig *config, SynthDataset *data) {
+    int class_id = data->class_ids[0];
+    int student_id = data->student_ids[0];
+    int assignment_id = data->assignment_ids[0];
+    time_t day = data->school_days[0];
+    char date[20];
+    strftime(date, sizeof(date), "%Y-%m-%d", gmtime(&day));
+
+    int count, user_id, new_class_id;
+    char name[MAX_NAME_LENGTH];
+
+    db_user_exists(SYNTH_EMAIL);
+    db_verify_user(SYNTH_EMAIL, SYNTH_PASSWORD, &user_id, name);
+    db_create_user("plan@example.com", "hash", "Plan Check");
+
+    db_create_class("Plan Class", "", data->user_id, &new_class_id);
+    db_update_class(new_class_id, "Plan Class 2", "updated");
+    Class **classes = db_get_user_classes(data->user_id, &count);
+    db_free_classes(classes, count);
+    free(db_get_class_by_id(class_id));
+
+    db_create_student("Plan Student", "plan-student@example.com", "PLAN-1", "", new_class_id);
+    int new_student_id = (int)sqlite3_last_insert_rowid(g_db);
+    db_update_student(new_student_id, "Plan Student", "plan-student@example.com", "PLAN-1", "1");
+    Student **students = db_get_all_students(&count);
+    db_free_students(students, count);
+    students = db_get_students_by_class(class_id, &count);
+    db_free_students(students, count);
+    free(db_get_student_by_id(student_id));
+    db_student_email_exists("student000001@example.com", 0);
+    db_student_roll_exists("R000001", 0);
+
+    const char *roster_path = "build/plan_check_roster.csv";
+    FILE *roster = fopen(roster_path, "w");
+    if (roster) {
+        fprintf(roster, "name,email,roll\nPlan Import,plan-import@example.com,PLAN-2\n"
+                        "Registered,student000001@example.com,R000001\n");
+        fclose(roster);
+        ImportReport report;
+        db_import_students_csv(roster_path, new_class_id, &report);
+        db_free_import_report(&report);
+        remove(roster_path);
+    }
+
+    const char *sheet_path = "build/plan_check_attendance.csv";
+    FILE *sheet_file = fopen(sheet_path, "w");
+    if (sheet_file) {
+        fprintf(sheet_file, "roll,2001-01-01,2001-01-02\nPLAN-1,P,L\n");
+        fclose(sheet_file);
+        ImportReport report;
+        db_import_attendance_csv(sheet_path, new_class_id, &report);
+        db_free_import_report(&report);
+        remove(sheet_path);
+    }
+
+    const char *export_path = "build/plan_check_export.csv";
+    db_export_attendance_report(export_path, EXPORT_CSV, class_id, NULL, NULL, 0);
+    db_export_assignment_report(export_path, EXPORT_CSV, class_id);
+    db_export_student_report(export_path, EXPORT_CSV, student_id);
+    db_export_attendance_history(export_path, EXPORT_CSV, class_id);
+    db_export_submission_history(export_path, EXPORT_JSON, class_id);
+    remove(export_path);
+
+    db_create_assignment("Plan", "Plan", "", day, data->user_id, new_class_id);
+    int new_assignment_id = (int)sqlite3_last_insert_rowid(g_db);
+    db_update_assignment(new_assignment_id, "Plan 2", "Plan", "", day);
+    Assignment **assignments = db_get_all_assignments(&count);
+    db_free_assignments(assignments, count);
+    assignments = db_get_assignments_by_class(class_id, &count);
+    db_free_assignments(assignments, count);
+    free(db_get_assignment_by_id(assignment_id));
+
+    db_create_or_update_submission(new_assignment_id, new_student_id, SUBMISSION_TIMELY, QUALITY_HIGH, "");
+    AssignmentSubmission **subs = db_get_submissions_by_assignment(assignment_id, &count);
+    db_free_submissions(subs, count);
+    free(db_get_submission(assignment_id, student_id));
+    SubmissionSheetRow **grading = db_get_submission_sheet(class_id, assignment_id, &count);
+    db_free_submission_sheet(grading, count);
+
+    db_mark_attendance(new_student_id, day, ATTENDANCE_PRESENT, "");
+    Attendance **attendance = db_get_attendance_by_date(day, &count);
+    db_free_attendance(attendance, count);
+    attendance = db_get_attendance_by_student(student_id, &count);
+    db_free_attendance(attendance, count);
+
+    char **dates = db_get_attendance_dates(class_id, &count);
+    db_free_attendance_dates(dates, count);
+    dates = db_search_attendance_dates(class_id, "2024-01", "2024-03", &count);
+    db_free_attendance_dates(dates, count);
+    AttendanceSheetRow **sheet = db_get_attendance_sheet(class_id, date, &count);
+    db_free_attendance_sheet(sheet, count);
+    db_count_students_by_class(class_id);
+    AttendanceSummary **att_summary = db_get_attendance_summary(class_id, &count);
+    db_free_attendance_summary(att_summary, count);
+    AssignmentSummary **assign_summary = db_get_assignment_summary(class_id, &count);
+    db_free_assignment_summary(assign_summary, count);
+    int total, present, absent, late, completed;
+    db_get_student_attendance_stats(student_id, &total, &present, &absent, &late);
+    db_get_student_assignment_stats(student_id, class_id, &total, &completed);
+
+    AttendanceEntry att_entry = {new_student_id, ATTENDANCE_LATE, ""};
+    db_mark_attendance_batch(day, &att_entry, 1);
+
+    // Sparse storage takes different paths through the attendance readers
+    db_get_attendance_mode(new_class_id);
+    db_set_attendance_mode(new_class_id, ATTENDANCE_STORE_SPARSE);
+    db_save_attendance_day(new_class_id, data->school_days[1], &att_entry, 1);
+    sheet_file = fopen(sheet_path, "w");
+    if (sheet_file) {
+        // New days of a sparse class leave plain presents implied
+        fprintf(sheet_file, "roll,2001-01-01,2001-01-03\nPLAN-1,P,P\n");
+        fclose(sheet_file);
+        ImportReport report;
+        db_import_attendance_csv(sheet_path, new_class_id, &report);
+        db_free_import_report(&report);
+        remove(sheet_path);
+    }
+    sheet = db_get_attendance_sheet(new_class_id, date, &count);
+    db_free_attendance_sheet(sheet, count);
+    att_summary = db_get_attendance_summary(new_class_id, &count);
+    db_free_attendance_summary(att_summary, count);
+    db_get_student_attendance_stats(new_student_id, &total, &present, &absent, &late);
+
+    att_summary = db_get_attendance_summary_range(class_id, date, date, &count);
+    db_free_attendance_summary(att_summary, count);
+    db_bitmap_rebuild();
+    for (int t = ROLLUP_CLASS_DAY; t <= ROLLUP_CLASS_MONTH; t++) {
+        AttendanceRollup **rollups = db_get_class_rollup(class_id, (RollupTable)t, &count);
+        db_free_rollups(rollups, count);
+    }
+    AttendanceRollup **rollups = db_get_student_rollup(student_id, &count);
+    db_free_rollups(rollups, count);
+    db_rollup_rebuild();
+
+    char label[64];
+    char last_day[20];
+    db_rollup_date(data->school_days[config->school_days - 1], last_day, sizeof(last_day));
+    db_bulk_fill_range(class_id, date, last_day, ATTENDANCE_PRESENT, true);
+    db_bulk_copy_date(class_id, date, last_day);
+    db_bulk_mark_holiday(class_id, date, date, "Holiday");
+    char **holidays = db_get_class_holidays(class_id, date, last_day, &count);
+    db_free_attendance_dates(holidays, count);
+    db_bulk_delete_date(class_id, last_day);
+    db_bulk_can_undo(class_id, label, sizeof(label));
+    while (db_bulk_undo(class_id, label, sizeof(label))) {}
+    SubmissionEntry sub_entry = {new_student_id, SUBMISSION_LATE, QUALITY_BELOW_AVERAGE, ""};
+    db_save_submissions_batch(new_assignment_id, &sub_entry, 1);
+
+    DbCursor cursor;
+    Student student;
+    Attendance row;
+    AssignmentSubmission sub;
+    if (db_cursor_students_by_class(&cursor, class_id)) db_cursor_next_student(&cursor, &student);
+    db_cursor_close(&cursor);
+    if (db_cursor_attendance_by_student(&cursor, student_id)) db_cursor_next_attendance(&cursor, &row);
+    db_cursor_close(&cursor);
+    if (db_cursor_attendance_by_class(&cursor, class_id)) db_cursor_next_attendance(&cursor, &row);
+    db_cursor_close(&cursor);
+    if (db_cursor_submissions_by_assignment(&cursor, assignment_id)) db_cursor_next_submission(&cursor, &sub);
+    db_cursor_close(&cursor);
+
+    AnalyticsStore store;
+    if (analytics_load(&store, data->user_id)) analytics_free(&store);
+
+    db_migrate_to_class_system(data->user_id);
+
+    // Move the new class out and back in
+    const char *snapshot_path = "build/plan_check.akclass";
+    db_snapshot_export(snapshot_path, new_class_id, true);
+
+    db_delete_assignment(new_assignment_id);
+    db_delete_student(new_student_id);
+    db_delete_class(new_class_id);
+
+    SnapshotReport snapshot;
+    if (db_snapshot_import(snapshot_path, data->user_id, &snapshot)) {
+        db_delete_class(snapshot.class_id);
+    }
+    remove(snapshot_path);
+}
+
+int main(int argc, char *argv[]) {
+    const char *db_path = "build/plan_check.db";
+    bool verbose = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--db") == 0 && i + 1 < argc) {
+            db_path = argv[++i];
+        } else if (strcmp(argv[i], "--verbose") == 0 || strcmp(argv[i], "-v") == 0) {
+            verbose = true;
+        } else {
+            fprintf(stderr, "Usage: %s [--db PATH] [--verbose]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    remove(db_path);
+    if (!db_init(db_path)) {
+        fprintf(stderr, "Failed to initialize database at %s\n", db_path);
+        return 2;
+    }
+
+    SynthConfig config;
+    SynthDataset data;
+    synth_default_config(&config);
+    config.classes = 2;
+    config.students_per_class = 30;
+    config.school_days = 20;
+    config.assignments_per_class = 5;
+
+    if (!synth_generate(&config, &data)) {
+        fprintf(stderr, "Failed to generate synthetic dataset\n");
+        db_cleanup();
+        return 2;
+    }
+
+    sqlite3_trace_v2(g_db, SQLITE_TRACE_STMT, trace_callback, NULL);
+    exercise_api(&config, &data);
+    sqlite3_trace_v2(g_db, 0, NULL, NULL);
+
+    int checked = 0;
+    int failures = 0;
+    for (int i = 0; i < g_log.count; i++) {
+        if (!is_query(g_log.sql[i])) continue;
+        checked++;
+        failures += check_plan(g_log.sql[i], verbose) > 0 ? 1 : 0;
+    }
+
+    for (int i = 0; i < g_log.count; i++) {
+        free(g_log.sql[i]);
+    }
+    free(g_log.sql);
+    synth_free(&data);
+    db_cleanup();
+
+    if (g_log.failed) {
+        fprintf(stderr, "plan-check: out of memory, not every statement was logged\n");
+        return 2;
+    }
+    if (failures > 0) {
+        printf("\nplan-check: %d of %d statements have plan problems\n", failures, checked);
+        return 1;
+    }
+    printf("\nplan-check: %d statements checked, no full scans or temp sorts on large tables\n", checked);
+    return 0;
+}
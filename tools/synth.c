@@ -0,0 +1,224 @@
+/**
+ * Synthetic dataset generator
+ * Fills a scratch database through the regular db_* API so that benchmarks
+ * and checks run against realistic, reproducible data.
+ */
+
+#include "synth.h"
+
+void synth_default_config(SynthConfig *config) {
+    config->classes = 4;
+    config->students_per_class = 60;
+    config->school_days = 180;
+    config->assignments_per_class = 20;
+    config->seed = 42;
+    config->sparse_attendance = false;
+}
+
+// xorshift64* - small, fast and identical on every platform
+unsigned long long synth_next(unsigned long long *state) {
+    unsigned long long x = *state ? *state : 0x9E3779B97F4A7C15ULL;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+static bool exec_sql(const char *sql) {
+    char *err_msg = NULL;
+    if (sqlite3_exec(g_db, sql, NULL, NULL, &err_msg) != SQLITE_OK) {
+        fprintf(stderr, "SQL error: %s\n", err_msg);
+        sqlite3_free(err_msg);
+        return false;
+    }
+    return true;
+}
+
+// Weekdays starting Monday 2024-01-01, at noon local time like the Mark tab
+static void build_school_days(time_t *days, int count) {
+    struct tm tm = {0};
+    tm.tm_year = 2024 - 1900;
+    tm.tm_mon = 0;
+    tm.tm_mday = 1;
+    tm.tm_hour = 12;
+    tm.tm_isdst = -1;
+
+    int n = 0;
+    while (n < count) {
+        struct tm day = tm;
+        time_t t = mktime(&day);
+        if (day.tm_wday != 0 && day.tm_wday != 6) {
+            days[n++] = t;
+        }
+        tm.tm_mday++;
+    }
+}
+
+static AttendanceStatus random_attendance(unsigned long long *rng) {
+    int roll = (int)(synth_next(rng) % 100);
+    if (roll < 88) return ATTENDANCE_PRESENT;
+    if (roll < 95) return ATTENDANCE_ABSENT;
+    return ATTENDANCE_LATE;
+}
+
+static bool populate(const SynthConfig *config, SynthDataset *dataset);
+
+bool synth_generate(const SynthConfig *config, SynthDataset *dataset) {
+    if (!g_db || !config || !dataset) return false;
+
+    memset(dataset, 0, sizeof(SynthDataset));
+
+    int total_students = config->classes * config->students_per_class;
+    int total_assignments = config->classes * config->assignments_per_class;
+
+    dataset->class_ids = calloc(config->classes > 0 ? config->classes : 1, sizeof(int));
+    dataset->student_ids = calloc(total_students > 0 ? total_students : 1, sizeof(int));
+    dataset->assignment_ids = calloc(total_assignments > 0 ? total_assignments : 1, sizeof(int));
+    dataset->school_days = calloc(config->school_days > 0 ? config->school_days : 1, sizeof(time_t));
+    if (!dataset->class_ids || !dataset->student_ids ||
+        !dataset->assignment_ids || !dataset->school_days) {
+        synth_free(dataset);
+        return false;
+    }
+
+    build_school_days(dataset->school_days, config->school_days);
+
+    // One transaction for the whole dataset; the db_* calls themselves autocommit
+    if (!exec_sql("BEGIN TRANSACTION;")) {
+        synth_free(dataset);
+        return false;
+    }
+
+    if (!populate(config, dataset) || !exec_sql("COMMIT;")) {
+        exec_sql("ROLLBACK;");
+        synth_free(dataset);
+        return false;
+    }
+
+    return true;
+}
+
+static bool populate(const SynthConfig *config, SynthDataset *dataset) {
+    unsigned long long rng = config->seed;
+
+    char hash[100];
+    if (!hash_password(SYNTH_PASSWORD, hash, sizeof(hash)) ||
+        !db_create_user(SYNTH_EMAIL, hash, "Benchmark Teacher")) {
+        fprintf(stderr, "Failed to create benchmark user\n");
+        return false;
+    }
+    dataset->user_id = (int)sqlite3_last_insert_rowid(g_db);
+
+    for (int c = 0; c < config->classes; c++) {
+        char name[MAX_NAME_LENGTH];
+        snprintf(name, sizeof(name), "Class %02d", c + 1);
+        if (!db_create_class(name, "Synthetic benchmark class", dataset->user_id,
+                             &dataset->class_ids[c])) {
+            fprintf(stderr, "Failed to create class %d\n", c + 1);
+            return false;
+        }
+
+        for (int s = 0; s < config->students_per_class; s++) {
+            int n = c * config->students_per_class + s;
+            char student_name[MAX_NAME_LENGTH];
+            char email[MAX_EMAIL_LENGTH];
+            char roll[50];
+            char phone[20];
+            snprintf(student_name, sizeof(student_name), "Student %06d", n + 1);
+            snprintf(email, sizeof(email), "student%06d@example.com", n + 1);
+            snprintf(roll, sizeof(roll), "R%06d", n + 1);
+            snprintf(phone, sizeof(phone), "98%08llu", synth_next(&rng) % 100000000ULL);
+
+            if (!db_create_student(student_name, email, roll, phone, dataset->class_ids[c])) {
+                fprintf(stderr, "Failed to create student %d\n", n + 1);
+                return false;
+            }
+            dataset->student_ids[n] = (int)sqlite3_last_insert_rowid(g_db);
+        }
+
+        for (int a = 0; a < config->assignments_per_class; a++) {
+            int n = c * config->assignments_per_class + a;
+            char title[MAX_TITLE_LENGTH];
+            char subject[MAX_SUBJECT_LENGTH];
+            snprintf(title, sizeof(title), "Assignment %04d", n + 1);
+            snprintf(subject, sizeof(subject), "Subject %d", (int)(synth_next(&rng) % 6) + 1);
+
+            int day = config->school_days > 0 ? (a * config->school_days) /
+                      (config->assignments_per_class > 0 ? config->assignments_per_class : 1) : 0;
+            time_t due = config->school_days > 0 ? dataset->school_days[day] : time(NULL);
+
+            if (!db_create_assignment(title, subject, "Synthetic benchmark assignment",
+                                      due, dataset->user_id, dataset->class_ids[c])) {
+                fprintf(stderr, "Failed to create assignment %d\n", n + 1);
+                return false;
+            }
+            dataset->assignment_ids[n] = (int)sqlite3_last_insert_rowid(g_db);
+
+            for (int s = 0; s < config->students_per_class; s++) {
+                int student_id = dataset->student_ids[c * config->students_per_class + s];
+                SubmissionStatus status = (SubmissionStatus)(synth_next(&rng) % 3);
+                QualityAssessment quality = (QualityAssessment)(synth_next(&rng) % 4);
+                if (!db_create_or_update_submission(dataset->assignment_ids[n], student_id,
+                                                    status, quality, "")) {
+                    fprintf(stderr, "Failed to create submission\n");
+                    return false;
+                }
+                dataset->submission_rows++;
+            }
+        }
+    }
+
+    if (config->sparse_attendance) {
+        for (int c = 0; c < config->classes; c++) {
+            if (!db_set_attendance_mode(dataset->class_ids[c], ATTENDANCE_STORE_SPARSE)) {
+                fprintf(stderr, "Failed to set attendance mode\n");
+                return false;
+            }
+        }
+    }
+
+    // One day of one class at a time, the way the Mark tab saves it
+    AttendanceEntry *entries = calloc(config->students_per_class > 0 ? config->students_per_class : 1,
+                                      sizeof(AttendanceEntry));
+    if (!entries) return false;
+
+    for (int d = 0; d < config->school_days; d++) {
+        for (int c = 0; c < config->classes; c++) {
+            for (int s = 0; s < config->students_per_class; s++) {
+                AttendanceStatus status = random_attendance(&rng);
+                entries[s].student_id = dataset->student_ids[c * config->students_per_class + s];
+                entries[s].status = status;
+                entries[s].notes = status == ATTENDANCE_PRESENT ? "" : "Synthetic note";
+            }
+            if (db_save_attendance_day(dataset->class_ids[c], dataset->school_days[d],
+                                       entries, config->students_per_class) < 0) {
+                fprintf(stderr, "Failed to mark attendance\n");
+                free(entries);
+                return false;
+            }
+        }
+    }
+    free(entries);
+
+    sqlite3_stmt *stmt;
+    if (sqlite3_prepare_v2(g_db, "SELECT COUNT(*) FROM attendance;", -1, &stmt, NULL) != SQLITE_OK) {
+        return false;
+    }
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        dataset->attendance_rows = sqlite3_column_int64(stmt, 0);
+    }
+    sqlite3_finalize(stmt);
+
+    return true;
+}
+
+void synth_free(SynthDataset *dataset) {
+    if (!dataset) return;
+
+    free(dataset->class_ids);
+    free(dataset->student_ids);
+    free(dataset->assignment_ids);
+    free(dataset->school_days);
+    memset(dataset, 0, sizeof(SynthDataset));
+}
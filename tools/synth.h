@@ -0,0 +1,41 @@
+#ifndef SYNTH_H
+#define SYNTH_H
+
+#include "database.h"
+#include "db_batch.h"
+
+// Shape of the generated dataset
+typedef struct {
+    int classes;
+    int students_per_class;
+    int school_days;
+    int assignments_per_class;
+    unsigned long long seed;
+    bool sparse_attendance;  // classes record only absences and late arrivals
+} SynthConfig;
+
+// Ids of everything that was generated, for picking benchmark targets
+typedef struct {
+    int user_id;
+    int *class_ids;          // [classes]
+    int *student_ids;        // [classes * students_per_class]
+    int *assignment_ids;     // [classes * assignments_per_class]
+    time_t *school_days;     // [school_days], noon local time
+    long long attendance_rows;   // rows actually stored
+    long long submission_rows;
+} SynthDataset;
+
+#define SYNTH_EMAIL "bench@example.com"
+#define SYNTH_PASSWORD "bench-password-1"
+
+// Defaults used by `make bench`
+void synth_default_config(SynthConfig *config);
+
+// Populate the (already initialised) g_db with deterministic data
+bool synth_generate(const SynthConfig *config, SynthDataset *dataset);
+void synth_free(SynthDataset *dataset);
+
+// Deterministic PRNG shared by the generator and the benchmark driver
+unsigned long long synth_next(unsigned long long *state);
+
+#endif // SYNTH_H